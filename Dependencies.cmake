@@ -1,23 +1,48 @@
-include(FetchContent)
-
-# GoogleTest - Modern FetchContent approach
-find_package(GTest 1.12.1 QUIET)
-if (NOT GTest_FOUND)
-    # For Windows: Prevent overriding the parent project's compiler/linker settings
-    set(gtest_force_shared_crt ON CACHE BOOL "" FORCE)
-
-    FetchContent_Declare(
-        googletest
-        DOWNLOAD_EXTRACT_TIMESTAMP OFF
-        GIT_REPOSITORY https://github.com/google/googletest.git
-        GIT_TAG release-1.12.1
-    )
-
-    # This does everything: download, extract, and add_subdirectory
-    FetchContent_MakeAvailable(googletest)
-endif()
-
-# Organize in IDE (Visual Studio/CLion)
-set_target_properties(gtest gtest_main gmock gmock_main
-    PROPERTIES FOLDER "Dependencies/GoogleTest"
-)
\ No newline at end of file
+include(FetchContent)
+
+# GoogleTest - Modern FetchContent approach
+find_package(GTest 1.12.1 QUIET)
+if (NOT GTest_FOUND)
+    # For Windows: Prevent overriding the parent project's compiler/linker settings
+    set(gtest_force_shared_crt ON CACHE BOOL "" FORCE)
+
+    FetchContent_Declare(
+        googletest
+        DOWNLOAD_EXTRACT_TIMESTAMP OFF
+        GIT_REPOSITORY https://github.com/google/googletest.git
+        GIT_TAG release-1.12.1
+    )
+
+    # This does everything: download, extract, and add_subdirectory
+    FetchContent_MakeAvailable(googletest)
+
+    # Organize in IDE (Visual Studio/CLion)
+    set_target_properties(gtest gtest_main gmock gmock_main
+        PROPERTIES FOLDER "Dependencies/GoogleTest"
+    )
+else()
+    # An installed GTest only exports namespaced targets, keep the short names working
+    add_library(gtest ALIAS GTest::gtest)
+    add_library(gtest_main ALIAS GTest::gtest_main)
+endif()
+
+# Google Benchmark - same approach as GoogleTest
+find_package(benchmark QUIET)
+if (NOT benchmark_FOUND)
+    set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+    FetchContent_Declare(
+        googlebenchmark
+        DOWNLOAD_EXTRACT_TIMESTAMP OFF
+        GIT_REPOSITORY https://github.com/google/benchmark.git
+        GIT_TAG v1.8.3
+    )
+
+    FetchContent_MakeAvailable(googlebenchmark)
+
+    # Organize in IDE (Visual Studio/CLion)
+    set_target_properties(benchmark benchmark_main
+        PROPERTIES FOLDER "Dependencies/GoogleBenchmark"
+    )
+endif()
@@ -0,0 +1,652 @@
+#include "batch_kernels.h"
+#include <limits>
+#include <type_traits>
+#if FIXED_POINT_HAS_SIMD
+#include <immintrin.h>
+#endif
+
+namespace fixed_point_detail {
+
+namespace {
+
+// The intermediate of FixedPoint<F, T>::Wide
+template<typename T> struct Wider;
+template<> struct Wider<int16_t> {using type = int32_t;};
+template<> struct Wider<int32_t> {using type = int64_t;};
+
+template<typename T>
+T narrow_raw(typename Wider<T>::type v, bool saturate) {
+    if (saturate) {
+        if (v > std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+        if (v < std::numeric_limits<T>::min()) return std::numeric_limits<T>::min();
+    }
+    return static_cast<T>(v);
+}
+
+// Half a step of the result, added to the product under Rounding::Nearest
+int64_t mul_bias(MulFormat format) {
+    return format.round && format.fraction_bits > 0 ? int64_t(1) << (format.fraction_bits - 1) : 0;
+}
+
+// One element of each operation, the same arithmetic as the FixedPoint operators
+template<typename T>
+T add_raw(T a, T b, bool saturate) {
+    using W = typename Wider<T>::type;
+    return narrow_raw<T>(static_cast<W>(a) + b, saturate);
+}
+
+template<typename T>
+T mul_raw(T a, T b, MulFormat format) {
+    using W = typename Wider<T>::type;
+    W product = static_cast<W>(a) * b + static_cast<W>(mul_bias(format));
+    return narrow_raw<T>(product >> format.fraction_bits, format.saturate);
+}
+
+// Elements [i, n) of a multiply loop, b is a single factor if Broadcast and c is
+// added to the products if Add
+template<bool Broadcast, bool Add, typename T>
+void mul_tail(const T* a, const T* b, const std::common_type_t<T>* c, T* out, size_t i, size_t n, MulFormat format) {
+    for (; i < n; ++i) {
+        T product = mul_raw(a[i], Broadcast ? b[0] : b[i], format);
+        out[i] = Add ? add_raw(product, c[i], format.saturate) : product;
+    }
+}
+
+template<typename T>
+int64_t dot_tail(const T* a, const T* b, size_t i, size_t n, uint64_t sum) {
+    // Unsigned, so a sum out of range wraps instead of being undefined
+    for (; i < n; ++i) sum += static_cast<uint64_t>(static_cast<int64_t>(a[i]) * b[i]);
+    return static_cast<int64_t>(sum);
+}
+
+// One element through all the steps
+void cordic_raw(int64_t& x, int64_t& y, int64_t& z, CordicSteps steps) {
+    for (int k = 0; k < steps.count; ++k) {
+        const int shift = steps.shifts[k];
+        // 0 to turn counterclockwise, -1 clockwise
+        const int64_t sign = steps.vectoring ? ~(y >> 63) : z >> 63;
+        const int64_t dx = y >> shift, dy = x >> shift;
+        const int64_t x_sign = steps.hyperbolic ? ~sign : sign;
+        x -= (dx ^ x_sign) - x_sign;
+        y += (dy ^ sign) - sign;
+        z -= (steps.angles[k] ^ sign) - sign;
+    }
+}
+
+#if FIXED_POINT_HAS_SIMD
+// The mulhrs instructions compute (a * b + 2^14) >> 15, which is the Q15 product
+// with Rounding::Nearest. Its one overflow, -1 * -1, wraps to -1 like Overflow::Wrap.
+bool is_mulhrs(MulFormat format) {
+    return format.fraction_bits == 15 && format.round;
+}
+
+// 128-bit lanes. 32-bit products are formed in two halves by mul_epi32, which
+// multiplies the even elements. Logical 64-bit shifts leave the low 32 bits of the
+// arithmetic shift, the odd products are shifted left by 32 - F instead of right by
+// F to land in the high half. The high half of each product decides saturation:
+// the result fits if the bits shifted into the high half are copies of its sign.
+template<bool Saturate>
+FIXED_POINT_TARGET_SSE41 inline __m128i add32_sse41(__m128i a, __m128i b) {
+    __m128i sum = _mm_add_epi32(a, b);
+    if (!Saturate) return sum;
+    // Signs of the operands agree and the sign of the sum differs
+    __m128i overflow = _mm_srai_epi32(_mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, sum)), 31);
+    __m128i limit = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(INT32_MAX));
+    return _mm_blendv_epi8(sum, limit, overflow);
+}
+
+template<bool Saturate>
+FIXED_POINT_TARGET_SSE41 inline __m128i mul32_sse41(__m128i a, __m128i b, __m128i bias, __m128i shift,
+                                                    __m128i up) {
+    __m128i even = _mm_add_epi64(_mm_mul_epi32(a, b), bias);
+    __m128i odd = _mm_add_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), bias);
+    __m128i result = _mm_blend_epi16(_mm_srl_epi64(even, shift), _mm_sll_epi64(odd, up), 0xCC);
+    if (!Saturate) return result;
+    __m128i high = _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+    __m128i fits = _mm_cmpeq_epi32(_mm_sra_epi32(high, shift), _mm_srai_epi32(result, 31));
+    __m128i limit = _mm_xor_si128(_mm_srai_epi32(high, 31), _mm_set1_epi32(INT32_MAX));
+    return _mm_blendv_epi8(limit, result, fits);
+}
+
+template<bool Saturate>
+FIXED_POINT_TARGET_SSE41 inline __m128i add16_sse41(__m128i a, __m128i b) {
+    return Saturate ? _mm_adds_epi16(a, b) : _mm_add_epi16(a, b);
+}
+
+// 16-bit products in 32 bits, shifted, then packed with signed saturation or
+// truncated to the low 16 bits
+template<bool Saturate, bool Mulhrs>
+FIXED_POINT_TARGET_SSE41 inline __m128i mul16_sse41(__m128i a, __m128i b, __m128i bias, __m128i shift) {
+    if (Mulhrs) {
+        __m128i result = _mm_mulhrs_epi16(a, b);
+        if (!Saturate) return result;
+        // -1 * -1 is the only product giving -1, saturate it to the largest value
+        return _mm_xor_si128(result, _mm_cmpeq_epi16(result, _mm_set1_epi16(INT16_MIN)));
+    }
+    __m128i low = _mm_mullo_epi16(a, b);
+    __m128i high = _mm_mulhi_epi16(a, b);
+    __m128i first = _mm_sra_epi32(_mm_add_epi32(_mm_unpacklo_epi16(low, high), bias), shift);
+    __m128i second = _mm_sra_epi32(_mm_add_epi32(_mm_unpackhi_epi16(low, high), bias), shift);
+    if (Saturate) return _mm_packs_epi32(first, second);
+    const __m128i mask = _mm_set1_epi32(0xFFFF);
+    return _mm_packus_epi32(_mm_and_si128(first, mask), _mm_and_si128(second, mask));
+}
+
+template<bool Saturate, bool Broadcast, bool Add>
+FIXED_POINT_TARGET_SSE41 void mul32_loop_sse41(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out,
+                                               size_t n, MulFormat format) {
+    const __m128i bias = _mm_set1_epi64x(mul_bias(format));
+    const __m128i shift = _mm_cvtsi32_si128(format.fraction_bits);
+    const __m128i up = _mm_cvtsi32_si128(32 - format.fraction_bits);
+    const __m128i factor = Broadcast ? _mm_set1_epi32(b[0]) : __m128i();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = Broadcast ? factor : _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i result = mul32_sse41<Saturate>(va, vb, bias, shift, up);
+        if (Add) result = add32_sse41<Saturate>(result, _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+    }
+    mul_tail<Broadcast, Add>(a, b, c, out, i, n, format);
+}
+
+template<bool Saturate, bool Mulhrs, bool Broadcast, bool Add>
+FIXED_POINT_TARGET_SSE41 void mul16_loop_sse41(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out,
+                                               size_t n, MulFormat format) {
+    const __m128i bias = _mm_set1_epi32(static_cast<int32_t>(mul_bias(format)));
+    const __m128i shift = _mm_cvtsi32_si128(format.fraction_bits);
+    const __m128i factor = Broadcast ? _mm_set1_epi16(b[0]) : __m128i();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = Broadcast ? factor : _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i result = mul16_sse41<Saturate, Mulhrs>(va, vb, bias, shift);
+        if (Add) result = add16_sse41<Saturate>(result, _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+    }
+    mul_tail<Broadcast, Add>(a, b, c, out, i, n, format);
+}
+
+template<bool Broadcast, bool Add>
+void mul32_sse41(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format) {
+    if (format.saturate) {
+        mul32_loop_sse41<true, Broadcast, Add>(a, b, c, out, n, format);
+    } else {
+        mul32_loop_sse41<false, Broadcast, Add>(a, b, c, out, n, format);
+    }
+}
+
+template<bool Broadcast, bool Add>
+void mul16_sse41(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format) {
+    if (is_mulhrs(format)) {
+        if (format.saturate) {
+            mul16_loop_sse41<true, true, Broadcast, Add>(a, b, c, out, n, format);
+        } else {
+            mul16_loop_sse41<false, true, Broadcast, Add>(a, b, c, out, n, format);
+        }
+    } else if (format.saturate) {
+        mul16_loop_sse41<true, false, Broadcast, Add>(a, b, c, out, n, format);
+    } else {
+        mul16_loop_sse41<false, false, Broadcast, Add>(a, b, c, out, n, format);
+    }
+}
+
+template<bool Saturate, typename T>
+FIXED_POINT_TARGET_SSE41 void add_loop_sse41(const T* a, const T* b, T* out, size_t n) {
+    constexpr size_t lanes = 16 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i sum = sizeof(T) == 4 ? add32_sse41<Saturate>(va, vb) : add16_sse41<Saturate>(va, vb);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), sum);
+    }
+    for (; i < n; ++i) out[i] = add_raw(a[i], b[i], Saturate);
+}
+
+// AVX2, the same in 256-bit registers. The 16-bit unpack and pack work within each
+// 128-bit half, so the pack puts the elements back in order.
+template<bool Saturate>
+FIXED_POINT_TARGET_AVX2 inline __m256i add32_avx2(__m256i a, __m256i b) {
+    __m256i sum = _mm256_add_epi32(a, b);
+    if (!Saturate) return sum;
+    __m256i overflow = _mm256_srai_epi32(_mm256_andnot_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, sum)), 31);
+    __m256i limit = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+    return _mm256_blendv_epi8(sum, limit, overflow);
+}
+
+template<bool Saturate>
+FIXED_POINT_TARGET_AVX2 inline __m256i mul32_avx2(__m256i a, __m256i b, __m256i bias, __m128i shift, __m128i up) {
+    __m256i even = _mm256_add_epi64(_mm256_mul_epi32(a, b), bias);
+    __m256i odd = _mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), bias);
+    __m256i result = _mm256_blend_epi32(_mm256_srl_epi64(even, shift), _mm256_sll_epi64(odd, up), 0xAA);
+    if (!Saturate) return result;
+    __m256i high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    __m256i fits = _mm256_cmpeq_epi32(_mm256_sra_epi32(high, shift), _mm256_srai_epi32(result, 31));
+    __m256i limit = _mm256_xor_si256(_mm256_srai_epi32(high, 31), _mm256_set1_epi32(INT32_MAX));
+    return _mm256_blendv_epi8(limit, result, fits);
+}
+
+template<bool Saturate>
+FIXED_POINT_TARGET_AVX2 inline __m256i add16_avx2(__m256i a, __m256i b) {
+    return Saturate ? _mm256_adds_epi16(a, b) : _mm256_add_epi16(a, b);
+}
+
+template<bool Saturate, bool Mulhrs>
+FIXED_POINT_TARGET_AVX2 inline __m256i mul16_avx2(__m256i a, __m256i b, __m256i bias, __m128i shift) {
+    if (Mulhrs) {
+        __m256i result = _mm256_mulhrs_epi16(a, b);
+        if (!Saturate) return result;
+        return _mm256_xor_si256(result, _mm256_cmpeq_epi16(result, _mm256_set1_epi16(INT16_MIN)));
+    }
+    __m256i low = _mm256_mullo_epi16(a, b);
+    __m256i high = _mm256_mulhi_epi16(a, b);
+    __m256i first = _mm256_sra_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(low, high), bias), shift);
+    __m256i second = _mm256_sra_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(low, high), bias), shift);
+    if (Saturate) return _mm256_packs_epi32(first, second);
+    const __m256i mask = _mm256_set1_epi32(0xFFFF);
+    return _mm256_packus_epi32(_mm256_and_si256(first, mask), _mm256_and_si256(second, mask));
+}
+
+template<bool Saturate, bool Broadcast, bool Add>
+FIXED_POINT_TARGET_AVX2 void mul32_loop_avx2(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out,
+                                             size_t n, MulFormat format) {
+    const __m256i bias = _mm256_set1_epi64x(mul_bias(format));
+    const __m128i shift = _mm_cvtsi32_si128(format.fraction_bits);
+    const __m128i up = _mm_cvtsi32_si128(32 - format.fraction_bits);
+    const __m256i factor = Broadcast ? _mm256_set1_epi32(b[0]) : __m256i();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = Broadcast ? factor : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i result = mul32_avx2<Saturate>(va, vb, bias, shift, up);
+        if (Add) result = add32_avx2<Saturate>(result, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+    }
+    mul_tail<Broadcast, Add>(a, b, c, out, i, n, format);
+}
+
+template<bool Saturate, bool Mulhrs, bool Broadcast, bool Add>
+FIXED_POINT_TARGET_AVX2 void mul16_loop_avx2(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out,
+                                             size_t n, MulFormat format) {
+    const __m256i bias = _mm256_set1_epi32(static_cast<int32_t>(mul_bias(format)));
+    const __m128i shift = _mm_cvtsi32_si128(format.fraction_bits);
+    const __m256i factor = Broadcast ? _mm256_set1_epi16(b[0]) : __m256i();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = Broadcast ? factor : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i result = mul16_avx2<Saturate, Mulhrs>(va, vb, bias, shift);
+        if (Add) result = add16_avx2<Saturate>(result, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+    }
+    mul_tail<Broadcast, Add>(a, b, c, out, i, n, format);
+}
+
+template<bool Broadcast, bool Add>
+void mul32_avx2(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format) {
+    if (format.saturate) {
+        mul32_loop_avx2<true, Broadcast, Add>(a, b, c, out, n, format);
+    } else {
+        mul32_loop_avx2<false, Broadcast, Add>(a, b, c, out, n, format);
+    }
+}
+
+template<bool Broadcast, bool Add>
+void mul16_avx2(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format) {
+    if (is_mulhrs(format)) {
+        if (format.saturate) {
+            mul16_loop_avx2<true, true, Broadcast, Add>(a, b, c, out, n, format);
+        } else {
+            mul16_loop_avx2<false, true, Broadcast, Add>(a, b, c, out, n, format);
+        }
+    } else if (format.saturate) {
+        mul16_loop_avx2<true, false, Broadcast, Add>(a, b, c, out, n, format);
+    } else {
+        mul16_loop_avx2<false, false, Broadcast, Add>(a, b, c, out, n, format);
+    }
+}
+
+template<bool Saturate, typename T>
+FIXED_POINT_TARGET_AVX2 void add_loop_avx2(const T* a, const T* b, T* out, size_t n) {
+    constexpr size_t lanes = 32 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i sum = sizeof(T) == 4 ? add32_avx2<Saturate>(va, vb) : add16_avx2<Saturate>(va, vb);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), sum);
+    }
+    for (; i < n; ++i) out[i] = add_raw(a[i], b[i], Saturate);
+}
+
+// v, or -v where sign is -1
+FIXED_POINT_TARGET_AVX2 inline __m256i flip_avx2(__m256i v, __m256i sign) {
+    return _mm256_sub_epi64(_mm256_xor_si256(v, sign), sign);
+}
+
+// One step on four elements. AVX2 has no arithmetic 64-bit shift: y is shifted
+// with its sign flipped away and back, and x is never negative. Two sets of four
+// are interleaved, each step is a chain of dependent instructions.
+template<bool Hyperbolic, bool Vectoring>
+FIXED_POINT_TARGET_AVX2 inline void cordic_step_avx2(__m256i& x, __m256i& y, __m256i& z, __m128i shift,
+                                                     __m256i angle) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i y_negative = _mm256_cmpgt_epi64(zero, y);
+    const __m256i sign = Vectoring ? _mm256_xor_si256(y_negative, _mm256_cmpeq_epi64(zero, zero))
+                                   : _mm256_cmpgt_epi64(zero, z);
+    const __m256i dx = _mm256_xor_si256(_mm256_srl_epi64(_mm256_xor_si256(y, y_negative), shift), y_negative);
+    const __m256i dy = _mm256_srl_epi64(x, shift);
+    x = Hyperbolic ? _mm256_add_epi64(x, flip_avx2(dx, sign)) : _mm256_sub_epi64(x, flip_avx2(dx, sign));
+    y = _mm256_add_epi64(y, flip_avx2(dy, sign));
+    z = _mm256_sub_epi64(z, flip_avx2(angle, sign));
+}
+
+template<bool Hyperbolic, bool Vectoring>
+FIXED_POINT_TARGET_AVX2 void cordic_loop_avx2(int64_t* x, int64_t* y, int64_t* z, size_t n, CordicSteps steps) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+        __m256i z0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(z + i));
+        __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i + 4));
+        __m256i y1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i + 4));
+        __m256i z1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(z + i + 4));
+        for (int k = 0; k < steps.count; ++k) {
+            const __m128i shift = _mm_cvtsi32_si128(steps.shifts[k]);
+            const __m256i angle = _mm256_set1_epi64x(steps.angles[k]);
+            cordic_step_avx2<Hyperbolic, Vectoring>(x0, y0, z0, shift, angle);
+            cordic_step_avx2<Hyperbolic, Vectoring>(x1, y1, z1, shift, angle);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + i), x0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y + i), y0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(z + i), z0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + i + 4), x1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y + i + 4), y1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(z + i + 4), z1);
+    }
+    for (; i < n; ++i) cordic_raw(x[i], y[i], z[i], steps);
+}
+#endif
+
+} // namespace
+
+void add_scalar(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate) {
+    for (size_t i = 0; i < n; ++i) out[i] = add_raw(a[i], b[i], saturate);
+}
+
+void add_scalar(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate) {
+    for (size_t i = 0; i < n; ++i) out[i] = add_raw(a[i], b[i], saturate);
+}
+
+void mul_scalar(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format) {
+    mul_tail<false, false>(a, b, nullptr, out, 0, n, format);
+}
+
+void mul_scalar(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format) {
+    mul_tail<false, false>(a, b, nullptr, out, 0, n, format);
+}
+
+void scale_scalar(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format) {
+    mul_tail<true, false>(a, &k, nullptr, out, 0, n, format);
+}
+
+void scale_scalar(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format) {
+    mul_tail<true, false>(a, &k, nullptr, out, 0, n, format);
+}
+
+void mul_add_scalar(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format) {
+    mul_tail<false, true>(a, b, c, out, 0, n, format);
+}
+
+void mul_add_scalar(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format) {
+    mul_tail<false, true>(a, b, c, out, 0, n, format);
+}
+
+int64_t dot_scalar(const int32_t* a, const int32_t* b, size_t n) {
+    return dot_tail(a, b, 0, n, 0);
+}
+
+int64_t dot_scalar(const int16_t* a, const int16_t* b, size_t n) {
+    return dot_tail(a, b, 0, n, 0);
+}
+
+void cordic_scalar(int64_t* x, int64_t* y, int64_t* z, size_t n, CordicSteps steps) {
+    for (size_t i = 0; i < n; ++i) cordic_raw(x[i], y[i], z[i], steps);
+}
+
+#if FIXED_POINT_HAS_SIMD
+void add_sse41(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate) {
+    saturate ? add_loop_sse41<true>(a, b, out, n) : add_loop_sse41<false>(a, b, out, n);
+}
+
+void add_sse41(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate) {
+    saturate ? add_loop_sse41<true>(a, b, out, n) : add_loop_sse41<false>(a, b, out, n);
+}
+
+void mul_sse41(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format) {
+    mul32_sse41<false, false>(a, b, nullptr, out, n, format);
+}
+
+void mul_sse41(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format) {
+    mul16_sse41<false, false>(a, b, nullptr, out, n, format);
+}
+
+void scale_sse41(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format) {
+    mul32_sse41<true, false>(a, &k, nullptr, out, n, format);
+}
+
+void scale_sse41(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format) {
+    mul16_sse41<true, false>(a, &k, nullptr, out, n, format);
+}
+
+void mul_add_sse41(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format) {
+    mul32_sse41<false, true>(a, b, c, out, n, format);
+}
+
+void mul_add_sse41(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format) {
+    mul16_sse41<false, true>(a, b, c, out, n, format);
+}
+
+FIXED_POINT_TARGET_SSE41 int64_t dot_sse41(const int32_t* a, const int32_t* b, size_t n) {
+    __m128i even = _mm_setzero_si128();
+    __m128i odd = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        even = _mm_add_epi64(even, _mm_mul_epi32(va, vb));
+        odd = _mm_add_epi64(odd, _mm_mul_epi32(_mm_srli_epi64(va, 32), _mm_srli_epi64(vb, 32)));
+    }
+    __m128i sum = _mm_add_epi64(even, odd);
+    uint64_t total = static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) + static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+    return dot_tail(a, b, i, n, total);
+}
+
+// madd_epi16 adds pairs of products in 32 bits. Only -1 * -1 + -1 * -1 = 2^31 does
+// not fit and wraps to -2^31, a sum no pair can reach, so one less than every pair
+// sum fits in 32 bits. Those are widened and added up, then the pair count added back.
+FIXED_POINT_TARGET_SSE41 int64_t dot_sse41(const int16_t* a, const int16_t* b, size_t n) {
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i sum = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i pairs = _mm_sub_epi32(_mm_madd_epi16(va, vb), one);
+        sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(pairs));
+        sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(_mm_srli_si128(pairs, 8)));
+    }
+    uint64_t total = static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) + static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+    return dot_tail(a, b, i, n, total + i / 2);
+}
+
+void add_avx2(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate) {
+    saturate ? add_loop_avx2<true>(a, b, out, n) : add_loop_avx2<false>(a, b, out, n);
+}
+
+void add_avx2(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate) {
+    saturate ? add_loop_avx2<true>(a, b, out, n) : add_loop_avx2<false>(a, b, out, n);
+}
+
+void mul_avx2(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format) {
+    mul32_avx2<false, false>(a, b, nullptr, out, n, format);
+}
+
+void mul_avx2(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format) {
+    mul16_avx2<false, false>(a, b, nullptr, out, n, format);
+}
+
+void scale_avx2(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format) {
+    mul32_avx2<true, false>(a, &k, nullptr, out, n, format);
+}
+
+void scale_avx2(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format) {
+    mul16_avx2<true, false>(a, &k, nullptr, out, n, format);
+}
+
+void mul_add_avx2(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format) {
+    mul32_avx2<false, true>(a, b, c, out, n, format);
+}
+
+void mul_add_avx2(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format) {
+    mul16_avx2<false, true>(a, b, c, out, n, format);
+}
+
+FIXED_POINT_TARGET_AVX2 int64_t dot_avx2(const int32_t* a, const int32_t* b, size_t n) {
+    __m256i even = _mm256_setzero_si256();
+    __m256i odd = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        even = _mm256_add_epi64(even, _mm256_mul_epi32(va, vb));
+        odd = _mm256_add_epi64(odd, _mm256_mul_epi32(_mm256_srli_epi64(va, 32), _mm256_srli_epi64(vb, 32)));
+    }
+    __m256i sum4 = _mm256_add_epi64(even, odd);
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(sum4), _mm256_extracti128_si256(sum4, 1));
+    uint64_t total = static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) + static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+    return dot_tail(a, b, i, n, total);
+}
+
+FIXED_POINT_TARGET_AVX2 int64_t dot_avx2(const int16_t* a, const int16_t* b, size_t n) {
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i first = _mm256_setzero_si256();
+    __m256i second = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i pairs = _mm256_sub_epi32(_mm256_madd_epi16(va, vb), one);
+        first = _mm256_add_epi64(first, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+        second = _mm256_add_epi64(second, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+    }
+    __m256i sum4 = _mm256_add_epi64(first, second);
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(sum4), _mm256_extracti128_si256(sum4, 1));
+    uint64_t total = static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) + static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+    return dot_tail(a, b, i, n, total + i / 2);
+}
+
+void cordic_avx2(int64_t* x, int64_t* y, int64_t* z, size_t n, CordicSteps steps) {
+    if (steps.hyperbolic) {
+        if (steps.vectoring) {
+            cordic_loop_avx2<true, true>(x, y, z, n, steps);
+        } else {
+            cordic_loop_avx2<true, false>(x, y, z, n, steps);
+        }
+    } else if (steps.vectoring) {
+        cordic_loop_avx2<false, true>(x, y, z, n, steps);
+    } else {
+        cordic_loop_avx2<false, false>(x, y, z, n, steps);
+    }
+}
+#endif
+
+void add(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return add_avx2(a, b, out, n, saturate);
+    if (cpu_has_sse41()) return add_sse41(a, b, out, n, saturate);
+#endif
+    add_scalar(a, b, out, n, saturate);
+}
+
+void add(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return add_avx2(a, b, out, n, saturate);
+    if (cpu_has_sse41()) return add_sse41(a, b, out, n, saturate);
+#endif
+    add_scalar(a, b, out, n, saturate);
+}
+
+void mul(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return mul_avx2(a, b, out, n, format);
+    if (cpu_has_sse41()) return mul_sse41(a, b, out, n, format);
+#endif
+    mul_scalar(a, b, out, n, format);
+}
+
+void mul(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return mul_avx2(a, b, out, n, format);
+    if (cpu_has_sse41()) return mul_sse41(a, b, out, n, format);
+#endif
+    mul_scalar(a, b, out, n, format);
+}
+
+void scale(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return scale_avx2(a, k, out, n, format);
+    if (cpu_has_sse41()) return scale_sse41(a, k, out, n, format);
+#endif
+    scale_scalar(a, k, out, n, format);
+}
+
+void scale(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return scale_avx2(a, k, out, n, format);
+    if (cpu_has_sse41()) return scale_sse41(a, k, out, n, format);
+#endif
+    scale_scalar(a, k, out, n, format);
+}
+
+void mul_add(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return mul_add_avx2(a, b, c, out, n, format);
+    if (cpu_has_sse41()) return mul_add_sse41(a, b, c, out, n, format);
+#endif
+    mul_add_scalar(a, b, c, out, n, format);
+}
+
+void mul_add(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return mul_add_avx2(a, b, c, out, n, format);
+    if (cpu_has_sse41()) return mul_add_sse41(a, b, c, out, n, format);
+#endif
+    mul_add_scalar(a, b, c, out, n, format);
+}
+
+int64_t dot(const int32_t* a, const int32_t* b, size_t n) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return dot_avx2(a, b, n);
+    if (cpu_has_sse41()) return dot_sse41(a, b, n);
+#endif
+    return dot_scalar(a, b, n);
+}
+
+int64_t dot(const int16_t* a, const int16_t* b, size_t n) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return dot_avx2(a, b, n);
+    if (cpu_has_sse41()) return dot_sse41(a, b, n);
+#endif
+    return dot_scalar(a, b, n);
+}
+
+void cordic(int64_t* x, int64_t* y, int64_t* z, size_t n, CordicSteps steps) {
+#if FIXED_POINT_HAS_SIMD
+    if (cpu_has_avx2()) return cordic_avx2(x, y, z, n, steps);
+#endif
+    cordic_scalar(x, y, z, n, steps);
+}
+
+} // namespace fixed_point_detail
@@ -0,0 +1,111 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Vectorized loops behind the batch functions of fixed_point_batch.h, for 16 and
+// 32-bit signed storage, and behind the array functions of fixed_point_math.h.
+// SSE4.1 and AVX2 kernels are compiled with a target attribute and picked at
+// runtime (GCC/Clang on x86-64 only, elsewhere the scalar loops are used). The
+// per-ISA kernels are exposed so tests can compare them.
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FIXED_POINT_HAS_SIMD 1
+#define FIXED_POINT_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define FIXED_POINT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FIXED_POINT_HAS_SIMD 0
+#endif
+
+namespace fixed_point_detail {
+
+// What operator* of the format does with the full product
+struct MulFormat {
+    int fraction_bits;
+    bool round;    // Rounding::Nearest, add half a step before the shift
+    bool saturate; // Overflow::Saturate, otherwise the result wraps
+};
+
+// A run of CORDIC iterations, see detail::cordic() in fixed_point_math.h
+struct CordicSteps {
+    const int* shifts;
+    const int64_t* angles;
+    int count;
+    bool hyperbolic;
+    bool vectoring;
+};
+
+inline bool cpu_has_sse41() {
+#if FIXED_POINT_HAS_SIMD
+    static const bool has_sse41 = __builtin_cpu_supports("sse4.1");
+    return has_sse41;
+#else
+    return false;
+#endif
+}
+
+inline bool cpu_has_avx2() {
+#if FIXED_POINT_HAS_SIMD
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+#else
+    return false;
+#endif
+}
+
+// Element by element on raw values, out may be the same array as an input.
+// scale() multiplies every element by k, mul_add() computes a * b + c with the
+// product rounded first, exactly like the two operators. dot() returns the sum of
+// the exact products, wrapping modulo 2^64.
+void add(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate);
+void add(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate);
+void mul(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format);
+void mul(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format);
+void scale(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format);
+void scale(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format);
+void mul_add(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format);
+void mul_add(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format);
+int64_t dot(const int32_t* a, const int32_t* b, size_t n);
+int64_t dot(const int16_t* a, const int16_t* b, size_t n);
+
+// The iterations on each (x[i], y[i], z[i]) in place, bit for bit the same as one
+// at a time. There is no SSE4.1 kernel: two 64-bit lanes without the signed 64-bit
+// compare of SSE4.2 gain nothing over scalar code.
+void cordic(int64_t* x, int64_t* y, int64_t* z, size_t n, CordicSteps steps);
+
+void add_scalar(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate);
+void add_scalar(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate);
+void mul_scalar(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format);
+void mul_scalar(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format);
+void scale_scalar(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format);
+void scale_scalar(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format);
+void mul_add_scalar(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format);
+void mul_add_scalar(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format);
+int64_t dot_scalar(const int32_t* a, const int32_t* b, size_t n);
+int64_t dot_scalar(const int16_t* a, const int16_t* b, size_t n);
+void cordic_scalar(int64_t* x, int64_t* y, int64_t* z, size_t n, CordicSteps steps);
+#if FIXED_POINT_HAS_SIMD
+void add_sse41(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate);
+void add_sse41(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate);
+void mul_sse41(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format);
+void mul_sse41(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format);
+void scale_sse41(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format);
+void scale_sse41(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format);
+void mul_add_sse41(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format);
+void mul_add_sse41(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format);
+int64_t dot_sse41(const int32_t* a, const int32_t* b, size_t n);
+int64_t dot_sse41(const int16_t* a, const int16_t* b, size_t n);
+
+void add_avx2(const int32_t* a, const int32_t* b, int32_t* out, size_t n, bool saturate);
+void add_avx2(const int16_t* a, const int16_t* b, int16_t* out, size_t n, bool saturate);
+void mul_avx2(const int32_t* a, const int32_t* b, int32_t* out, size_t n, MulFormat format);
+void mul_avx2(const int16_t* a, const int16_t* b, int16_t* out, size_t n, MulFormat format);
+void scale_avx2(const int32_t* a, int32_t k, int32_t* out, size_t n, MulFormat format);
+void scale_avx2(const int16_t* a, int16_t k, int16_t* out, size_t n, MulFormat format);
+void mul_add_avx2(const int32_t* a, const int32_t* b, const int32_t* c, int32_t* out, size_t n, MulFormat format);
+void mul_add_avx2(const int16_t* a, const int16_t* b, const int16_t* c, int16_t* out, size_t n, MulFormat format);
+int64_t dot_avx2(const int32_t* a, const int32_t* b, size_t n);
+int64_t dot_avx2(const int16_t* a, const int16_t* b, size_t n);
+void cordic_avx2(int64_t* x, int64_t* y, int64_t* z, size_t n, CordicSteps steps);
+#endif
+
+} // namespace fixed_point_detail
@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "filters.h"
+
+namespace {
+
+using Q15 = FixedPoint<15, int16_t, Overflow::Saturate, Rounding::Nearest>;
+using Q30 = FixedPoint<30, int32_t, Overflow::Saturate, Rounding::Nearest>;
+using Q2x29 = FixedPoint<29, int32_t>;
+using Q1x14 = FixedPoint<14, int16_t>;
+
+constexpr size_t block_size = 4096;
+
+template<typename T>
+std::vector<T> noise(size_t n) {
+    std::mt19937 rng(24);
+    std::uniform_real_distribution<float> sample(-0.5f, 0.5f);
+    std::vector<T> values;
+    for (size_t i = 0; i < n; ++i) values.push_back(T(sample(rng)));
+    return values;
+}
+
+// Cycles per sample at the nominal clock Google Benchmark measured, from the wall
+// time of the whole benchmark loop
+class CycleCounter {
+public:
+    CycleCounter() : m_start(std::chrono::steady_clock::now()) {}
+
+    void report(benchmark::State& state, size_t samples) const {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+        const double total = static_cast<double>(state.iterations()) * static_cast<double>(samples);
+        state.SetItemsProcessed(static_cast<int64_t>(total));
+        state.counters["cycles_per_sample"] = elapsed.count() * benchmark::CPUInfo::Get().cycles_per_second / total;
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// range(0) taps of a fixed-point FIR filter, by block
+template<typename T>
+void BM_Fir(benchmark::State& state) {
+    fixed_point_filters::FirFilter<T> fir(noise<T>(static_cast<size_t>(state.range(0))));
+    auto input = noise<T>(block_size);
+    std::vector<T> output(block_size);
+    const CycleCounter cycles;
+    for (auto _ : state) {
+        fir.process(input.data(), output.data(), block_size);
+        benchmark::DoNotOptimize(output.data());
+    }
+    cycles.report(state, block_size);
+}
+
+// The same filter in float, a direct form loop over a sliding window
+void BM_FirFloat(benchmark::State& state) {
+    const size_t taps = static_cast<size_t>(state.range(0));
+    auto coefficients = noise<float>(taps);
+    std::vector<float> line(taps - 1 + block_size);
+    auto input = noise<float>(block_size);
+    std::vector<float> output(block_size);
+    const CycleCounter cycles;
+    for (auto _ : state) {
+        std::copy(line.end() - static_cast<ptrdiff_t>(taps - 1), line.end(), line.begin());
+        std::copy(input.begin(), input.end(), line.begin() + static_cast<ptrdiff_t>(taps - 1));
+        for (size_t n = 0; n < block_size; ++n) {
+            float sum = 0.0f;
+            for (size_t k = 0; k < taps; ++k) sum += coefficients[k] * line[n + taps - 1 - k];
+            output[n] = sum;
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+    cycles.report(state, block_size);
+}
+
+// Cycles per input sample of a 4 times decimator
+void BM_FirDecimator(benchmark::State& state) {
+    fixed_point_filters::FirDecimator<Q15> decimator(noise<Q15>(static_cast<size_t>(state.range(0))), 4);
+    auto input = noise<Q15>(block_size);
+    std::vector<Q15> output(block_size);
+    const CycleCounter cycles;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decimator.process(input.data(), block_size, output.data()));
+    }
+    cycles.report(state, block_size);
+}
+
+// range(0) identical lowpass sections
+template<typename Sample, typename Coefficient>
+void BM_Biquad(benchmark::State& state) {
+    const fixed_point_filters::Biquad<Coefficient> lowpass = {Coefficient(0.0675f), Coefficient(0.135f),
+                                                              Coefficient(0.0675f), Coefficient(-1.143f),
+                                                              Coefficient(0.413f)};
+    fixed_point_filters::BiquadCascade<Sample, Coefficient> cascade(
+        std::vector<fixed_point_filters::Biquad<Coefficient>>(static_cast<size_t>(state.range(0)), lowpass));
+    auto input = noise<Sample>(block_size);
+    std::vector<Sample> output(block_size);
+    const CycleCounter cycles;
+    for (auto _ : state) {
+        cascade.process(input.data(), output.data(), block_size);
+        benchmark::DoNotOptimize(output.data());
+    }
+    cycles.report(state, block_size);
+}
+
+void BM_BiquadFloat(benchmark::State& state) {
+    const size_t sections = static_cast<size_t>(state.range(0));
+    std::vector<float> state_values(4 * sections);
+    auto input = noise<float>(block_size);
+    std::vector<float> output(block_size);
+    const CycleCounter cycles;
+    for (auto _ : state) {
+        const float* source = input.data();
+        for (size_t s = 0; s < sections; ++s) {
+            float x1 = state_values[4 * s], x2 = state_values[4 * s + 1];
+            float y1 = state_values[4 * s + 2], y2 = state_values[4 * s + 3];
+            for (size_t n = 0; n < block_size; ++n) {
+                float x = source[n];
+                float y = 0.0675f * x + 0.135f * x1 + 0.0675f * x2 + 1.143f * y1 - 0.413f * y2;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                output[n] = y;
+            }
+            state_values[4 * s] = x1;
+            state_values[4 * s + 1] = x2;
+            state_values[4 * s + 2] = y1;
+            state_values[4 * s + 3] = y2;
+            source = output.data();
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+    cycles.report(state, block_size);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Fir, Q15)->ArgName("taps")->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Fir, Q30)->ArgName("taps")->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_FirFloat)->ArgName("taps")->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_FirDecimator)->ArgName("taps")->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Biquad, Q15, Q1x14)->ArgName("sections")->Arg(1)->Arg(4);
+BENCHMARK_TEMPLATE(BM_Biquad, Q30, Q2x29)->ArgName("sections")->Arg(1)->Arg(4);
+BENCHMARK(BM_BiquadFloat)->ArgName("sections")->Arg(1)->Arg(4);
@@ -0,0 +1,167 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "fixed_point_batch.h"
+
+namespace {
+
+using Q16 = FixedPoint<16>;
+using Q15 = FixedPoint<15, int16_t, Overflow::Wrap, Rounding::Nearest>;
+using SatQ16 = FixedPoint<16, int32_t, Overflow::Saturate>;
+
+// One audio frame of samples in [-1, 1)
+template<typename T>
+std::vector<T> frame(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> sample(-1.0f, 0.99f);
+    std::vector<T> values;
+    for (size_t i = 0; i < n; ++i) values.push_back(T(sample(rng)));
+    return values;
+}
+
+template<typename T>
+void BM_MulOperators(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<T>(n, 1);
+    auto b = frame<T>(n, 2);
+    std::vector<T> out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template<typename T>
+void BM_MulBatch(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<T>(n, 1);
+    auto b = frame<T>(n, 2);
+    std::vector<T> out(n);
+    for (auto _ : state) {
+        fixed_point_batch::mul(a.data(), b.data(), out.data(), n);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template<typename T>
+void BM_MulAddOperators(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<T>(n, 1);
+    auto b = frame<T>(n, 2);
+    auto c = frame<T>(n, 3);
+    std::vector<T> out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i] + c[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template<typename T>
+void BM_MulAddBatch(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<T>(n, 1);
+    auto b = frame<T>(n, 2);
+    auto c = frame<T>(n, 3);
+    std::vector<T> out(n);
+    for (auto _ : state) {
+        fixed_point_batch::mul_add(a.data(), b.data(), c.data(), out.data(), n);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// The float versions, which the compiler vectorizes on its own
+void BM_MulFloat(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<float>(n, 1);
+    auto b = frame<float>(n, 2);
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+void BM_MulAddFloat(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<float>(n, 1);
+    auto b = frame<float>(n, 2);
+    auto c = frame<float>(n, 3);
+    std::vector<float> out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i] + c[i];
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// Dot products: the operator loop rounds every product, the batch one only the sum
+template<typename T>
+void BM_DotOperators(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<T>(n, 1);
+    auto b = frame<T>(n, 2);
+    for (auto _ : state) {
+        T sum;
+        for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template<typename T>
+void BM_DotBatch(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<T>(n, 1);
+    auto b = frame<T>(n, 2);
+    for (auto _ : state) {
+        T sum = fixed_point_batch::dot(a.data(), b.data(), n);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// Without -ffast-math the float sum is not reordered, so it is not vectorized either
+void BM_DotFloat(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto a = frame<float>(n, 1);
+    auto b = frame<float>(n, 2);
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+constexpr int frame_size = 4096;
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_MulOperators, Q16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulBatch, Q16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulOperators, SatQ16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulBatch, SatQ16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulOperators, Q15)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulBatch, Q15)->Arg(frame_size);
+BENCHMARK(BM_MulFloat)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulAddOperators, Q16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulAddBatch, Q16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulAddOperators, Q15)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_MulAddBatch, Q15)->Arg(frame_size);
+BENCHMARK(BM_MulAddFloat)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_DotOperators, Q16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_DotBatch, Q16)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_DotOperators, Q15)->Arg(frame_size);
+BENCHMARK_TEMPLATE(BM_DotBatch, Q15)->Arg(frame_size);
+BENCHMARK(BM_DotFloat)->Arg(frame_size);
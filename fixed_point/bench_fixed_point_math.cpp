@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "fixed_point_math.h"
+
+namespace {
+
+using Q15 = FixedPoint<15, int16_t, Overflow::Saturate, Rounding::Nearest>;
+using Q16 = FixedPoint<16>;
+using Q30 = FixedPoint<30, int32_t, Overflow::Saturate, Rounding::Nearest>;
+
+constexpr size_t count = 4096;
+
+// Arguments inside each function's domain and where the result fits Q15 and Q30
+struct Sqrt {
+    template<typename T>
+    static void fixed(const T* in, T* out, size_t n) {fixed_point_math::sqrt(in, out, n);}
+    static float reference(float x) {return std::sqrt(x);}
+    static constexpr float low = 0.0f, high = 0.99f;
+};
+
+struct Sin {
+    template<typename T>
+    static void fixed(const T* in, T* out, size_t n) {fixed_point_math::sin(in, out, n);}
+    static float reference(float x) {return std::sin(x);}
+    static constexpr float low = -0.99f, high = 0.99f;
+};
+
+struct Exp {
+    template<typename T>
+    static void fixed(const T* in, T* out, size_t n) {fixed_point_math::exp(in, out, n);}
+    static float reference(float x) {return std::exp(x);}
+    static constexpr float low = -0.99f, high = -0.01f;
+};
+
+struct Log2 {
+    template<typename T>
+    static void fixed(const T* in, T* out, size_t n) {fixed_point_math::log2(in, out, n);}
+    static float reference(float x) {return std::log2(x);}
+    static constexpr float low = 0.51f, high = 0.99f;
+};
+
+template<typename T, typename Function>
+std::vector<T> arguments() {
+    std::mt19937 rng(25);
+    std::uniform_real_distribution<float> argument(Function::low, Function::high);
+    std::vector<T> values;
+    for (size_t i = 0; i < count; ++i) values.push_back(T(argument(rng)));
+    return values;
+}
+
+// The array version, in integer arithmetic only
+template<typename T, typename Function>
+void BM_Fixed(benchmark::State& state) {
+    const auto in = arguments<T, Function>();
+    std::vector<T> out(count);
+    for (auto _ : state) {
+        Function::fixed(in.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// What the library replaces: through float and the standard library, and back
+template<typename T, typename Function>
+void BM_ThroughFloat(benchmark::State& state) {
+    const auto in = arguments<T, Function>();
+    std::vector<T> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) out[i] = T(Function::reference(in[i].toFloat()));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Fixed, Q15, Sqrt);
+BENCHMARK_TEMPLATE(BM_Fixed, Q30, Sqrt);
+BENCHMARK_TEMPLATE(BM_ThroughFloat, Q30, Sqrt);
+BENCHMARK_TEMPLATE(BM_Fixed, Q15, Sin);
+BENCHMARK_TEMPLATE(BM_Fixed, Q16, Sin);
+BENCHMARK_TEMPLATE(BM_Fixed, Q30, Sin);
+BENCHMARK_TEMPLATE(BM_ThroughFloat, Q30, Sin);
+BENCHMARK_TEMPLATE(BM_Fixed, Q15, Exp);
+BENCHMARK_TEMPLATE(BM_Fixed, Q30, Exp);
+BENCHMARK_TEMPLATE(BM_ThroughFloat, Q30, Exp);
+BENCHMARK_TEMPLATE(BM_Fixed, Q15, Log2);
+BENCHMARK_TEMPLATE(BM_Fixed, Q30, Log2);
+BENCHMARK_TEMPLATE(BM_ThroughFloat, Q30, Log2);
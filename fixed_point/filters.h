@@ -0,0 +1,225 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "fixed_point.h"
+#include "fixed_point_batch.h"
+
+// Filters on FixedPoint samples. Sums of products are kept in 64 bits, exact within
+// the bound each filter gives, and only the output of each filter, or of each
+// biquad section, is rounded and brought back to the sample format under its
+// rounding and overflow policies.
+namespace fixed_point_filters {
+
+namespace detail {
+
+// The delay line of a FIR filter: a circular buffer unrolled into a longer array,
+// so the taps most recent samples always lie next to each other for the vectorized
+// dot product. Samples are appended after the history and the last taps - 1 are
+// moved back to the front when the array is full, once per chunk of samples.
+template<typename T>
+class DelayLine {
+public:
+    explicit DelayLine(size_t taps)
+        : m_samples(taps - 1 + std::max<size_t>(chunk, 4 * taps)), m_taps(taps), m_end(taps - 1) {}
+
+    void push(T sample) {
+        make_room();
+        m_samples[m_end++] = sample;
+    }
+    // Appends as many of the n samples as fit before the next move, at least one.
+    // Whole blocks are stored before any window is read, which keeps the loads of
+    // the dot product from waiting on the stores of the samples just written.
+    size_t append(const T* in, size_t n) {
+        make_room();
+        n = std::min(n, m_samples.size() - m_end);
+        std::copy(in, in + n, m_samples.begin() + static_cast<ptrdiff_t>(m_end));
+        m_end += n;
+        return n;
+    }
+    // The window of taps samples, oldest first, ending back samples before the newest
+    const T* window(size_t back = 0) const {return m_samples.data() + m_end - back - m_taps;}
+    void reset() {
+        std::fill(m_samples.begin(), m_samples.end(), T());
+        m_end = m_taps - 1;
+    }
+
+private:
+    static constexpr size_t chunk = 1024;
+
+    void make_room() {
+        if (m_end < m_samples.size()) return;
+        std::copy(m_samples.end() - static_cast<ptrdiff_t>(m_taps - 1), m_samples.end(), m_samples.begin());
+        m_end = m_taps - 1;
+    }
+
+    std::vector<T> m_samples;
+    size_t m_taps;
+    size_t m_end; // one past the newest sample
+};
+
+template<typename T>
+std::vector<T> reversed(std::vector<T> taps) {
+    if (taps.empty()) throw std::invalid_argument("a FIR filter needs at least one tap");
+    std::reverse(taps.begin(), taps.end());
+    return taps;
+}
+
+} // namespace detail
+
+// y[n] = sum of taps[k] * x[n - k], with the samples before the first one taken as 0.
+// The products are summed by fixed_point_batch::dot() in 64 bits, exact while the sum
+// of their magnitudes stays below 2^63 in raw units and wrapping modulo 2^64 beyond,
+// e.g. for Q1.30 samples below 1.0 and taps whose magnitudes sum below 8. 16-bit
+// formats would need over 2^33 taps to reach it.
+template<typename T>
+class FirFilter {
+public:
+    explicit FirFilter(std::vector<T> taps) : m_reversed(detail::reversed(std::move(taps))), m_delay(m_reversed.size()) {}
+
+    T process(T sample) {
+        m_delay.push(sample);
+        return output(0);
+    }
+    // out may be the same array as in
+    void process(const T* in, T* out, size_t n) {
+        while (n > 0) {
+            const size_t count = m_delay.append(in, n);
+            for (size_t i = 0; i < count; ++i) out[i] = output(count - 1 - i);
+            in += count;
+            out += count;
+            n -= count;
+        }
+    }
+
+    void reset() {m_delay.reset();}
+    size_t taps() const {return m_reversed.size();}
+
+private:
+    T output(size_t back) const {
+        return fixed_point_batch::dot(m_delay.window(back), m_reversed.data(), m_reversed.size());
+    }
+
+    std::vector<T> m_reversed; // taps[k] at m_reversed[size - 1 - k], to line up with the window
+    detail::DelayLine<T> m_delay;
+};
+
+// A FIR filter keeping every factor-th output, the ones after the factor-th, 2
+// factor-th, ... input. Only the kept outputs are computed, which is the taps / factor
+// multiplies per input of a polyphase decimator: its phases split the same sum of
+// products between the inputs that share a tap offset, here it stays one dot product
+// over the contiguous window. Its sums have the same bound as FirFilter: exact while
+// the magnitudes of the products sum below 2^63 in raw units, wrapping beyond.
+template<typename T>
+class FirDecimator {
+public:
+    FirDecimator(std::vector<T> taps, size_t factor)
+        : m_reversed(detail::reversed(std::move(taps))), m_delay(m_reversed.size()), m_factor(factor) {
+        if (factor == 0) throw std::invalid_argument("the decimation factor must be at least 1");
+    }
+
+    // Writes one output per factor inputs to out and returns the number written.
+    // Inputs left over count toward the next call.
+    size_t process(const T* in, size_t n, T* out) {
+        size_t written = 0;
+        while (n > 0) {
+            const size_t count = m_delay.append(in, n);
+            for (size_t i = m_factor - 1 - m_phase; i < count; i += m_factor) {
+                out[written++] = fixed_point_batch::dot(m_delay.window(count - 1 - i), m_reversed.data(),
+                                                        m_reversed.size());
+            }
+            m_phase = (m_phase + count) % m_factor;
+            in += count;
+            n -= count;
+        }
+        return written;
+    }
+
+    void reset() {
+        m_delay.reset();
+        m_phase = 0;
+    }
+    size_t factor() const {return m_factor;}
+
+private:
+    std::vector<T> m_reversed;
+    detail::DelayLine<T> m_delay;
+    size_t m_factor;
+    size_t m_phase = 0; // inputs since the last output
+};
+
+// One second order section, normalized so a0 = 1:
+// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+// Stable sections have |a1| < 2, so the coefficient format needs two integer bits.
+template<typename Coefficient>
+struct Biquad {
+    Coefficient b0, b1, b2, a1, a2;
+};
+
+// Biquad sections in series, each in direct form I. The state is the last two
+// inputs and outputs of every section in the sample format, so no intermediate
+// value can overflow except the rounded section outputs themselves, which follow
+// the sample's overflow policy. The five products of a section are summed in 64
+// bits, exact while the sum of their magnitudes stays below 2^63 in raw units, e.g.
+// for Q1.30 samples below 1.0 and Q2.29 coefficients whose magnitudes sum below 8.
+template<typename Sample, typename Coefficient>
+class BiquadCascade {
+    static_assert(sizeof(Sample::value) <= 4 && sizeof(Coefficient::value) <= 4,
+                  "the accumulator holds products of up to 32-bit values");
+
+public:
+    explicit BiquadCascade(std::vector<Biquad<Coefficient>> sections) : m_sections(std::move(sections)),
+                                                                         m_state(m_sections.size()) {}
+
+    Sample process(Sample sample) {
+        for (size_t s = 0; s < m_sections.size(); ++s) sample = step(m_sections[s], m_state[s], sample);
+        return sample;
+    }
+    // Section by section over the whole block, so each keeps its coefficients and
+    // state in registers. out may be the same array as in.
+    void process(const Sample* in, Sample* out, size_t n) {
+        if (m_sections.empty()) {
+            std::copy(in, in + n, out);
+            return;
+        }
+        const Sample* source = in;
+        for (size_t s = 0; s < m_sections.size(); ++s) {
+            const Biquad<Coefficient> section = m_sections[s];
+            State state = m_state[s];
+            for (size_t i = 0; i < n; ++i) out[i] = step(section, state, source[i]);
+            m_state[s] = state;
+            source = out;
+        }
+    }
+
+    void reset() {std::fill(m_state.begin(), m_state.end(), State());}
+    size_t sections() const {return m_sections.size();}
+
+private:
+    struct State {
+        Sample x1, x2, y1, y2;
+    };
+
+    // The sum of products carries the fraction bits of both formats
+    using Accumulator = FixedPoint<Sample::fraction_bits + Coefficient::fraction_bits, int64_t>;
+
+    static int64_t product(Coefficient c, Sample x) {return static_cast<int64_t>(c.value) * x.value;}
+
+    static Sample step(const Biquad<Coefficient>& q, State& state, Sample x) {
+        const int64_t sum = product(q.b0, x) + product(q.b1, state.x1) + product(q.b2, state.x2) -
+                            product(q.a1, state.y1) - product(q.a2, state.y2);
+        const Sample y(Accumulator::fromRaw(sum));
+        state.x2 = state.x1;
+        state.x1 = x;
+        state.y2 = state.y1;
+        state.y1 = y;
+        return y;
+    }
+
+    std::vector<Biquad<Coefficient>> m_sections;
+    std::vector<State> m_state;
+};
+
+} // namespace fixed_point_filters
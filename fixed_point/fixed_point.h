@@ -1,42 +1,209 @@
-#pragma once
-#include <stdint.h>
-#include <utility>
-
-template<int FractionBits>
-class FixedPoint {
-public:
-    int32_t value;
-
-    constexpr FixedPoint() : value(0) {}
-    constexpr FixedPoint(float f) : value(static_cast<int32_t>(f * (1 << FractionBits))) {}
-    constexpr FixedPoint(std::pair<int32_t, int32_t> frac) : value(0) {
-        *this = fromFraction(frac);
-    }
-
-    // this will not work without FPU support
-    constexpr float toFloat() const {return static_cast<float>(value) / (1 << FractionBits);}
-    // this will work even without FPU
-    constexpr std::pair<int32_t, int32_t> toFraction() const {
-        int32_t numerator = value;
-        int32_t denominator = 1 << FractionBits;
-        return std::make_pair(numerator, denominator);
-    }
-
-    // Operators
-    constexpr FixedPoint operator+(FixedPoint other) const {return FixedPoint::fromRaw(value + other.value);}
-    constexpr FixedPoint operator*(FixedPoint other) const {
-        int64_t tmp = static_cast<int64_t>(value) * other.value;
-        return FixedPoint::fromRaw(static_cast<int32_t>(tmp >> FractionBits));
-    }
-
-    static constexpr FixedPoint fromRaw(int32_t raw) {
-        FixedPoint fp;
-        fp.value = raw;
-        return fp;
-    }
-    static constexpr FixedPoint fromFraction(std::pair<int32_t, int32_t> frac) {
-        FixedPoint fp;
-        fp.value = (static_cast<int64_t>(frac.first) << FractionBits) / frac.second;
-        return fp;
-    }
-};
\ No newline at end of file
+#pragma once
+#include <stdint.h>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+// What happens to a result that does not fit in the storage type
+enum class Overflow {
+    Wrap,     // keep the low bits, like unsigned integer arithmetic
+    Saturate, // clamp to the largest or smallest value
+    Trap      // abort, and refuse to compile in a constant expression
+};
+
+// How operator* and narrowing conversions drop the bits below the fraction
+enum class Rounding {
+    Truncate, // toward negative infinity, the plain arithmetic shift
+    Nearest   // to the nearest value, ties toward positive infinity
+};
+
+namespace fixed_point_detail {
+
+// Signed intermediate for sums, differences and, for signed storage, products of
+// two values of the given size, and its unsigned twin for unsigned products
+template<size_t Bytes> struct Wide;
+template<> struct Wide<1> {using Signed = int32_t; using Unsigned = uint32_t;};
+template<> struct Wide<2> {using Signed = int32_t; using Unsigned = uint32_t;};
+template<> struct Wide<4> {using Signed = int64_t; using Unsigned = uint64_t;};
+#if defined(__SIZEOF_INT128__)
+template<> struct Wide<8> {using Signed = __int128; using Unsigned = unsigned __int128;};
+#endif
+
+// Smallest signed storage with the given number of bits
+template<int Bits>
+using LeastSigned = std::conditional_t<(Bits <= 8), int8_t,
+                    std::conditional_t<(Bits <= 16), int16_t,
+                    std::conditional_t<(Bits <= 32), int32_t, int64_t>>>;
+
+} // namespace fixed_point_detail
+
+template<int FractionBits, typename Storage = int32_t, Overflow OverflowPolicy = Overflow::Wrap,
+         Rounding RoundingPolicy = Rounding::Truncate>
+class FixedPoint {
+    static_assert(std::is_integral<Storage>::value && sizeof(Storage) <= 8, "storage must be an integer of 8 to 64 bits");
+    static_assert(FractionBits >= 0 && FractionBits <= std::numeric_limits<Storage>::digits,
+                  "the fraction must fit in the storage type");
+
+    template<int, typename, Overflow, Rounding> friend class FixedPoint;
+
+    static constexpr bool is_signed = std::is_signed<Storage>::value;
+    // Bits left of the point, the sign bit not counted
+    static constexpr int integer_bits = std::numeric_limits<Storage>::digits - FractionBits;
+
+public:
+    // 16-bit storage and smaller computes in 32 bits, 32-bit storage in 64 bits and
+    // 64-bit storage in 128 bits, where the compiler has __int128
+    using Wide = typename fixed_point_detail::Wide<sizeof(Storage)>::Signed;
+    // Products and quotients: unsigned storage needs all of the 2N bits
+    using Product = std::conditional_t<is_signed, Wide, typename fixed_point_detail::Wide<sizeof(Storage)>::Unsigned>;
+    using Fraction = std::pair<Wide, Wide>;
+    static constexpr int fraction_bits = FractionBits;
+
+    Storage value;
+
+    constexpr FixedPoint() : value(0) {}
+    constexpr FixedPoint(float f) : value(static_cast<Storage>(f * static_cast<float>(one))) {}
+    constexpr FixedPoint(Fraction frac) : value(0) {
+        *this = fromFraction(frac);
+    }
+
+    // Between formats. Implicit where every value converts exactly: no fewer fraction
+    // bits, no fewer integer bits and no unsigned target for a signed source.
+    template<int F, typename S, Overflow O, Rounding R,
+             std::enable_if_t<FixedPoint<F, S, O, R>::template losslessTo<FractionBits, Storage>(), int> = 0>
+    constexpr FixedPoint(FixedPoint<F, S, O, R> other) : value(convert<F>(other.value).value) {}
+    // Narrowing: dropped fraction bits follow this format's rounding policy and
+    // values out of range its overflow policy
+    template<int F, typename S, Overflow O, Rounding R,
+             std::enable_if_t<!FixedPoint<F, S, O, R>::template losslessTo<FractionBits, Storage>(), int> = 0>
+    explicit constexpr FixedPoint(FixedPoint<F, S, O, R> other) : value(convert<F>(other.value).value) {}
+
+    // this will not work without FPU support
+    constexpr float toFloat() const {return static_cast<float>(value) / static_cast<float>(one);}
+    // this will work even without FPU
+    constexpr Fraction toFraction() const {
+        Wide numerator = value;
+        Wide denominator = one;
+        return std::make_pair(numerator, denominator);
+    }
+
+    // Operators, all in integer arithmetic with a double width intermediate
+    constexpr FixedPoint operator+() const {return *this;}
+    constexpr FixedPoint operator-() const {return narrow(-static_cast<Wide>(value));}
+    constexpr FixedPoint operator+(FixedPoint other) const {return narrow(static_cast<Wide>(value) + other.value);}
+    constexpr FixedPoint operator-(FixedPoint other) const {return narrow(static_cast<Wide>(value) - other.value);}
+    constexpr FixedPoint operator*(FixedPoint other) const {
+        Product tmp = static_cast<Product>(value) * static_cast<Product>(other.value);
+        if (RoundingPolicy == Rounding::Nearest && FractionBits > 0) tmp += static_cast<Product>(one / 2);
+        return narrow(tmp >> FractionBits);
+    }
+    // Rounds toward zero like integer division. Dividing by zero saturates toward the
+    // sign of the dividend under Overflow::Saturate and traps otherwise.
+    constexpr FixedPoint operator/(FixedPoint other) const {
+        if (other.value == 0) {
+            if (OverflowPolicy != Overflow::Saturate) overflowTrap();
+            return value > 0 ? maxValue() : value < 0 ? minValue() : FixedPoint();
+        }
+        return narrow(static_cast<Product>(value) * static_cast<Product>(one) / static_cast<Product>(other.value));
+    }
+    // Multiply and divide by 2^shift, for shift in [0, bits of the storage). Right
+    // shifts round toward negative infinity and never overflow.
+    constexpr FixedPoint operator<<(int shift) const {
+        return narrow(static_cast<Product>(value) * (static_cast<Product>(1) << shift));
+    }
+    constexpr FixedPoint operator>>(int shift) const {return fromRaw(static_cast<Storage>(value >> shift));}
+
+    constexpr FixedPoint& operator+=(FixedPoint other) {return *this = *this + other;}
+    constexpr FixedPoint& operator-=(FixedPoint other) {return *this = *this - other;}
+    constexpr FixedPoint& operator*=(FixedPoint other) {return *this = *this * other;}
+    constexpr FixedPoint& operator/=(FixedPoint other) {return *this = *this / other;}
+    constexpr FixedPoint& operator<<=(int shift) {return *this = *this << shift;}
+    constexpr FixedPoint& operator>>=(int shift) {return *this = *this >> shift;}
+
+    constexpr bool operator==(FixedPoint other) const {return value == other.value;}
+    constexpr bool operator!=(FixedPoint other) const {return value != other.value;}
+    constexpr bool operator<(FixedPoint other) const {return value < other.value;}
+    constexpr bool operator<=(FixedPoint other) const {return value <= other.value;}
+    constexpr bool operator>(FixedPoint other) const {return value > other.value;}
+    constexpr bool operator>=(FixedPoint other) const {return value >= other.value;}
+
+    static constexpr FixedPoint fromRaw(Storage raw) {
+        FixedPoint fp;
+        fp.value = raw;
+        return fp;
+    }
+    // The numerator must lie in the range of the storage type. A zero denominator is
+    // handled like division by zero.
+    static constexpr FixedPoint fromFraction(Fraction frac) {
+        if (frac.second == 0) {
+            if (OverflowPolicy != Overflow::Saturate) overflowTrap();
+            return frac.first > 0 ? maxValue() : frac.first < 0 ? minValue() : FixedPoint();
+        }
+        return narrow(frac.first * one / frac.second);
+    }
+    static constexpr FixedPoint maxValue() {return fromRaw(std::numeric_limits<Storage>::max());}
+    static constexpr FixedPoint minValue() {return fromRaw(std::numeric_limits<Storage>::min());}
+
+    // True if every value of this format is exactly representable in the other one
+    template<int F, typename S>
+    static constexpr bool losslessTo() {
+        return F >= FractionBits && std::numeric_limits<S>::digits - F >= integer_bits &&
+               (std::is_signed<S>::value || !is_signed);
+    }
+
+private:
+    static constexpr Wide one = static_cast<Wide>(1) << FractionBits;
+
+    // Brings an intermediate back to the storage type under the overflow policy
+    template<typename Intermediate>
+    static constexpr FixedPoint narrow(Intermediate wide) {
+        const bool above = wide > static_cast<Intermediate>(std::numeric_limits<Storage>::max());
+        const bool below = is_signed ? wide < static_cast<Intermediate>(std::numeric_limits<Storage>::min())
+                                     : wide < static_cast<Intermediate>(0);
+        if (above || below) {
+            if (OverflowPolicy == Overflow::Saturate) return above ? maxValue() : minValue();
+            if (OverflowPolicy == Overflow::Trap) overflowTrap();
+        }
+        return fromRaw(static_cast<Storage>(static_cast<std::make_unsigned_t<Storage>>(wide)));
+    }
+
+    // A raw value with SourceFraction fraction bits rescaled to this format, in the
+    // wider of the two intermediates
+    template<int SourceFraction, typename S>
+    static constexpr FixedPoint convert(S raw) {
+        using Intermediates = fixed_point_detail::Wide<(sizeof(S) > sizeof(Storage) ? sizeof(S) : sizeof(Storage))>;
+        using W = typename Intermediates::Signed;
+        const W source = static_cast<W>(raw);
+        if constexpr (FractionBits >= SourceFraction) {
+            constexpr int shift = FractionBits - SourceFraction;
+            // Checked before shifting, the shifted value may not fit in W
+            const bool above = source > (static_cast<W>(std::numeric_limits<Storage>::max()) >> shift);
+            const bool below = source < (static_cast<W>(std::numeric_limits<Storage>::min()) >> shift);
+            if (above || below) {
+                if (OverflowPolicy == Overflow::Saturate) return above ? maxValue() : minValue();
+                if (OverflowPolicy == Overflow::Trap) overflowTrap();
+                // The low bits of the product, computed without signed overflow
+                using UW = typename Intermediates::Unsigned;
+                return fromRaw(static_cast<Storage>(static_cast<std::make_unsigned_t<Storage>>(
+                    static_cast<UW>(source) << shift)));
+            }
+            return fromRaw(static_cast<Storage>(source * (static_cast<W>(1) << shift)));
+        } else {
+            constexpr int shift = SourceFraction - FractionBits;
+            W rounded = source;
+            if (RoundingPolicy == Rounding::Nearest) rounded += static_cast<W>(1) << (shift - 1);
+            return narrow(rounded >> shift);
+        }
+    }
+
+    // Not constexpr, so an overflow during constant evaluation is a compile error
+    [[noreturn]] static void overflowTrap() {std::abort();}
+};
+
+// Qm.n in the smallest signed storage that holds it, e.g. Q<15, 16> is a FixedPoint<16>
+// in an int32_t and Q<7, 8> one in an int16_t
+template<int IntegerBits, int FractionBits, Overflow OverflowPolicy = Overflow::Wrap,
+         Rounding RoundingPolicy = Rounding::Truncate>
+using Q = FixedPoint<FractionBits, fixed_point_detail::LeastSigned<IntegerBits + FractionBits + 1>, OverflowPolicy,
+                     RoundingPolicy>;
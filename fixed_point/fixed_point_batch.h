@@ -0,0 +1,108 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "batch_kernels.h"
+#include "fixed_point.h"
+
+// Arithmetic on arrays of FixedPoint values, with the same result for every element
+// as the scalar operator to the last bit. Signed 16 and 32-bit storage under
+// Overflow::Wrap or Overflow::Saturate runs vectorized kernels picked for the CPU
+// at runtime, including mulhrs for Q15 with Rounding::Nearest. Other formats, and
+// Overflow::Trap, loop over the operators.
+//
+// Arrays hold n elements. The output may be one of the inputs but must not
+// otherwise overlap them.
+namespace fixed_point_batch {
+
+namespace detail {
+
+template<typename Storage, Overflow OverflowPolicy>
+constexpr bool has_kernels = (std::is_same<Storage, int16_t>::value || std::is_same<Storage, int32_t>::value) &&
+                             OverflowPolicy != Overflow::Trap;
+
+template<int F, typename S, Overflow O, Rounding R>
+constexpr fixed_point_detail::MulFormat format() {
+    return {F, R == Rounding::Nearest, O == Overflow::Saturate};
+}
+
+// FixedPoint holds nothing but its storage
+template<int F, typename S, Overflow O, Rounding R>
+const S* raw(const FixedPoint<F, S, O, R>* values) {
+    static_assert(sizeof(FixedPoint<F, S, O, R>) == sizeof(S) && std::is_standard_layout<FixedPoint<F, S, O, R>>::value);
+    return reinterpret_cast<const S*>(values);
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+S* raw(FixedPoint<F, S, O, R>* values) {
+    static_assert(sizeof(FixedPoint<F, S, O, R>) == sizeof(S) && std::is_standard_layout<FixedPoint<F, S, O, R>>::value);
+    return reinterpret_cast<S*>(values);
+}
+
+} // namespace detail
+
+// out[i] = a[i] + b[i]
+template<int F, typename S, Overflow O, Rounding R>
+void add(const FixedPoint<F, S, O, R>* a, const FixedPoint<F, S, O, R>* b, FixedPoint<F, S, O, R>* out, size_t n) {
+    if constexpr (detail::has_kernels<S, O>) {
+        fixed_point_detail::add(detail::raw(a), detail::raw(b), detail::raw(out), n, O == Overflow::Saturate);
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+    }
+}
+
+// out[i] = a[i] * b[i]
+template<int F, typename S, Overflow O, Rounding R>
+void mul(const FixedPoint<F, S, O, R>* a, const FixedPoint<F, S, O, R>* b, FixedPoint<F, S, O, R>* out, size_t n) {
+    if constexpr (detail::has_kernels<S, O>) {
+        fixed_point_detail::mul(detail::raw(a), detail::raw(b), detail::raw(out), n, detail::format<F, S, O, R>());
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+    }
+}
+
+// out[i] = a[i] * b[i] + c[i], the product rounded before the addition
+template<int F, typename S, Overflow O, Rounding R>
+void mul_add(const FixedPoint<F, S, O, R>* a, const FixedPoint<F, S, O, R>* b, const FixedPoint<F, S, O, R>* c,
+             FixedPoint<F, S, O, R>* out, size_t n) {
+    if constexpr (detail::has_kernels<S, O>) {
+        fixed_point_detail::mul_add(detail::raw(a), detail::raw(b), detail::raw(c), detail::raw(out), n,
+                                    detail::format<F, S, O, R>());
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i] + c[i];
+    }
+}
+
+// out[i] = a[i] * k
+template<int F, typename S, Overflow O, Rounding R>
+void scale(const FixedPoint<F, S, O, R>* a, FixedPoint<F, S, O, R> k, FixedPoint<F, S, O, R>* out, size_t n) {
+    if constexpr (detail::has_kernels<S, O>) {
+        fixed_point_detail::scale(detail::raw(a), k.value, detail::raw(out), n, detail::format<F, S, O, R>());
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * k;
+    }
+}
+
+// Sum of a[i] * b[i]. Unlike a loop of operator* and operator+, the exact products
+// are added up in 64 bits and only the sum is rounded and brought back to the
+// storage type under the format's policies, so the result is the exactly rounded
+// dot product as long as the sum fits in 64 bits, and wraps modulo 2^64 otherwise.
+template<int F, typename S, Overflow O, Rounding R>
+FixedPoint<F, S, O, R> dot(const FixedPoint<F, S, O, R>* a, const FixedPoint<F, S, O, R>* b, size_t n) {
+    static_assert(sizeof(S) <= 4, "dot() accumulates products in 64 bits");
+    using Accumulator = std::conditional_t<std::is_signed<S>::value, int64_t, uint64_t>;
+    Accumulator sum = 0;
+    if constexpr (std::is_same<S, int16_t>::value || std::is_same<S, int32_t>::value) {
+        sum = fixed_point_detail::dot(detail::raw(a), detail::raw(b), n);
+    } else {
+        using Unsigned = std::make_unsigned_t<Accumulator>;
+        for (size_t i = 0; i < n; ++i) {
+            sum = static_cast<Accumulator>(static_cast<Unsigned>(sum) +
+                                           static_cast<Unsigned>(static_cast<Accumulator>(a[i].value) * b[i].value));
+        }
+    }
+    // The sum has twice the fraction bits, the narrowing conversion rounds it
+    return FixedPoint<F, S, O, R>(FixedPoint<2 * F, Accumulator>::fromRaw(sum));
+}
+
+} // namespace fixed_point_batch
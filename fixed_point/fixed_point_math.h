@@ -0,0 +1,440 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include "batch_kernels.h"
+#include "fixed_point.h"
+
+// Elementary functions of FixedPoint values in integer arithmetic only, constexpr
+// like the operators. sqrt is the exact integer square root. sin, cos, atan2, exp
+// and log2 run CORDIC iterations, shifts and adds with a table of arctangents, on
+// Q2.61 intermediates in int64_t, six more iterations than the result has fraction
+// bits. Each result is then rounded under the format's rounding policy and range
+// checked under its overflow policy. Angles are in radians. Like 64-bit storage,
+// this needs __int128.
+//
+// Largest error in units of the last place, measured against long double over the
+// formats of test_fixed_point_math.cpp, 16-bit ones exhaustively:
+//
+//                        sqrt            sin, cos, atan2, exp, log2
+//   Rounding::Nearest    0.5, exact      0.531
+//   Rounding::Truncate   [-1, 0], exact  [-1.031, 0.031]
+//
+// That is correctly rounded except within 1/32 of a place of a tie or of a step.
+// exp is the exception for storage wider than 32 bits: its relative error is 2^-56
+// from the intermediates, under 0.6 places for results below 2^20 in Q31.32, but
+// growing to 80 places near the top of that format.
+//
+// Arguments outside the domain, a negative sqrt or a log2 of 0 or less, abort under
+// Overflow::Trap and otherwise give 0 and minValue() respectively. Results outside
+// the format, like exp(20) in Q16.16 or cos(0) in Q0.15, follow its overflow policy,
+// except that exp() saturates under Overflow::Wrap once e^x needs more than 64 bits.
+// Unsigned 64-bit storage goes through signed 64-bit intermediates and so only
+// reaches half of its range.
+namespace fixed_point_math {
+
+namespace detail {
+
+// Intermediates are Q2.61, which holds pi and the growth of the CORDIC vectors
+constexpr int working_bits = 61;
+constexpr int64_t one = int64_t(1) << working_bits;
+
+// atan(2^-i) and atanh(2^-i) in Q2.61. From i = 21 on both round to 2^(61 - i).
+inline constexpr int64_t atan_table[21] = {
+    0x1921fb54442d1847, 0x0ed63382b0dda7b4, 0x07d6dd7e4b203759, 0x03fab7535585edb9, 0x01ff55bb72cfde9c,
+    0x00ffeaaddd4bb125, 0x007ffd556eedca6b, 0x003fffaaab77752e, 0x001ffff5555bbbb7, 0x000ffffeaaaaddde,
+    0x0007ffffd55556ef, 0x0003fffffaaaaab7, 0x0001ffffff555556, 0x0000ffffffeaaaab, 0x00007ffffffd5555,
+    0x00003fffffffaaab, 0x00001ffffffff555, 0x00000ffffffffeab, 0x000007ffffffffd5, 0x000003fffffffffb,
+    0x000001ffffffffff};
+inline constexpr int64_t atanh_table[21] = {
+    0, // atanh(1) is infinite, the hyperbolic iterations start at i = 1
+    0x1193ea7aad030a97, 0x082c577d408a28d4, 0x0405624727abbdda, 0x0200ab115a6eb59c, 0x01001558891aee25,
+    0x008002aac44568e5, 0x004000555622246b, 0x0020000aaab11116, 0x0010000155558889, 0x000800002aaaac44,
+    0x0004000005555562, 0x0002000000aaaaab, 0x0001000000155555, 0x000080000002aaab, 0x0000400000005555,
+    0x0000200000000aab, 0x0000100000000155, 0x000008000000002b, 0x0000040000000005, 0x0000020000000001};
+
+constexpr int64_t atan_of_power(int i) {return i < 21 ? atan_table[i] : one >> i;}
+constexpr int64_t atanh_of_power(int i) {return i < 21 ? atanh_table[i] : one >> i;}
+
+// The inverse gains of the circular and hyperbolic iterations, 0.60725... and
+// 1.20749..., so a vector that starts at this length ends at length 1
+constexpr int64_t circular_inverse_gain = 0x136e9db5086bcb4d;
+constexpr int64_t hyperbolic_inverse_gain = 0x26a3d0e401dd8465;
+
+constexpr int64_t pi = 0x6487ed5110b4611a;
+constexpr int64_t ln2 = 0x162e42fefa39ef35;
+constexpr int64_t log2e = 0x2e2a8eca5705fc2f;
+constexpr int64_t quarter_pi_q62 = 0x3243f6a8885a308d;
+// 2^128 / (2 pi), in two halves
+constexpr uint64_t turns_per_radian_high = 0x28be60db9391054a;
+constexpr uint64_t turns_per_radian_low = 0x7f09d5f47d4d3770;
+
+// Q2.61 as a FixedPoint, to round results to their format
+using Working = FixedPoint<working_bits, int64_t>;
+
+// v, or -v when sign is -1
+constexpr int64_t flip(int64_t v, int64_t sign) {return (v ^ sign) - sign;}
+
+// The steps of the CORDIC iterations. Circular steps turn by atan(2^-i) for i = 0,
+// 1, 2, ..., hyperbolic ones by atanh(2^-i) for i = 1, 2, ..., taking i = 4, 13
+// and 40 twice, without which they do not converge.
+struct Schedule {
+    int shifts[64];
+    int64_t angles[64];
+    int size;
+    bool hyperbolic;
+};
+
+constexpr Schedule make_schedule(bool hyperbolic) {
+    Schedule schedule{};
+    schedule.hyperbolic = hyperbolic;
+    for (int i = hyperbolic ? 1 : 0, repeat = 4; i <= working_bits; ++i) {
+        for (int pass = hyperbolic && i == repeat ? 2 : 1; pass > 0; --pass) {
+            schedule.shifts[schedule.size] = i;
+            schedule.angles[schedule.size] = hyperbolic ? atanh_of_power(i) : atan_of_power(i);
+            ++schedule.size;
+        }
+        if (hyperbolic && i == repeat) repeat = 3 * repeat + 1;
+    }
+    return schedule;
+}
+
+inline constexpr Schedule circular = make_schedule(false);
+inline constexpr Schedule hyperbolic = make_schedule(true);
+
+// The steps for a result with the given number of bits below its point, up to a
+// shift of six more
+constexpr int steps(const Schedule& schedule, int bits) {
+    int count = 0;
+    while (count < schedule.size && schedule.shifts[count] <= bits + 6) ++count;
+    return count;
+}
+
+// The iterations in place. Rotation turns (x, y) by the angle z and drives z to 0:
+// from the inverse gain on the x axis it ends at (cos z, sin z), or (cosh z, sinh z)
+// with hyperbolic steps. Vectoring turns (x, y) onto the x axis and adds the angle
+// to z: atan(y / x), or atanh(y / x). Each step turns one way or the other by its
+// angle, picked by the sign of z or y with a mask rather than a branch, since the
+// direction is as good as random. x stays positive in every use here.
+// fixed_point_detail::cordic() is the same on arrays, bit for bit.
+constexpr void cordic(int64_t& x, int64_t& y, int64_t& z, const Schedule& schedule, int count, bool vectoring) {
+    for (int k = 0; k < count; ++k) {
+        const int shift = schedule.shifts[k];
+        // 0 to turn counterclockwise, -1 clockwise
+        const int64_t sign = vectoring ? ~(y >> 63) : z >> 63;
+        const int64_t dx = y >> shift, dy = x >> shift;
+        x -= flip(dx, schedule.hyperbolic ? ~sign : sign);
+        y += flip(dy, sign);
+        z -= flip(schedule.angles[k], sign);
+    }
+}
+
+// The iterations one argument needs, and what its result needs besides them.
+// Direct jobs already hold the result of the iterations and skip them.
+struct Job {
+    int64_t x, y, z;
+    int64_t extra;
+    bool direct;
+};
+
+constexpr void run(Job& job, const Schedule& schedule, int bits, bool vectoring) {
+    if (!job.direct) cordic(job.x, job.y, job.z, schedule, steps(schedule, bits), vectoring);
+}
+
+// The jobs of a whole array, a chunk at a time through the vectorized iterations.
+// Every argument of a chunk is read before any of its results is written, so out
+// may be the same array as an input.
+template<typename Start, typename Finish>
+void run_all(size_t n, const Schedule& schedule, int bits, bool vectoring, Start start, Finish finish) {
+    constexpr size_t chunk = 64;
+    const fixed_point_detail::CordicSteps run_steps = {schedule.shifts, schedule.angles, steps(schedule, bits),
+                                                       schedule.hyperbolic, vectoring};
+    Job jobs[chunk];
+    int64_t x[chunk], y[chunk], z[chunk];
+    for (size_t done = 0; done < n; done += chunk) {
+        const size_t count = n - done < chunk ? n - done : chunk;
+        for (size_t k = 0; k < count; ++k) {
+            jobs[k] = start(done + k);
+            x[k] = jobs[k].x;
+            y[k] = jobs[k].y;
+            z[k] = jobs[k].z;
+        }
+        // Direct jobs go through as well rather than break up the vectors
+        fixed_point_detail::cordic(x, y, z, count, run_steps);
+        for (size_t k = 0; k < count; ++k) {
+            if (!jobs[k].direct) {
+                jobs[k].x = x[k];
+                jobs[k].y = y[k];
+                jobs[k].z = z[k];
+            }
+            finish(done + k, jobs[k]);
+        }
+    }
+}
+
+// An angle of raw / 2^F radians as a fraction of a turn, the whole turn 2^64, so
+// that wrapping around is the reduction modulo 2 pi. The 192-bit product with
+// 1 / (2 pi) keeps the fraction exact to 2^-64 of a turn for any raw value.
+template<int F, typename S>
+constexpr uint64_t turns(S raw) {
+    using U = unsigned __int128;
+    const bool negative = raw < S();
+    const uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(raw) : static_cast<uint64_t>(raw);
+    const U product = U(magnitude) * turns_per_radian_high + ((U(magnitude) * turns_per_radian_low) >> 64);
+    const uint64_t turn = static_cast<uint64_t>(product >> F);
+    return negative ? 0 - turn : turn;
+}
+
+// sin and cos: the nearest quarter turn in extra, then at most pi/4 radians
+template<int F, typename S>
+constexpr Job cos_sin_job(S raw) {
+    const uint64_t turn = turns<F>(raw);
+    const uint64_t quadrant = (turn + (uint64_t(1) << 61)) >> 62;
+    const int64_t rest = static_cast<int64_t>(turn - (quadrant << 62));
+    const int64_t z = static_cast<int64_t>((static_cast<__int128>(rest) * quarter_pi_q62) >> 62);
+    // Exact on the axes, which the iterations only approach
+    if (z == 0) return {one, 0, 0, static_cast<int64_t>(quadrant & 3), true};
+    return {circular_inverse_gain, 0, z, static_cast<int64_t>(quadrant & 3), false};
+}
+
+// (cos, sin) in Q2.61, the iterations turned by the quarter turns
+struct Vector {
+    int64_t x, y;
+};
+
+constexpr Vector cos_sin(const Job& job) {
+    switch (job.extra) {
+    case 0: return {job.x, job.y};
+    case 1: return {-job.y, job.x};
+    case 2: return {-job.x, -job.y};
+    default: return {job.y, -job.x};
+    }
+}
+
+// atan2: the angle from the iterations plus extra, the half turn for the left half
+// plane. Only the ratio matters, so both are scaled to put the larger magnitude in
+// [2^59, 2^60), which leaves room for the gain.
+template<typename S>
+constexpr Job atan2_job(S y, S x) {
+    // On the axes exactly, which the iterations only approach
+    if (y == S()) return {0, 0, 0, x < S() ? pi : 0, true};
+    if (x == S()) return {0, 0, 0, y > S() ? pi / 2 : -pi / 2, true};
+
+    __int128 wide_x = x, wide_y = y;
+    const uint64_t magnitude_x = static_cast<uint64_t>(wide_x < 0 ? -wide_x : wide_x);
+    const uint64_t magnitude_y = static_cast<uint64_t>(wide_y < 0 ? -wide_y : wide_y);
+    const int top = 63 - __builtin_clzll(magnitude_x > magnitude_y ? magnitude_x : magnitude_y);
+    if (top > 59) {
+        wide_x >>= top - 59;
+        wide_y >>= top - 59;
+    } else {
+        wide_x *= int64_t(1) << (59 - top);
+        wide_y *= int64_t(1) << (59 - top);
+    }
+    int64_t start = 0;
+    if (wide_x < 0) {
+        wide_x = -wide_x;
+        wide_y = -wide_y;
+        start = y > S() ? pi : -pi;
+    }
+    return {static_cast<int64_t>(wide_x), static_cast<int64_t>(wide_y), 0, start, false};
+}
+
+// exp: x log2(e) = k + f with 0 <= f < 1, and e^x = 2^k e^(f ln 2). The iterations
+// give e^z = cosh z + sinh z in [1, 2) for z = f ln 2, extra is k.
+template<int F, typename S>
+constexpr Job exp_job(S raw) {
+    const __int128 product = static_cast<__int128>(raw) * log2e;
+    const __int128 k = product >> (F + working_bits);
+    // Past the largest and the smallest result of any format
+    if (k > 64) return {one, 0, 0, 65, true};
+    if (k < -F - 2) return {one, 0, 0, -F - 3, true};
+    const auto fraction_mask = (static_cast<unsigned __int128>(1) << (F + working_bits)) - 1;
+    const int64_t f = static_cast<int64_t>((static_cast<unsigned __int128>(product) & fraction_mask) >> F);
+    const int64_t z = static_cast<int64_t>((static_cast<__int128>(f) * ln2) >> working_bits);
+    if (z == 0) return {one, 0, 0, static_cast<int64_t>(k), true};
+    return {hyperbolic_inverse_gain, 0, z, static_cast<int64_t>(k), false};
+}
+
+// Not constexpr, so a domain or range error during constant evaluation is a
+// compile error
+[[noreturn]] inline void trap() {std::abort();}
+
+// e^z times 2^k, rounded at the last place of the format
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> exp_result(const Job& job) {
+    using Result = FixedPoint<F, S, O, R>;
+    using Raw = FixedPoint<F, int64_t>;
+    const int64_t mantissa = job.x + job.y;
+    const int shift = static_cast<int>(job.extra) + F - working_bits;
+    if (shift >= 0) {
+        // Past 64 bits the conversion below could not see the overflow, and the low
+        // bits that Wrap would keep are not computed, so Wrap saturates as well
+        if (shift > 62 - working_bits) {
+            if (O == Overflow::Trap) trap();
+            return Result::maxValue();
+        }
+        return Result(Raw::fromRaw(mantissa << shift));
+    }
+    if (shift < -63) return Result();
+    const int64_t half = R == Rounding::Nearest ? int64_t(1) << (-shift - 1) : 0;
+    return Result(Raw::fromRaw((mantissa + half) >> -shift));
+}
+
+// log2 of a positive raw value: raw / 2^F = 2^extra m with m in [1, 2), and
+// ln m = 2 atanh((m - 1) / (m + 1)), the ratio below 1/3
+template<int F, typename S>
+constexpr Job log2_job(S raw) {
+    const uint64_t magnitude = static_cast<uint64_t>(raw);
+    const int top = 63 - __builtin_clzll(magnitude);
+    const int64_t m = top <= working_bits ? static_cast<int64_t>(magnitude << (working_bits - top))
+                                          : static_cast<int64_t>(magnitude >> (top - working_bits));
+    // Exact for powers of 2
+    if (m == one) return {0, 0, 0, top - F, true};
+    return {m + one, m - one, 0, top - F, false};
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> log2_result(const Job& job) {
+    const int64_t fraction = static_cast<int64_t>((static_cast<__int128>(job.z) * log2e) >> (working_bits - 1));
+    // Q7.56 holds the whole part, at most 64 in magnitude
+    const int64_t result = job.extra * (int64_t(1) << 56) + (fraction >> (working_bits - 56));
+    return FixedPoint<F, S, O, R>(FixedPoint<56, int64_t>::fromRaw(result));
+}
+
+// The highest set bit of v > 0, up to 128 bits
+template<typename U>
+constexpr int top_bit(U v) {
+    if constexpr (sizeof(U) > 8) {
+        const uint64_t high = static_cast<uint64_t>(v >> 64);
+        if (high != 0) return 127 - __builtin_clzll(high);
+    }
+    return 63 - __builtin_clzll(static_cast<uint64_t>(v));
+}
+
+} // namespace detail
+
+// Rounded from the exact square root
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> sqrt(FixedPoint<F, S, O, R> x) {
+    if (x.value <= S()) {
+        if (x.value < S() && O == Overflow::Trap) detail::trap();
+        return FixedPoint<F, S, O, R>();
+    }
+    // The root of value * 2^F has F fraction bits, found one bit at a time from the
+    // highest power of 4 in it. Whether a bit is set is as good as random, so the
+    // steps select with a mask rather than branch.
+    using Unsigned = typename fixed_point_detail::Wide<sizeof(S)>::Unsigned;
+    Unsigned rest = static_cast<Unsigned>(x.value) << F;
+    Unsigned root = 0;
+    for (Unsigned bit = Unsigned(1) << (detail::top_bit(rest) & ~1); bit != 0; bit >>= 2) {
+        const Unsigned trial = root + bit;
+        const Unsigned taken = Unsigned(0) - static_cast<Unsigned>(rest >= trial);
+        rest -= trial & taken;
+        root = (root >> 1) + (bit & taken);
+    }
+    // value * 2^F - root^2 > root means the root lies past root + 1/2, never on it
+    if (R == Rounding::Nearest && rest > root) ++root;
+    // Below 2^(bits of S) since F is at most that, so it fits
+    return FixedPoint<F, S, O, R>::fromRaw(static_cast<S>(root));
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> sin(FixedPoint<F, S, O, R> x) {
+    detail::Job job = detail::cos_sin_job<F>(x.value);
+    detail::run(job, detail::circular, F, false);
+    return FixedPoint<F, S, O, R>(detail::Working::fromRaw(detail::cos_sin(job).y));
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> cos(FixedPoint<F, S, O, R> x) {
+    detail::Job job = detail::cos_sin_job<F>(x.value);
+    detail::run(job, detail::circular, F, false);
+    return FixedPoint<F, S, O, R>(detail::Working::fromRaw(detail::cos_sin(job).x));
+}
+
+// The angle of (x, y) in (-pi, pi], 0 for (0, 0)
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> atan2(FixedPoint<F, S, O, R> y, FixedPoint<F, S, O, R> x) {
+    detail::Job job = detail::atan2_job(y.value, x.value);
+    detail::run(job, detail::circular, F, true);
+    return FixedPoint<F, S, O, R>(detail::Working::fromRaw(job.extra + job.z));
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> exp(FixedPoint<F, S, O, R> x) {
+    detail::Job job = detail::exp_job<F>(x.value);
+    // The relative error matters, for every significant bit of the storage
+    detail::run(job, detail::hyperbolic, std::numeric_limits<S>::digits, false);
+    return detail::exp_result<F, S, O, R>(job);
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+constexpr FixedPoint<F, S, O, R> log2(FixedPoint<F, S, O, R> x) {
+    if (x.value <= S()) {
+        if (O == Overflow::Trap) detail::trap();
+        return FixedPoint<F, S, O, R>::minValue();
+    }
+    detail::Job job = detail::log2_job<F>(x.value);
+    // The angle is doubled and scaled by log2(e), one more bit
+    detail::run(job, detail::hyperbolic, F + 1, true);
+    return detail::log2_result<F, S, O, R>(job);
+}
+
+// Array versions, out[i] = f(in[i]), out may be the same array as in. Except for
+// sqrt they run the iterations of eight arguments at once, in two AVX2 vectors of
+// four, where the CPU has AVX2, with the same results as the functions above.
+template<int F, typename S, Overflow O, Rounding R>
+void sqrt(const FixedPoint<F, S, O, R>* in, FixedPoint<F, S, O, R>* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = sqrt(in[i]);
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+void sin(const FixedPoint<F, S, O, R>* in, FixedPoint<F, S, O, R>* out, size_t n) {
+    detail::run_all(
+        n, detail::circular, F, false, [&](size_t i) {return detail::cos_sin_job<F>(in[i].value);},
+        [&](size_t i, const detail::Job& job) {
+            out[i] = FixedPoint<F, S, O, R>(detail::Working::fromRaw(detail::cos_sin(job).y));
+        });
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+void cos(const FixedPoint<F, S, O, R>* in, FixedPoint<F, S, O, R>* out, size_t n) {
+    detail::run_all(
+        n, detail::circular, F, false, [&](size_t i) {return detail::cos_sin_job<F>(in[i].value);},
+        [&](size_t i, const detail::Job& job) {
+            out[i] = FixedPoint<F, S, O, R>(detail::Working::fromRaw(detail::cos_sin(job).x));
+        });
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+void atan2(const FixedPoint<F, S, O, R>* y, const FixedPoint<F, S, O, R>* x, FixedPoint<F, S, O, R>* out, size_t n) {
+    detail::run_all(
+        n, detail::circular, F, true, [&](size_t i) {return detail::atan2_job(y[i].value, x[i].value);},
+        [&](size_t i, const detail::Job& job) {
+            out[i] = FixedPoint<F, S, O, R>(detail::Working::fromRaw(job.extra + job.z));
+        });
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+void exp(const FixedPoint<F, S, O, R>* in, FixedPoint<F, S, O, R>* out, size_t n) {
+    detail::run_all(
+        n, detail::hyperbolic, std::numeric_limits<S>::digits, false,
+        [&](size_t i) {return detail::exp_job<F>(in[i].value);},
+        [&](size_t i, const detail::Job& job) {out[i] = detail::exp_result<F, S, O, R>(job);});
+}
+
+template<int F, typename S, Overflow O, Rounding R>
+void log2(const FixedPoint<F, S, O, R>* in, FixedPoint<F, S, O, R>* out, size_t n) {
+    // Arguments outside the domain get a direct job that is never used
+    detail::run_all(
+        n, detail::hyperbolic, F + 1, true,
+        [&](size_t i) {return in[i].value > S() ? detail::log2_job<F>(in[i].value) : detail::Job{0, 0, 0, 0, true};},
+        [&](size_t i, const detail::Job& job) {
+            out[i] = in[i].value > S() ? detail::log2_result<F, S, O, R>(job) : log2(in[i]);
+        });
+}
+
+} // namespace fixed_point_math
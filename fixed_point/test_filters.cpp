@@ -0,0 +1,260 @@
+#include "gtest/gtest.h"
+#include "filters.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace fixed_point_filters;
+
+using Q15 = FixedPoint<15, int16_t, Overflow::Saturate, Rounding::Nearest>;
+using Q30 = FixedPoint<30, int32_t, Overflow::Saturate, Rounding::Nearest>; // Q1.30
+using Q2x29 = FixedPoint<29, int32_t>;
+using Q1x14 = FixedPoint<14, int16_t>;
+
+template <typename T>
+static double to_double(T x)
+{
+    return std::ldexp(static_cast<double>(x.value), -T::fraction_bits);
+}
+
+// Rounded to the nearest value of the format
+template <typename T>
+static T from_double(double x)
+{
+    return T::fromRaw(static_cast<decltype(T::value)>(std::llround(std::ldexp(x, T::fraction_bits))));
+}
+
+// Windowed sinc lowpass with the cutoff as a fraction of the sample rate
+template <typename T>
+static std::vector<T> lowpass_taps(size_t count, double cutoff)
+{
+    const double pi = std::acos(-1.0);
+    std::vector<T> taps;
+    for (size_t k = 0; k < count; ++k)
+    {
+        double t = static_cast<double>(k) - (count - 1) / 2.0;
+        double sinc = t == 0 ? 2 * cutoff : std::sin(2 * pi * cutoff * t) / (pi * t);
+        double window = 0.54 - 0.46 * std::cos(2 * pi * k / (count - 1));
+        taps.push_back(from_double<T>(sinc * window));
+    }
+    return taps;
+}
+
+template <typename T>
+static std::vector<T> noise(size_t n, double amplitude, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> sample(-amplitude, amplitude);
+    std::vector<T> values;
+    for (size_t i = 0; i < n; ++i) values.push_back(from_double<T>(sample(rng)));
+    return values;
+}
+
+// 1. FIR filters against a double precision convolution of the same values
+TEST(FirFilterTest, ImpulseResponseIsTheTaps)
+{
+    std::vector<Q15> taps = {Q15(0.5f), Q15(-0.25f), Q15(0.125f), Q15(0.0625f)};
+    FirFilter<Q15> fir(taps);
+    EXPECT_EQ(fir.taps(), 4);
+
+    EXPECT_EQ(fir.process(Q15::maxValue()).value, taps[0].value);
+    for (size_t k = 1; k < taps.size(); ++k) EXPECT_EQ(fir.process(Q15()).value, taps[k].value) << k;
+    EXPECT_EQ(fir.process(Q15()), Q15());
+
+    EXPECT_THROW(FirFilter<Q15>(std::vector<Q15>{}), std::invalid_argument);
+}
+
+TEST(FirFilterTest, MatchesDoubleReference)
+{
+    const auto taps = lowpass_taps<Q15>(63, 0.1);
+    const auto input = noise<Q15>(2000, 0.9, 1);
+    FirFilter<Q15> fir(taps);
+    std::vector<Q15> output(input.size());
+    fir.process(input.data(), output.data(), input.size());
+
+    for (size_t n = 0; n < input.size(); ++n)
+    {
+        double expected = 0;
+        for (size_t k = 0; k < taps.size() && k <= n; ++k) expected += to_double(taps[k]) * to_double(input[n - k]);
+        // The exact sum rounded once: within half a step
+        EXPECT_LE(std::abs(to_double(output[n]) - expected), std::ldexp(0.5, -15)) << n;
+    }
+}
+
+TEST(FirFilterTest, TruncationAndSaturation)
+{
+    using TruncQ16 = FixedPoint<16>;
+    using SatQ16 = FixedPoint<16, int32_t, Overflow::Saturate>;
+
+    // Truncation rounds toward negative infinity, within one step below
+    const auto taps = lowpass_taps<TruncQ16>(31, 0.2);
+    const auto input = noise<TruncQ16>(500, 100.0, 2);
+    FirFilter<TruncQ16> fir(taps);
+    for (size_t n = 0; n < input.size(); ++n)
+    {
+        double expected = 0;
+        for (size_t k = 0; k < taps.size() && k <= n; ++k) expected += to_double(taps[k]) * to_double(input[n - k]);
+        double error = to_double(fir.process(input[n])) - expected;
+        EXPECT_LE(error, 0.0) << n;
+        EXPECT_GT(error, -std::ldexp(1.0, -16)) << n;
+    }
+
+    // A gain of 4 on a full scale input clamps
+    FirFilter<SatQ16> gain({SatQ16(2.0f), SatQ16(2.0f)});
+    gain.process(SatQ16(20000.0f));
+    EXPECT_EQ(gain.process(SatQ16(20000.0f)), SatQ16::maxValue());
+    EXPECT_EQ(gain.process(SatQ16(-20000.0f)), SatQ16());
+    EXPECT_EQ(gain.process(SatQ16(-20000.0f)), SatQ16::minValue());
+}
+
+TEST(FirFilterTest, BlocksMatchSamples)
+{
+    const auto taps = lowpass_taps<Q15>(40, 0.15);
+    // Longer than the delay line holds before it moves its history back
+    const auto input = noise<Q15>(5000, 0.5, 3);
+    FirFilter<Q15> by_sample(taps);
+    FirFilter<Q15> by_block(taps);
+
+    std::vector<Q15> expected;
+    for (Q15 x : input) expected.push_back(by_sample.process(x));
+
+    // Uneven blocks, the last one in place
+    std::vector<Q15> output(input.size());
+    size_t done = 0;
+    for (size_t block : {1, 7, 64, 300, 2000})
+    {
+        by_block.process(input.data() + done, output.data() + done, block);
+        done += block;
+    }
+    for (size_t i = 0; i < done; ++i) EXPECT_EQ(output[i], expected[i]) << i;
+    output.assign(input.begin(), input.end());
+    by_block.process(output.data() + done, output.data() + done, input.size() - done);
+    for (size_t i = done; i < input.size(); ++i) EXPECT_EQ(output[i], expected[i]) << i;
+
+    by_block.reset();
+    by_block.process(input.data(), output.data(), input.size());
+    EXPECT_EQ(output, expected);
+}
+
+TEST(FirDecimatorTest, KeepsEveryFactorthOutput)
+{
+    const auto taps = lowpass_taps<Q15>(48, 0.05);
+    const auto input = noise<Q15>(3001, 0.7, 4);
+    FirFilter<Q15> fir(taps);
+    std::vector<Q15> full(input.size());
+    fir.process(input.data(), full.data(), input.size());
+
+    for (size_t factor : {1, 2, 3, 8})
+    {
+        FirDecimator<Q15> decimator(taps, factor);
+        EXPECT_EQ(decimator.factor(), factor);
+        std::vector<Q15> output(input.size());
+        // Chunks that do not line up with the factor
+        size_t written = 0;
+        for (size_t done = 0, chunk = 0; done < input.size(); done += chunk)
+        {
+            chunk = std::min<size_t>(chunk == 13 ? 1287 : 13, input.size() - done);
+            written += decimator.process(input.data() + done, chunk, output.data() + written);
+        }
+        ASSERT_EQ(written, input.size() / factor) << factor;
+        for (size_t i = 0; i < written; ++i) EXPECT_EQ(output[i], full[(i + 1) * factor - 1]) << factor << " " << i;
+    }
+    EXPECT_THROW(FirDecimator<Q15>(taps, 0), std::invalid_argument);
+}
+
+// 2. Biquad cascades against a double precision direct form I
+template <typename Coefficient>
+static std::vector<Biquad<Coefficient>> butterworth_lowpass(double cutoff)
+{
+    // Fourth order as two sections, from the audio EQ cookbook
+    const double pi = std::acos(-1.0);
+    std::vector<Biquad<Coefficient>> sections;
+    for (double q : {0.54119610, 1.30656296})
+    {
+        double w = 2 * pi * cutoff;
+        double alpha = std::sin(w) / (2 * q);
+        double a0 = 1 + alpha;
+        double b1 = (1 - std::cos(w)) / a0;
+        sections.push_back({from_double<Coefficient>(b1 / 2), from_double<Coefficient>(b1),
+                            from_double<Coefficient>(b1 / 2), from_double<Coefficient>(-2 * std::cos(w) / a0),
+                            from_double<Coefficient>((1 - alpha) / a0)});
+    }
+    return sections;
+}
+
+template <typename Sample, typename Coefficient>
+static std::vector<double> reference(const std::vector<Biquad<Coefficient>>& sections, const std::vector<Sample>& input)
+{
+    std::vector<double> signal;
+    for (Sample x : input) signal.push_back(to_double(x));
+    for (const auto& q : sections)
+    {
+        double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        for (double& x : signal)
+        {
+            double y = to_double(q.b0) * x + to_double(q.b1) * x1 + to_double(q.b2) * x2 - to_double(q.a1) * y1 -
+                       to_double(q.a2) * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            x = y;
+        }
+    }
+    return signal;
+}
+
+TEST(BiquadCascadeTest, MatchesDoubleReference)
+{
+    const auto sections = butterworth_lowpass<Q2x29>(0.05);
+    const auto input = noise<Q30>(5000, 0.9, 5);
+    BiquadCascade<Q30, Q2x29> cascade(sections);
+    EXPECT_EQ(cascade.sections(), 2);
+    std::vector<Q30> output(input.size());
+    cascade.process(input.data(), output.data(), input.size());
+
+    // Rounding errors of 2^-31 per section, grown by the gain of the recursion
+    const auto expected = reference(sections, input);
+    double worst = 0;
+    for (size_t n = 0; n < input.size(); ++n) worst = std::max(worst, std::abs(to_double(output[n]) - expected[n]));
+    EXPECT_LT(worst, 1e-7);
+
+    // 16-bit samples and coefficients, with correspondingly larger errors
+    const auto sections16 = butterworth_lowpass<Q1x14>(0.1);
+    const auto input16 = noise<Q15>(5000, 0.5, 6);
+    BiquadCascade<Q15, Q1x14> cascade16(sections16);
+    const auto expected16 = reference(sections16, input16);
+    double worst16 = 0;
+    for (size_t n = 0; n < input16.size(); ++n)
+    {
+        worst16 = std::max(worst16, std::abs(to_double(cascade16.process(input16[n])) - expected16[n]));
+    }
+    EXPECT_LT(worst16, 2e-3);
+}
+
+TEST(BiquadCascadeTest, BlocksMatchSamples)
+{
+    const auto sections = butterworth_lowpass<Q2x29>(0.2);
+    const auto input = noise<Q30>(700, 1.0, 7);
+    BiquadCascade<Q30, Q2x29> by_sample(sections);
+    BiquadCascade<Q30, Q2x29> by_block(sections);
+
+    std::vector<Q30> expected;
+    for (Q30 x : input) expected.push_back(by_sample.process(x));
+
+    std::vector<Q30> output = input;
+    by_block.process(output.data(), output.data(), 100);
+    by_block.process(output.data() + 100, output.data() + 100, input.size() - 100);
+    EXPECT_EQ(output, expected);
+
+    // A step settles to the DC gain of 1
+    by_block.reset();
+    std::vector<Q30> step(2000, Q30(0.5f));
+    by_block.process(step.data(), step.data(), step.size());
+    EXPECT_NEAR(to_double(step.back()), 0.5, 1e-6);
+
+    BiquadCascade<Q30, Q2x29> empty({});
+    std::vector<Q30> passed(3);
+    empty.process(input.data(), passed.data(), 3);
+    EXPECT_EQ(passed, std::vector<Q30>(input.begin(), input.begin() + 3));
+}
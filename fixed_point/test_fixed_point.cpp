@@ -1,166 +1,454 @@
-#include "gtest/gtest.h"
-#include "fixed_point.h"
-#include <vector>
-
-using Q16 = FixedPoint<16>;
-
-// 1. Simple tests
-TEST(FixedPointTest, Addition)
-{
-    Q16 a(0.5f);
-    Q16 b(0.25f);
-    Q16 c = a + b;
-
-    EXPECT_NEAR(c.toFloat(), 0.75f, 0.0001f);
-}
-
-TEST(FixedPointTest, Multiplication)
-{
-    Q16 a(0.5f);
-    Q16 b(0.25f);
-    Q16 c = a * b;
-
-    EXPECT_NEAR(c.toFloat(), 0.125f, 0.0001f);
-}
-
-TEST(FixedPointTest, Fraction)
-{
-    Q16 a(3.5f);
-    std::pair<int32_t, int32_t> fraction = a.toFraction();
-
-    EXPECT_NEAR(static_cast<float>(fraction.first) / fraction.second, 3.5f, 0.0001f);
-}
-
-// 2. Parameterized tests - Test multiple fractions at once
-class FractionTest : public ::testing::TestWithParam<std::tuple<int32_t, int32_t, float>>
-{
-protected:
-    void SetUp() override
-    {
-        // optional setup code
-    }
-};
-
-TEST_P(FractionTest, FromFractionRoundTrip)
-{
-    auto [numerator, denominator, expected_float] = GetParam();
-
-    Q16 fp = Q16::fromFraction({numerator, denominator});
-    auto [num_back, den_back] = fp.toFraction();
-
-    EXPECT_NEAR(static_cast<float>(num_back) / den_back, expected_float, 0.0001f);
-
-    Q16 reconstructed({num_back, den_back});
-    EXPECT_EQ(fp.value, reconstructed.value);
-}
-
-INSTANTIATE_TEST_SUITE_P(
-    CommonFractions,
-    FractionTest,
-    ::testing::Values(
-        std::make_tuple(1, 2, 0.5f),
-        std::make_tuple(3, 4, 0.75f),
-        std::make_tuple(22, 7, 3.14285f),
-        std::make_tuple(1, 3, 0.33333f),
-        std::make_tuple(-5, 8, -0.625f),
-        std::make_tuple(6, 2, 3.0f)));
-
-// 3. Fixture class - Share setup between related tests
-class FixedPointFractionFixture : public ::testing::Test
-{
-protected:
-    void SetUp() override
-    {
-        half = Q16::fromFraction({1, 2});
-        quarter = Q16::fromFraction({1, 4});
-        three_quarters = Q16::fromFraction({3, 4});
-        pi_approx = Q16::fromFraction({22, 7});
-    }
-
-    Q16 half, quarter, three_quarters, pi_approx;
-};
-
-TEST_F(FixedPointFractionFixture, FractionArithmetic)
-{
-    Q16 result = half + quarter;
-    EXPECT_EQ(result.value, three_quarters.value);
-
-    Q16 result2 = half * half;
-    EXPECT_EQ(result2.value, quarter.value);
-}
-
-TEST_F(FixedPointFractionFixture, FractionComparison)
-{
-    EXPECT_GT(three_quarters.value, half.value);
-    EXPECT_LT(quarter.value, half.value);
-}
-
-// 4. Helper function - More readable assertions
-bool IsApproximatelyEqual(float actual, float expected, float tolerance)
-{
-    return std::abs(actual - expected) <= tolerance;
-}
-
-TEST(FixedPointTest, HelperFunctionExample)
-{
-    Q16 fp = Q16::fromFraction({355, 113}); // better pi approximation
-    EXPECT_TRUE(IsApproximatelyEqual(fp.toFloat(), 3.14159f, 0.0001f));
-}
-
-// 5. Death tests - test error conditions
-TEST(FixedPointTest, DivisionByZero)
-{
-    EXPECT_DEATH(Q16::fromFraction({1, 0}), ".*"); // Dies with any message
-}
-
-// 6. Value parameterized tests with custom names
-struct FractionTestData
-{
-    int32_t num, den;
-    const char *name;
-    float expected;
-};
-
-// make the ouput clearer
-std::ostream &operator<<(std::ostream &os, const FractionTestData &data)
-{
-    return os << data.name << "(" << data.num << "/" << data.den << "=" << data.expected << ")";
-}
-
-class NamedFractionTest : public ::testing::TestWithParam<FractionTestData>
-{
-};
-
-TEST_P(NamedFractionTest, AccuracyTest)
-{
-    const auto &data = GetParam();
-    Q16 fp = Q16::fromFraction({data.num, data.den});
-    EXPECT_NEAR(fp.toFloat(), data.expected, 0.001f) << "Failed for fraction " << data.name;
-}
-
-INSTANTIATE_TEST_SUITE_P(
-    FractionAccuracy,
-    NamedFractionTest,
-    ::testing::Values(
-        FractionTestData{1, 2, "half", 0.5},
-        FractionTestData{22, 7, "pi_rough", 3.14286f},
-        FractionTestData{355, 113, "pi_precise", 3.14159f}),
-    [](const ::testing::TestParamInfo<FractionTestData> &info)
-    {
-        return info.param.name; // Use custom names for test cases
-    });
-
-// 7. Typed tests - Test different FractionBits value
-template <typename T>
-class TypedFractionTest : public ::testing::Test
-{
-};
-
-using FixedPointTypes = ::testing::Types<FixedPoint<8>, FixedPoint<16>, FixedPoint<24>>;
-TYPED_TEST_SUITE(TypedFractionTest, FixedPointTypes);
-
-TYPED_TEST(TypedFractionTest, BasicFraction)
-{
-    TypeParam fp = TypeParam::fromFraction({1, 2});
-    EXPECT_NEAR(fp.toFloat(), 0.5f, 0.01f);
-}
\ No newline at end of file
+#include "gtest/gtest.h"
+#include "fixed_point.h"
+#include <vector>
+
+using Q16 = FixedPoint<16>;
+
+// 1. Simple tests
+TEST(FixedPointTest, Addition)
+{
+    Q16 a(0.5f);
+    Q16 b(0.25f);
+    Q16 c = a + b;
+
+    EXPECT_NEAR(c.toFloat(), 0.75f, 0.0001f);
+}
+
+TEST(FixedPointTest, Multiplication)
+{
+    Q16 a(0.5f);
+    Q16 b(0.25f);
+    Q16 c = a * b;
+
+    EXPECT_NEAR(c.toFloat(), 0.125f, 0.0001f);
+}
+
+TEST(FixedPointTest, Fraction)
+{
+    Q16 a(3.5f);
+    std::pair<int32_t, int32_t> fraction = a.toFraction();
+
+    EXPECT_NEAR(static_cast<float>(fraction.first) / fraction.second, 3.5f, 0.0001f);
+}
+
+// 2. Parameterized tests - Test multiple fractions at once
+class FractionTest : public ::testing::TestWithParam<std::tuple<int32_t, int32_t, float>>
+{
+protected:
+    void SetUp() override
+    {
+        // optional setup code
+    }
+};
+
+TEST_P(FractionTest, FromFractionRoundTrip)
+{
+    auto [numerator, denominator, expected_float] = GetParam();
+
+    Q16 fp = Q16::fromFraction({numerator, denominator});
+    auto [num_back, den_back] = fp.toFraction();
+
+    EXPECT_NEAR(static_cast<float>(num_back) / den_back, expected_float, 0.0001f);
+
+    Q16 reconstructed({num_back, den_back});
+    EXPECT_EQ(fp.value, reconstructed.value);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CommonFractions,
+    FractionTest,
+    ::testing::Values(
+        std::make_tuple(1, 2, 0.5f),
+        std::make_tuple(3, 4, 0.75f),
+        std::make_tuple(22, 7, 3.14285f),
+        std::make_tuple(1, 3, 0.33333f),
+        std::make_tuple(-5, 8, -0.625f),
+        std::make_tuple(6, 2, 3.0f)));
+
+// 3. Fixture class - Share setup between related tests
+class FixedPointFractionFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        half = Q16::fromFraction({1, 2});
+        quarter = Q16::fromFraction({1, 4});
+        three_quarters = Q16::fromFraction({3, 4});
+        pi_approx = Q16::fromFraction({22, 7});
+    }
+
+    Q16 half, quarter, three_quarters, pi_approx;
+};
+
+TEST_F(FixedPointFractionFixture, FractionArithmetic)
+{
+    Q16 result = half + quarter;
+    EXPECT_EQ(result.value, three_quarters.value);
+
+    Q16 result2 = half * half;
+    EXPECT_EQ(result2.value, quarter.value);
+}
+
+TEST_F(FixedPointFractionFixture, FractionComparison)
+{
+    EXPECT_GT(three_quarters.value, half.value);
+    EXPECT_LT(quarter.value, half.value);
+}
+
+// 4. Helper function - More readable assertions
+bool IsApproximatelyEqual(float actual, float expected, float tolerance)
+{
+    return std::abs(actual - expected) <= tolerance;
+}
+
+TEST(FixedPointTest, HelperFunctionExample)
+{
+    Q16 fp = Q16::fromFraction({355, 113}); // better pi approximation
+    EXPECT_TRUE(IsApproximatelyEqual(fp.toFloat(), 3.14159f, 0.0001f));
+}
+
+// 5. Death tests - test error conditions
+TEST(FixedPointTest, DivisionByZero)
+{
+    EXPECT_DEATH(Q16::fromFraction({1, 0}), ".*"); // Dies with any message
+}
+
+// 6. Value parameterized tests with custom names
+struct FractionTestData
+{
+    int32_t num, den;
+    const char *name;
+    float expected;
+};
+
+// make the ouput clearer
+std::ostream &operator<<(std::ostream &os, const FractionTestData &data)
+{
+    return os << data.name << "(" << data.num << "/" << data.den << "=" << data.expected << ")";
+}
+
+class NamedFractionTest : public ::testing::TestWithParam<FractionTestData>
+{
+};
+
+TEST_P(NamedFractionTest, AccuracyTest)
+{
+    const auto &data = GetParam();
+    Q16 fp = Q16::fromFraction({data.num, data.den});
+    EXPECT_NEAR(fp.toFloat(), data.expected, 0.001f) << "Failed for fraction " << data.name;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FractionAccuracy,
+    NamedFractionTest,
+    ::testing::Values(
+        FractionTestData{1, 2, "half", 0.5},
+        FractionTestData{22, 7, "pi_rough", 3.14286f},
+        FractionTestData{355, 113, "pi_precise", 3.14159f}),
+    [](const ::testing::TestParamInfo<FractionTestData> &info)
+    {
+        return info.param.name; // Use custom names for test cases
+    });
+
+// 7. Typed tests - Test different FractionBits value
+template <typename T>
+class TypedFractionTest : public ::testing::Test
+{
+};
+
+using FixedPointTypes = ::testing::Types<FixedPoint<8>, FixedPoint<16>, FixedPoint<24>, Q<7, 8>, FixedPoint<12, uint16_t>,
+                                         FixedPoint<32, int64_t>>;
+TYPED_TEST_SUITE(TypedFractionTest, FixedPointTypes);
+
+TYPED_TEST(TypedFractionTest, BasicFraction)
+{
+    TypeParam fp = TypeParam::fromFraction({1, 2});
+    EXPECT_NEAR(fp.toFloat(), 0.5f, 0.01f);
+}
+
+// 8. Compile-time checks - every operator is constexpr
+namespace
+{
+constexpr Q16 one = Q16::fromRaw(1 << 16);
+constexpr Q16 half = Q16::fromFraction({1, 2});
+
+static_assert(one - half == half);
+static_assert(-half + one == half);
+static_assert(half * half == Q16::fromFraction({1, 4}));
+static_assert(one / Q16::fromFraction({4, 1}) == Q16::fromFraction({1, 4}));
+static_assert((half << 2) == Q16::fromFraction({2, 1}));
+static_assert((one >> 3) == Q16::fromFraction({1, 8}));
+static_assert(half < one && one > half && half <= half && half >= half && half != one);
+
+constexpr Q16 accumulate()
+{
+    Q16 x = one;
+    x += half;
+    x -= Q16::fromFraction({1, 4});
+    x *= Q16::fromFraction({2, 1});
+    x /= Q16::fromFraction({10, 1});
+    x <<= 3;
+    x >>= 1;
+    return x;
+}
+static_assert(accumulate() == one); // (1 + 1/2 - 1/4) * 2 / 10 * 8 / 2
+
+using SatQ16 = FixedPoint<16, int32_t, Overflow::Saturate>;
+static_assert(SatQ16::maxValue() + SatQ16::fromRaw(1) == SatQ16::maxValue());
+static_assert(-SatQ16::minValue() == SatQ16::maxValue());
+static_assert(Q16::maxValue() + Q16::fromRaw(1) == Q16::minValue());
+} // namespace
+
+TEST(FixedPointTest, SubtractionAndNegation)
+{
+    Q16 a(0.75f);
+    Q16 b(0.25f);
+
+    EXPECT_EQ((a - b).value, Q16(0.5f).value);
+    EXPECT_EQ((b - a).value, Q16(-0.5f).value);
+    EXPECT_EQ((-a).value, Q16(-0.75f).value);
+    EXPECT_EQ((+a).value, a.value);
+}
+
+TEST(FixedPointTest, Division)
+{
+    EXPECT_EQ((Q16(3.0f) / Q16(4.0f)).value, Q16(0.75f).value);
+    EXPECT_EQ((Q16(-1.0f) / Q16(8.0f)).value, Q16(-0.125f).value);
+    EXPECT_EQ((Q16(1.0f) / Q16(0.5f)).value, Q16(2.0f).value);
+
+    // Rounds toward zero like integer division
+    EXPECT_EQ((Q16(1.0f) / Q16(3.0f)).value, 21845);
+    EXPECT_EQ((Q16(-1.0f) / Q16(3.0f)).value, -21845);
+
+    // Matches the exact quotient of the raw values to the last bit
+    for (int32_t a : {1, 7, 65536, -98304, 1 << 24, INT32_MAX / 3})
+    {
+        for (int32_t b : {3, -5, 65536, 12345, -(1 << 20)})
+        {
+            int64_t expected = static_cast<int64_t>(a) * 65536 / b;
+            if (expected > INT32_MAX || expected < INT32_MIN) continue;
+            EXPECT_EQ((Q16::fromRaw(a) / Q16::fromRaw(b)).value, expected) << a << " / " << b;
+        }
+    }
+}
+
+TEST(FixedPointTest, ComparisonOperators)
+{
+    Q16 small(-2.5f);
+    Q16 big(1.25f);
+
+    EXPECT_TRUE(small < big);
+    EXPECT_TRUE(small <= big);
+    EXPECT_TRUE(big > small);
+    EXPECT_TRUE(big >= small);
+    EXPECT_TRUE(small != big);
+    EXPECT_TRUE(small == Q16(-2.5f));
+    EXPECT_FALSE(big < big);
+}
+
+TEST(FixedPointTest, Shifts)
+{
+    EXPECT_EQ((Q16(1.5f) << 2).value, Q16(6.0f).value);
+    EXPECT_EQ((Q16(6.0f) >> 2).value, Q16(1.5f).value);
+    // Right shifts round toward negative infinity
+    EXPECT_EQ((Q16::fromRaw(-3) >> 1).value, -2);
+}
+
+TEST(FixedPointTest, RoundingPolicies)
+{
+    using Truncating = FixedPoint<4, int32_t, Overflow::Wrap, Rounding::Truncate>;
+    using Rounded = FixedPoint<4, int32_t, Overflow::Wrap, Rounding::Nearest>;
+
+    // 0.1875 * 0.5 = 0.09375, halfway between 1/16 and 2/16
+    EXPECT_EQ((Truncating::fromRaw(3) * Truncating::fromRaw(8)).value, 1);
+    EXPECT_EQ((Rounded::fromRaw(3) * Rounded::fromRaw(8)).value, 2);
+    // -0.09375 truncates down to -2/16, ties round up to -1/16
+    EXPECT_EQ((Truncating::fromRaw(-3) * Truncating::fromRaw(8)).value, -2);
+    EXPECT_EQ((Rounded::fromRaw(-3) * Rounded::fromRaw(8)).value, -1);
+    // 3/16 * 3/16 = 9/256, nearer to 1/16 than to 0
+    EXPECT_EQ((Truncating::fromRaw(3) * Truncating::fromRaw(3)).value, 0);
+    EXPECT_EQ((Rounded::fromRaw(3) * Rounded::fromRaw(3)).value, 1);
+
+    // Rounded products are never further than half a step from the exact one
+    for (int32_t a = -300; a <= 300; a += 7)
+    {
+        for (int32_t b = -300; b <= 300; b += 11)
+        {
+            double exact = a * b / 16.0;
+            EXPECT_LE(std::abs((Rounded::fromRaw(a) * Rounded::fromRaw(b)).value - exact), 0.5);
+            EXPECT_LT(exact - (Truncating::fromRaw(a) * Truncating::fromRaw(b)).value, 1.0);
+        }
+    }
+}
+
+TEST(FixedPointTest, WrappingOverflow)
+{
+    EXPECT_EQ((Q16::maxValue() + Q16::fromRaw(1)).value, INT32_MIN);
+    EXPECT_EQ((Q16::minValue() - Q16::fromRaw(1)).value, INT32_MAX);
+    EXPECT_EQ((-Q16::minValue()).value, INT32_MIN);
+    EXPECT_EQ((Q16(30000.0f) * Q16(2.0f)).value, static_cast<int32_t>(static_cast<uint32_t>(60000u << 16)));
+}
+
+TEST(FixedPointTest, SaturatingOverflow)
+{
+    using Sat = FixedPoint<16, int32_t, Overflow::Saturate>;
+
+    EXPECT_EQ(Sat::maxValue() + Sat(1.0f), Sat::maxValue());
+    EXPECT_EQ(Sat::minValue() - Sat(1.0f), Sat::minValue());
+    EXPECT_EQ(Sat(30000.0f) * Sat(2.0f), Sat::maxValue());
+    EXPECT_EQ(Sat(30000.0f) * Sat(-2.0f), Sat::minValue());
+    EXPECT_EQ(Sat(30000.0f) / Sat(0.25f), Sat::maxValue());
+    EXPECT_EQ(Sat(1000.0f) << 10, Sat::maxValue());
+    EXPECT_EQ(Sat(-1000.0f) << 10, Sat::minValue());
+    EXPECT_EQ(-Sat::minValue(), Sat::maxValue());
+
+    EXPECT_EQ(Sat(1.0f) / Sat(), Sat::maxValue());
+    EXPECT_EQ(Sat(-1.0f) / Sat(), Sat::minValue());
+    EXPECT_EQ(Sat() / Sat(), Sat());
+    EXPECT_EQ(Sat::fromFraction({3, 0}), Sat::maxValue());
+    EXPECT_EQ(Sat::fromFraction({-3, 0}), Sat::minValue());
+    EXPECT_EQ(Sat::fromFraction({0, 0}), Sat());
+
+    // Results in range are the same as with wrapping
+    EXPECT_EQ((Sat(1.5f) * Sat(-2.25f)).value, (Q16(1.5f) * Q16(-2.25f)).value);
+}
+
+TEST(FixedPointTest, TrappingOverflow)
+{
+    using Trap = FixedPoint<16, int32_t, Overflow::Trap>;
+
+    EXPECT_EQ((Trap(100.0f) * Trap(3.0f)).value, Trap(300.0f).value);
+    EXPECT_DEATH(Trap::maxValue() + Trap(1.0f), ".*");
+    EXPECT_DEATH(Trap::minValue() - Trap(1.0f), ".*");
+    EXPECT_DEATH(Trap(30000.0f) * Trap(2.0f), ".*");
+    EXPECT_DEATH(Trap(1.0f) / Trap(), ".*");
+    EXPECT_DEATH(-Trap::minValue(), ".*");
+    EXPECT_DEATH(Trap(1000.0f) << 10, ".*");
+}
+
+TYPED_TEST(TypedFractionTest, ArithmeticRoundTrip)
+{
+    TypeParam a = TypeParam::fromFraction({3, 4});
+    TypeParam b = TypeParam::fromFraction({5, 2});
+
+    EXPECT_EQ((a + b - b).value, a.value);
+    EXPECT_EQ((a * b / b).value, a.value);
+    EXPECT_NEAR((a / b).toFloat(), 0.3f, 0.01f);
+    EXPECT_TRUE(a < b);
+}
+
+// 9. Storage widths and conversions between formats
+using Q15 = FixedPoint<15, int16_t>;
+using Q32x32 = FixedPoint<32, int64_t>;
+
+static_assert(sizeof(Q15) == 2 && sizeof(Q<7, 8>) == 2 && sizeof(Q<3, 4>) == 1);
+static_assert(sizeof(Q32x32) == 8 && sizeof(Q<15, 16>) == sizeof(Q16));
+static_assert(std::is_same<Q<15, 16>, Q16>::value);
+static_assert(std::is_same<Q15::Wide, int32_t>::value && std::is_same<Q16::Wide, int64_t>::value);
+static_assert(std::is_same<FixedPoint<8, uint32_t>::Product, uint64_t>::value);
+
+// Implicit only where nothing is lost
+static_assert(std::is_convertible<Q15, Q16>::value && std::is_convertible<Q<7, 8>, Q32x32>::value);
+static_assert(std::is_convertible<FixedPoint<8, uint8_t>, Q<8, 8>>::value);
+static_assert(!std::is_convertible<Q16, Q15>::value && std::is_constructible<Q15, Q16>::value);
+static_assert(!std::is_convertible<Q16, FixedPoint<8>>::value); // fewer fraction bits
+static_assert(!std::is_convertible<Q<7, 8>, FixedPoint<8, uint16_t>>::value); // sign
+static_assert(!std::is_convertible<FixedPoint<8, uint16_t>, Q<7, 8>>::value); // one integer bit short
+static_assert(Q16(Q15::fromRaw(-16384)) == Q16(-0.5f));
+static_assert(Q15(Q16(0.25f)) == Q15::fromRaw(8192));
+
+TEST(FixedPointTest, NarrowStorage)
+{
+    Q15 a(0.5f);
+    Q15 b(-0.25f);
+
+    EXPECT_EQ((a + b).value, 8192);
+    EXPECT_EQ((a * b).value, -4096);
+    EXPECT_EQ((b / a).value, -16384);
+    EXPECT_FLOAT_EQ((a - b).toFloat(), 0.75f);
+    // Products of the extremes fit the 32-bit intermediate
+    EXPECT_EQ((Q15::minValue() * Q15::minValue()).value, INT16_MIN); // 1.0 wraps to -1.0
+    EXPECT_EQ((Q15::maxValue() * Q15::maxValue()).value, 32766);
+    using SatQ15 = FixedPoint<15, int16_t, Overflow::Saturate>;
+    EXPECT_EQ((SatQ15::minValue() * SatQ15::minValue()).value, INT16_MAX);
+
+    using Q3x4 = Q<3, 4>;
+    EXPECT_EQ(Q3x4(2.5f).value, 40);
+    EXPECT_EQ((Q3x4(2.5f) * Q3x4(-1.5f)).value, -60);
+    EXPECT_EQ((Q3x4(7.0f) + Q3x4(1.0f)).value, INT8_MIN);
+}
+
+TEST(FixedPointTest, WideStorage)
+{
+    // Q31.32 keeps fractions Q16 cannot and integers far beyond its range
+    Q32x32 third = Q32x32::fromFraction({1, 3});
+    EXPECT_EQ(third.value, 0x55555555);
+    Q32x32 big(1e9f);
+    EXPECT_EQ((big * third).value, static_cast<int64_t>(1e9) * 0x55555555);
+    EXPECT_EQ((big / Q32x32(4.0f)).value, static_cast<int64_t>(2.5e8) << 32);
+    EXPECT_EQ((Q32x32::minValue() / Q32x32(-1.0f)).value, INT64_MIN); // wraps, as for Q16
+    using SatQ32x32 = FixedPoint<32, int64_t, Overflow::Saturate>;
+    EXPECT_EQ(SatQ32x32(2e9f) * SatQ32x32(-2e9f), SatQ32x32::minValue());
+
+    // A long sum of small steps stays exact, where Q16 would have lost every step
+    Q32x32 sum;
+    const Q32x32 step = Q32x32::fromRaw(3);
+    for (int i = 0; i < 1000; ++i) sum += step;
+    EXPECT_EQ(sum.value, 3000);
+    EXPECT_EQ(Q16(sum).value, 0);
+}
+
+TEST(FixedPointTest, UnsignedStorage)
+{
+    using U8x8 = FixedPoint<8, uint16_t>;
+    using SatU8x8 = FixedPoint<8, uint16_t, Overflow::Saturate>;
+
+    EXPECT_EQ(U8x8(200.5f).value, 51328);
+    EXPECT_EQ((U8x8(200.0f) * U8x8(1.25f)).value, 250 << 8);
+    // The full 32-bit product of two 16-bit values
+    EXPECT_EQ((U8x8::maxValue() * U8x8::fromRaw(256)).value, UINT16_MAX);
+    EXPECT_EQ((U8x8(1.0f) - U8x8(2.0f)).value, UINT16_MAX - 255);
+    EXPECT_EQ(SatU8x8(1.0f) - SatU8x8(2.0f), SatU8x8());
+    EXPECT_EQ(SatU8x8(200.0f) * SatU8x8(2.0f), SatU8x8::maxValue());
+    EXPECT_TRUE(U8x8(255.0f) > U8x8(1.0f));
+}
+
+TEST(FixedPointTest, NarrowingConversions)
+{
+    using SatQ15 = FixedPoint<15, int16_t, Overflow::Saturate>;
+    using RoundedQ15 = FixedPoint<15, int16_t, Overflow::Wrap, Rounding::Nearest>;
+
+    // Dropped fraction bits follow the rounding policy of the target
+    Q16 value = Q16::fromRaw(0x3001); // half a Q15 step above 0.375
+    EXPECT_EQ(Q15(value).value, 0x1800);
+    EXPECT_EQ(RoundedQ15(value).value, 0x1801);
+    EXPECT_EQ(Q15(-value).value, -0x1801);
+    EXPECT_EQ(RoundedQ15(-value).value, -0x1800);
+
+    // Out of range values follow its overflow policy
+    EXPECT_EQ(SatQ15(Q16(1.5f)), SatQ15::maxValue());
+    EXPECT_EQ(SatQ15(Q16(-3.0f)), SatQ15::minValue());
+    EXPECT_EQ(Q15(Q16(1.5f)).value, static_cast<int16_t>(0xC000));
+    EXPECT_EQ(SatQ15(Q16(-1.0f)).value, INT16_MIN);
+    using TrapQ15 = FixedPoint<15, int16_t, Overflow::Trap>;
+    EXPECT_DEATH(TrapQ15(Q16(1.5f)), ".*");
+
+    // Wider integer part at the same fraction, and a sign change
+    EXPECT_EQ((FixedPoint<16, uint32_t, Overflow::Saturate>(Q16(-1.0f))).value, 0u);
+    EXPECT_EQ((Q<7, 8>(FixedPoint<8, uint16_t>(100.0f))).value, 100 << 8);
+    EXPECT_EQ((FixedPoint<8, int16_t, Overflow::Saturate>(FixedPoint<8, uint16_t>(200.0f))).value, INT16_MAX);
+
+    // Widening and narrowing back is the identity
+    for (int32_t raw = INT16_MIN; raw <= INT16_MAX; raw += 97)
+    {
+        Q15 original = Q15::fromRaw(static_cast<int16_t>(raw));
+        Q32x32 wide = original;
+        EXPECT_EQ(Q15(wide), original);
+        EXPECT_EQ(Q15(Q16(original)), original);
+        EXPECT_FLOAT_EQ(wide.toFloat(), original.toFloat());
+    }
+
+    // Mixed formats meet in the wider one
+    Q16 mixed = Q16(2.0f) * Q15(0.5f);
+    EXPECT_EQ(mixed, Q16(1.0f));
+}
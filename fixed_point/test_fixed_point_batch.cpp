@@ -0,0 +1,216 @@
+#include "gtest/gtest.h"
+#include "fixed_point_batch.h"
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace fixed_point_detail;
+
+// Raw values over the whole range, with the extremes and values near zero mixed in
+template <typename S>
+static std::vector<S> random_raw(std::mt19937& rng, size_t n)
+{
+    std::uniform_int_distribution<int64_t> any(std::numeric_limits<S>::min(), std::numeric_limits<S>::max());
+    std::uniform_int_distribution<int64_t> small(-300, 300);
+    std::vector<S> values(n);
+    for (auto& v : values)
+    {
+        switch (rng() % 6)
+        {
+        case 0: v = std::numeric_limits<S>::min(); break;
+        case 1: v = std::numeric_limits<S>::max(); break;
+        case 2: v = static_cast<S>(small(rng)); break;
+        default: v = static_cast<S>(any(rng)); break;
+        }
+    }
+    return values;
+}
+
+template <typename T>
+static std::vector<T> random_values(std::mt19937& rng, size_t n)
+{
+    std::vector<T> values;
+    for (auto raw : random_raw<decltype(T::value)>(rng, n)) values.push_back(T::fromRaw(raw));
+    return values;
+}
+
+// 1. Every batch function against the operators, for each format
+template <typename T>
+class BatchTest : public ::testing::Test
+{
+};
+
+using BatchTypes = ::testing::Types<FixedPoint<16>, FixedPoint<16, int32_t, Overflow::Saturate>,
+                                    FixedPoint<16, int32_t, Overflow::Wrap, Rounding::Nearest>,
+                                    FixedPoint<16, int32_t, Overflow::Saturate, Rounding::Nearest>,
+                                    FixedPoint<0, int32_t, Overflow::Saturate>, FixedPoint<31, int32_t, Overflow::Saturate>,
+                                    FixedPoint<15, int16_t>, FixedPoint<15, int16_t, Overflow::Wrap, Rounding::Nearest>,
+                                    FixedPoint<15, int16_t, Overflow::Saturate, Rounding::Nearest>,
+                                    Q<7, 8, Overflow::Saturate>, FixedPoint<4, int8_t>,
+                                    FixedPoint<12, uint16_t, Overflow::Saturate>>;
+TYPED_TEST_SUITE(BatchTest, BatchTypes);
+
+TYPED_TEST(BatchTest, MatchesOperators)
+{
+    std::mt19937 rng(23);
+    for (size_t n = 0; n < 70; ++n)
+    {
+        auto a = random_values<TypeParam>(rng, n);
+        auto b = random_values<TypeParam>(rng, n);
+        auto c = random_values<TypeParam>(rng, n);
+        const TypeParam k = random_values<TypeParam>(rng, 1)[0];
+        std::vector<TypeParam> out(n);
+
+        fixed_point_batch::add(a.data(), b.data(), out.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] + b[i]) << n << " " << i;
+        fixed_point_batch::mul(a.data(), b.data(), out.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] * b[i]) << n << " " << i;
+        fixed_point_batch::mul_add(a.data(), b.data(), c.data(), out.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] * b[i] + c[i]) << n << " " << i;
+        fixed_point_batch::scale(a.data(), k, out.data(), n);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], a[i] * k) << n << " " << i;
+
+        // In place
+        std::vector<TypeParam> expected(n);
+        for (size_t i = 0; i < n; ++i) expected[i] = a[i] * b[i];
+        fixed_point_batch::mul(a.data(), b.data(), a.data(), n);
+        EXPECT_EQ(a, expected);
+    }
+}
+
+template <typename T>
+struct FormatOf;
+template <int F, typename S, Overflow O, Rounding R>
+struct FormatOf<FixedPoint<F, S, O, R>>
+{
+    static constexpr int fraction_bits = F;
+    static constexpr bool nearest = R == Rounding::Nearest;
+    static constexpr bool saturate = O == Overflow::Saturate;
+};
+
+TYPED_TEST(BatchTest, DotRoundsTheExactSum)
+{
+    using S = decltype(TypeParam::value);
+    using Format = FormatOf<TypeParam>;
+    std::mt19937 rng(7);
+    for (size_t n = 0; n < 100; n += 3)
+    {
+        // Small enough that the exact sum fits in 64 bits
+        std::uniform_int_distribution<int64_t> pick(std::is_signed<S>::value ? -2000 : 0, 2000);
+        const int64_t unit = sizeof(S) > 2 ? 1000 : 1;
+        std::vector<TypeParam> a(n);
+        std::vector<TypeParam> b(n);
+        __int128 sum = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            a[i] = TypeParam::fromRaw(static_cast<S>(pick(rng) * unit));
+            b[i] = TypeParam::fromRaw(static_cast<S>(pick(rng) * unit));
+            sum += static_cast<__int128>(a[i].value) * b[i].value;
+        }
+        // Floor, or nearest with ties up, of the sum in units of the last bit
+        const __int128 half = Format::nearest && Format::fraction_bits > 0 ? __int128(1) << (Format::fraction_bits - 1) : 0;
+        const __int128 expected = (sum + half) >> Format::fraction_bits;
+
+        const TypeParam result = fixed_point_batch::dot(a.data(), b.data(), n);
+        if (Format::saturate && expected > std::numeric_limits<S>::max())
+        {
+            EXPECT_EQ(result, TypeParam::maxValue()) << n;
+        }
+        else if (Format::saturate && expected < std::numeric_limits<S>::min())
+        {
+            EXPECT_EQ(result, TypeParam::minValue()) << n;
+        }
+        else
+        {
+            EXPECT_EQ(result.value, static_cast<S>(expected)) << n;
+        }
+    }
+}
+
+// 2. Each kernel against the scalar loop, on raw values
+template <typename S>
+static void expect_kernels_match(MulFormat format)
+{
+    std::mt19937 rng(format.fraction_bits * 4 + format.round * 2 + format.saturate);
+    for (size_t n = 0; n < 100; ++n)
+    {
+        auto a = random_raw<S>(rng, n);
+        auto b = random_raw<S>(rng, n);
+        auto c = random_raw<S>(rng, n);
+        const S k = random_raw<S>(rng, 1)[0];
+        std::vector<S> expected(n);
+        std::vector<S> out(n);
+
+        auto check = [&](auto kernel_add, auto kernel_mul, auto kernel_mul_add, auto kernel_scale, auto kernel_dot,
+                         const char* name)
+        {
+            add_scalar(a.data(), b.data(), expected.data(), n, format.saturate);
+            kernel_add(a.data(), b.data(), out.data(), n, format.saturate);
+            EXPECT_EQ(out, expected) << name << " add " << n;
+            mul_scalar(a.data(), b.data(), expected.data(), n, format);
+            kernel_mul(a.data(), b.data(), out.data(), n, format);
+            EXPECT_EQ(out, expected) << name << " mul " << n;
+            mul_add_scalar(a.data(), b.data(), c.data(), expected.data(), n, format);
+            kernel_mul_add(a.data(), b.data(), c.data(), out.data(), n, format);
+            EXPECT_EQ(out, expected) << name << " mul_add " << n;
+            scale_scalar(a.data(), k, expected.data(), n, format);
+            kernel_scale(a.data(), k, out.data(), n, format);
+            EXPECT_EQ(out, expected) << name << " scale " << n;
+            EXPECT_EQ(kernel_dot(a.data(), b.data(), n), dot_scalar(a.data(), b.data(), n)) << name << " dot " << n;
+        };
+
+        using Add = void (*)(const S*, const S*, S*, size_t, bool);
+        using Mul = void (*)(const S*, const S*, S*, size_t, MulFormat);
+        using MulAdd = void (*)(const S*, const S*, const S*, S*, size_t, MulFormat);
+        using Scale = void (*)(const S*, S, S*, size_t, MulFormat);
+        using Dot = int64_t (*)(const S*, const S*, size_t);
+        check(Add(add), Mul(mul), MulAdd(mul_add), Scale(scale), Dot(dot), "dispatch");
+#if FIXED_POINT_HAS_SIMD
+        if (cpu_has_sse41())
+        {
+            check(Add(add_sse41), Mul(mul_sse41), MulAdd(mul_add_sse41), Scale(scale_sse41), Dot(dot_sse41), "sse41");
+        }
+        if (cpu_has_avx2())
+        {
+            check(Add(add_avx2), Mul(mul_avx2), MulAdd(mul_add_avx2), Scale(scale_avx2), Dot(dot_avx2), "avx2");
+        }
+#endif
+    }
+}
+
+TEST(BatchKernelTest, KernelsMatchScalar)
+{
+    for (int fraction_bits : {0, 1, 8, 15, 16, 24, 31})
+    {
+        for (bool round : {false, true})
+        {
+            for (bool saturate : {false, true})
+            {
+                expect_kernels_match<int32_t>({fraction_bits, round, saturate});
+                if (fraction_bits <= 15) expect_kernels_match<int16_t>({fraction_bits, round, saturate});
+            }
+        }
+    }
+}
+
+TEST(BatchKernelTest, Q15Extremes)
+{
+    using Q15 = FixedPoint<15, int16_t, Overflow::Wrap, Rounding::Nearest>;
+    using SatQ15 = FixedPoint<15, int16_t, Overflow::Saturate, Rounding::Nearest>;
+
+    std::vector<Q15> minus_one(20, Q15::minValue());
+    std::vector<Q15> product(20);
+    fixed_point_batch::mul(minus_one.data(), minus_one.data(), product.data(), product.size());
+    EXPECT_EQ(product, minus_one); // -1 * -1 wraps
+
+    std::vector<SatQ15> sat_minus_one(20, SatQ15::minValue());
+    std::vector<SatQ15> sat_product(20);
+    fixed_point_batch::mul(sat_minus_one.data(), sat_minus_one.data(), sat_product.data(), sat_product.size());
+    EXPECT_EQ(sat_product, std::vector<SatQ15>(20, SatQ15::maxValue()));
+
+    // A pair sum of 2^31 in the 16-bit dot product
+    EXPECT_EQ(fixed_point_batch::dot(minus_one.data(), minus_one.data(), minus_one.size()).value, 0);
+    EXPECT_EQ(dot(reinterpret_cast<const int16_t*>(minus_one.data()), reinterpret_cast<const int16_t*>(minus_one.data()),
+                  minus_one.size()),
+              int64_t(20) << 30);
+}
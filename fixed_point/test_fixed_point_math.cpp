@@ -0,0 +1,295 @@
+#include "gtest/gtest.h"
+#include "fixed_point_math.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using Q16 = FixedPoint<16>;
+using Q32x32 = FixedPoint<32, int64_t, Overflow::Saturate, Rounding::Nearest>;
+
+template <typename T>
+static long double to_long_double(T x)
+{
+    return std::ldexp(static_cast<long double>(x.value), -T::fraction_bits);
+}
+
+namespace
+{
+template <typename T>
+struct RoundingOf;
+template <int F, typename S, Overflow O, Rounding R>
+struct RoundingOf<FixedPoint<F, S, O, R>>
+{
+    static constexpr bool nearest = R == Rounding::Nearest;
+};
+} // namespace
+
+// Every value of 16-bit formats, otherwise random magnitudes over the whole range
+template <typename T>
+static std::vector<T> arguments()
+{
+    using S = decltype(T::value);
+    std::vector<T> values;
+    if (sizeof(S) <= 2)
+    {
+        for (int64_t raw = std::numeric_limits<S>::min(); raw <= std::numeric_limits<S>::max(); ++raw)
+        {
+            values.push_back(T::fromRaw(static_cast<S>(raw)));
+        }
+        return values;
+    }
+    std::mt19937_64 rng(25);
+    values = {T::minValue(), T::maxValue(), T::fromRaw(1)};
+    for (int i = 0; i < 20000; ++i)
+    {
+        auto raw = static_cast<S>(rng() >> (rng() % 64));
+        values.push_back(T::fromRaw(std::is_signed<S>::value && rng() % 2 ? static_cast<S>(-raw) : raw));
+    }
+    return values;
+}
+
+// The largest errors below and above the exact results, in units of the last place
+template <typename T>
+class ErrorRange
+{
+public:
+    // Exact results outside the format are skipped, they follow the overflow policy
+    void add(T result, long double exact)
+    {
+        if (exact > to_long_double(T::maxValue()) || exact < to_long_double(T::minValue())) return;
+        const long double error = std::ldexp(to_long_double(result) - exact, T::fraction_bits);
+        m_below = std::min(m_below, error);
+        m_above = std::max(m_above, error);
+    }
+
+    // The bounds documented in fixed_point_math.h
+    void expect_within(long double bound, const char *function) const
+    {
+        if (RoundingOf<T>::nearest)
+        {
+            EXPECT_GE(m_below, -0.5L - bound) << function;
+            EXPECT_LE(m_above, 0.5L + bound) << function;
+        }
+        else
+        {
+            EXPECT_GE(m_below, -1.0L - bound) << function;
+            EXPECT_LE(m_above, bound) << function;
+        }
+    }
+
+private:
+    long double m_below = 0, m_above = 0;
+};
+
+// 1. Each function against long double, for each format
+template <typename T>
+class MathTest : public ::testing::Test
+{
+};
+
+using MathTypes = ::testing::Types<FixedPoint<15, int16_t, Overflow::Saturate, Rounding::Nearest>, FixedPoint<15, int16_t>,
+                                   FixedPoint<12, int16_t, Overflow::Saturate, Rounding::Nearest>,
+                                   FixedPoint<12, uint16_t, Overflow::Saturate>, FixedPoint<4, int8_t>, Q16,
+                                   FixedPoint<16, int32_t, Overflow::Saturate, Rounding::Nearest>,
+                                   FixedPoint<30, int32_t, Overflow::Saturate, Rounding::Nearest>, Q32x32,
+                                   FixedPoint<32, int64_t>>;
+TYPED_TEST_SUITE(MathTest, MathTypes);
+
+constexpr long double cordic_bound = 0.0315L;
+
+TYPED_TEST(MathTest, Sqrt)
+{
+    ErrorRange<TypeParam> range;
+    for (TypeParam x : arguments<TypeParam>())
+    {
+        if (x.value >= 0) range.add(fixed_point_math::sqrt(x), std::sqrt(to_long_double(x)));
+    }
+    // Exactly rounded
+    range.expect_within(1e-12L, "sqrt");
+}
+
+TYPED_TEST(MathTest, SinCos)
+{
+    ErrorRange<TypeParam> sin_range, cos_range;
+    for (TypeParam x : arguments<TypeParam>())
+    {
+        sin_range.add(fixed_point_math::sin(x), std::sin(to_long_double(x)));
+        cos_range.add(fixed_point_math::cos(x), std::cos(to_long_double(x)));
+    }
+    sin_range.expect_within(cordic_bound, "sin");
+    cos_range.expect_within(cordic_bound, "cos");
+}
+
+TYPED_TEST(MathTest, Atan2)
+{
+    const auto ys = arguments<TypeParam>();
+    auto xs = ys;
+    std::shuffle(xs.begin(), xs.end(), std::mt19937(25));
+    ErrorRange<TypeParam> range;
+    for (size_t i = 0; i < ys.size(); ++i)
+    {
+        range.add(fixed_point_math::atan2(ys[i], xs[i]), std::atan2(to_long_double(ys[i]), to_long_double(xs[i])));
+    }
+    range.expect_within(cordic_bound, "atan2");
+}
+
+TYPED_TEST(MathTest, ExpLog2)
+{
+    // The relative error of exp is 2^-56, below the bound up to 2^20 in any format
+    const long double largest = sizeof(TypeParam) > 4 ? std::ldexp(1.0L, 20) : std::numeric_limits<long double>::max();
+    ErrorRange<TypeParam> exp_range, log2_range;
+    for (TypeParam x : arguments<TypeParam>())
+    {
+        const long double exact = std::exp(to_long_double(x));
+        if (exact < largest) exp_range.add(fixed_point_math::exp(x), exact);
+        if (x.value > 0) log2_range.add(fixed_point_math::log2(x), std::log2(to_long_double(x)));
+    }
+    exp_range.expect_within(cordic_bound, "exp");
+    log2_range.expect_within(cordic_bound, "log2");
+}
+
+// 2. Exact values, domain errors and results outside the format
+TEST(FixedPointMathTest, ExactValues)
+{
+    using namespace fixed_point_math;
+
+    EXPECT_EQ(sqrt(Q16(2.25f)), Q16(1.5f));
+    EXPECT_EQ(sqrt(Q16(16384.0f)), Q16(128.0f));
+    EXPECT_EQ(sqrt(Q16()), Q16());
+    EXPECT_EQ(sqrt(Q32x32(1e9f)).value, static_cast<int64_t>(std::llround(std::ldexp(std::sqrt(1e9), 32))));
+
+    // Where the iterations would only come close, as truncation would show
+    EXPECT_EQ(sin(Q16()), Q16());
+    EXPECT_EQ(cos(Q16()), Q16(1.0f));
+    EXPECT_EQ(exp(Q16()), Q16(1.0f));
+    EXPECT_EQ(log2(Q16(1.0f)), Q16());
+    EXPECT_EQ(log2(Q16(8.0f)), Q16(3.0f));
+    EXPECT_EQ(log2(Q16(0.25f)), Q16(-2.0f));
+    EXPECT_EQ(log2(Q16::fromRaw(1)), Q16(-16.0f));
+    EXPECT_EQ(atan2(Q16(), Q16(2.0f)), Q16());
+    EXPECT_EQ(atan2(Q16(), Q16()), Q16());
+
+    // Half and quarter turns, truncated
+    EXPECT_EQ(atan2(Q16(), Q16(-2.0f)).value, 205887);  // pi
+    EXPECT_EQ(atan2(Q16(3.0f), Q16()).value, 102943);   // pi/2
+    EXPECT_EQ(atan2(Q16(-3.0f), Q16()).value, -102944); // -pi/2
+    EXPECT_EQ(atan2(Q16(-1.0f), Q16(-1.0f)).value, -154416);
+
+    // Large arguments are reduced exactly, 2^30 radians
+    EXPECT_EQ(sin(Q32x32(1073741824.0f)).value,
+              static_cast<int64_t>(std::llround(std::ldexp(std::sin(1073741824.0L), 32))));
+}
+
+TEST(FixedPointMathTest, DomainAndRange)
+{
+    using namespace fixed_point_math;
+    using Sat = FixedPoint<16, int32_t, Overflow::Saturate>;
+    using SatQ15 = FixedPoint<15, int16_t, Overflow::Saturate, Rounding::Nearest>;
+    using Trap = FixedPoint<16, int32_t, Overflow::Trap>;
+    using Trap64 = FixedPoint<32, int64_t, Overflow::Trap>;
+    using Sat64 = FixedPoint<32, int64_t, Overflow::Saturate>;
+
+    EXPECT_EQ(sqrt(Sat(-1.0f)), Sat());
+    EXPECT_EQ(log2(Sat()), Sat::minValue());
+    EXPECT_EQ(log2(Sat(-4.0f)), Sat::minValue());
+
+    EXPECT_EQ(exp(Sat(11.0f)), Sat::maxValue());
+    EXPECT_EQ(exp(Sat::maxValue()), Sat::maxValue());
+    EXPECT_EQ(exp(Sat(-12.0f)), Sat());
+    EXPECT_EQ(exp(Sat::minValue()), Sat());
+    EXPECT_EQ(cos(SatQ15()), SatQ15::maxValue());
+    EXPECT_EQ(atan2(SatQ15(0.5f), SatQ15(-0.5f)), SatQ15::maxValue());
+
+    EXPECT_DEATH(sqrt(Trap(-1.0f)), ".*");
+    EXPECT_DEATH(log2(Trap()), ".*");
+    EXPECT_DEATH(exp(Trap(11.0f)), ".*");
+    EXPECT_EQ(exp(Trap(10.0f)).value, 1443526462); // e^10 = 22026.4658
+
+    // The 64-bit intermediate has the format of the result, the policy still applies
+    EXPECT_DEATH(exp(Trap64(21.5f)), ".*");
+    EXPECT_DEATH(exp(Trap64(22.0f)), ".*");
+    EXPECT_DEATH(exp(Trap64(100.0f)), ".*");
+    EXPECT_EQ(exp(Sat64(22.0f)), Sat64::maxValue());
+    EXPECT_LT(exp(Trap64(21.0f)), Trap64::maxValue()); // e^21 = 1318815734.5
+}
+
+// 3. Compile-time checks - every function is constexpr
+namespace
+{
+static_assert(fixed_point_math::sqrt(Q16(2.25f)) == Q16(1.5f));
+static_assert(fixed_point_math::cos(Q16()) == Q16(1.0f));
+static_assert(fixed_point_math::sin(Q16(0.5f)) == Q16::fromRaw(31419)); // 0.479425
+static_assert(fixed_point_math::atan2(Q16(1.0f), Q16(1.0f)) == Q16::fromRaw(51471)); // pi/4
+static_assert(fixed_point_math::exp(Q16(1.0f)) == Q16::fromRaw(178145)); // e
+static_assert(fixed_point_math::log2(Q16(10.0f)) == Q16::fromRaw(217705)); // 3.321928
+} // namespace
+
+// 4. Array versions against the scalar functions
+TEST(FixedPointMathTest, ArraysMatchScalars)
+{
+    const auto x = arguments<Q32x32>();
+    std::vector<Q32x32> y(x.rbegin(), x.rend());
+    std::vector<Q32x32> out(x.size());
+
+    fixed_point_math::sqrt(x.data(), out.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(out[i], fixed_point_math::sqrt(x[i])) << i;
+    fixed_point_math::sin(x.data(), out.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(out[i], fixed_point_math::sin(x[i])) << i;
+    fixed_point_math::cos(x.data(), out.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(out[i], fixed_point_math::cos(x[i])) << i;
+    fixed_point_math::atan2(y.data(), x.data(), out.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(out[i], fixed_point_math::atan2(y[i], x[i])) << i;
+    fixed_point_math::exp(x.data(), out.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(out[i], fixed_point_math::exp(x[i])) << i;
+
+    // In place
+    out = x;
+    fixed_point_math::log2(out.data(), out.data(), out.size());
+    for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(out[i], fixed_point_math::log2(x[i])) << i;
+}
+
+TEST(FixedPointMathTest, CordicKernelsMatchScalar)
+{
+    using namespace fixed_point_math::detail;
+    std::mt19937_64 rng(25);
+    // Where the functions start, x in [1/4, 1/2) and |y| well below it so that x
+    // stays positive, |z| below 1/4, and a length with a tail
+    const size_t n = 1003;
+    std::vector<int64_t> x(n), y(n), z(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = static_cast<int64_t>((rng() >> 5) | (uint64_t(1) << 59));
+        y[i] = static_cast<int64_t>(rng()) >> 6;
+        z[i] = static_cast<int64_t>(rng()) >> 4;
+    }
+    for (const Schedule *schedule : {&circular, &hyperbolic})
+    {
+        for (bool vectoring : {false, true})
+        {
+            const fixed_point_detail::CordicSteps steps = {schedule->shifts, schedule->angles, schedule->size,
+                                                           schedule->hyperbolic, vectoring};
+            auto expected_x = x, expected_y = y, expected_z = z;
+            fixed_point_detail::cordic_scalar(expected_x.data(), expected_y.data(), expected_z.data(), n, steps);
+            for (size_t i = 0; i < 5; ++i)
+            {
+                int64_t one_x = x[i], one_y = y[i], one_z = z[i];
+                cordic(one_x, one_y, one_z, *schedule, schedule->size, vectoring);
+                EXPECT_EQ(one_x, expected_x[i]);
+                EXPECT_EQ(one_y, expected_y[i]);
+                EXPECT_EQ(one_z, expected_z[i]);
+            }
+#if FIXED_POINT_HAS_SIMD
+            if (fixed_point_detail::cpu_has_avx2())
+            {
+                auto actual_x = x, actual_y = y, actual_z = z;
+                fixed_point_detail::cordic_avx2(actual_x.data(), actual_y.data(), actual_z.data(), n, steps);
+                EXPECT_EQ(actual_x, expected_x) << schedule->hyperbolic << vectoring;
+                EXPECT_EQ(actual_y, expected_y) << schedule->hyperbolic << vectoring;
+                EXPECT_EQ(actual_z, expected_z) << schedule->hyperbolic << vectoring;
+            }
+#endif
+        }
+    }
+}
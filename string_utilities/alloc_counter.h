@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Counts heap allocations by replacing the global operator new.
+// Include in exactly one translation unit per executable.
+// Used by string_test and by the string_bench allocation counters.
+namespace alloc_counter {
+
+// Atomic so threads started by the code under test can be counted as well
+inline std::atomic<size_t> allocations{0};
+inline std::atomic<size_t> live_bytes{0};
+
+// Every block is preceded by its size and by the distance back to the start of
+// the malloc block, padded so the user part stays max aligned
+constexpr size_t header = alignof(std::max_align_t);
+static_assert(header >= 2 * sizeof(size_t), "header must hold the size and the offset");
+
+// Number of allocations performed and net bytes kept since construction
+class Scope {
+public:
+    Scope() : m_start{allocations}, m_start_bytes{live_bytes} {}
+    size_t count() const { return allocations - m_start; }
+    long long bytes() const { return static_cast<long long>(live_bytes - m_start_bytes); }
+
+private:
+    size_t m_start;
+    size_t m_start_bytes;
+};
+
+namespace detail {
+
+// Shared by every form of operator new, returns nullptr when malloc fails
+inline void* allocate(std::size_t size, std::size_t align) noexcept {
+    if (align < header) align = header;
+    if (size > SIZE_MAX - align) return nullptr;
+    // malloc returns max aligned blocks, so rounding up leaves at least header
+    // bytes in front of the user part and never more than align
+    char* block = static_cast<char*>(std::malloc(size + align));
+    if (!block) return nullptr;
+    ++allocations;
+    live_bytes += size;
+    char* p = block + align - reinterpret_cast<std::uintptr_t>(block) % align;
+    std::size_t* words = reinterpret_cast<std::size_t*>(p) - 2;
+    words[0] = size;
+    words[1] = static_cast<std::size_t>(p - block);
+    return p;
+}
+
+// Shared by every form of operator delete
+inline void deallocate(void* p) noexcept {
+    if (!p) return;
+    const std::size_t* words = static_cast<const std::size_t*>(p) - 2;
+    live_bytes -= words[0];
+    std::free(static_cast<char*>(p) - words[1]);
+}
+
+inline void* allocate_or_throw(std::size_t size, std::size_t align) {
+    if (void* p = allocate(size, align)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace detail
+
+} // namespace alloc_counter
+
+// Every replaceable form is defined, so no block from the library's own
+// operator new ever reaches the replaced operator delete
+
+void* operator new(std::size_t size) {
+    return alloc_counter::detail::allocate_or_throw(size, 0);
+}
+
+void* operator new[](std::size_t size) {
+    return alloc_counter::detail::allocate_or_throw(size, 0);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return alloc_counter::detail::allocate(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return alloc_counter::detail::allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return alloc_counter::detail::allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return alloc_counter::detail::allocate_or_throw(size, static_cast<std::size_t>(align));
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return alloc_counter::detail::allocate(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return alloc_counter::detail::allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* p) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    alloc_counter::detail::deallocate(p);
+}
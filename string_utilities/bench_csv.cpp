@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "csv.h"
+#include "line_reader.h"
+#include "string_utilities.h"
+
+namespace {
+
+// Rows of eight short fields. The quoted variant wraps every fourth field in quotes,
+// with a delimiter in it and every other one with a doubled quote as well.
+const std::string& rows(size_t size, bool quoted) {
+    static std::vector<std::pair<std::pair<size_t, bool>, std::string>> cache;
+    for (const auto& entry : cache) {
+        if (entry.first == std::make_pair(size, quoted)) return entry.second;
+    }
+
+    std::mt19937 rng(4180);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> length(1, 12);
+
+    std::string text;
+    for (size_t field = 0; text.size() < size; ++field) {
+        std::string value(length(rng), ' ');
+        for (auto& ch : value) ch = static_cast<char>(letter(rng));
+        if (quoted && field % 4 == 1) {
+            text += field % 8 == 1 ? "\"" + value + ", \"\"" + value + "\"\"\"" : "\"" + value + ",\"";
+        } else {
+            text += value;
+        }
+        text += field % 8 == 7 ? '\n' : ',';
+    }
+
+    cache.emplace_back(std::make_pair(size, quoted), std::move(text));
+    return cache.back().second;
+}
+
+void BM_CsvReader(benchmark::State& state) {
+    const std::string& text = rows(static_cast<size_t>(state.range(0)), state.range(1) != 0);
+    std::vector<std::string_view> fields;
+    for (auto _ : state) {
+        string_utils::csv::Reader reader(text);
+        size_t count = 0;
+        while (reader.next(fields)) count += fields.size();
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// The same unquoted rows through FieldReader, which splits lines with split_view()
+void BM_FieldReaderSplit(benchmark::State& state) {
+    const std::string& text = rows(static_cast<size_t>(state.range(0)), false);
+    std::vector<std::string_view> fields;
+    for (auto _ : state) {
+        string_utils::FieldReader reader(text, ',');
+        size_t count = 0;
+        while (reader.next(fields)) count += fields.size();
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// And through split() on every line, copying every field
+void BM_SplitLines(benchmark::State& state) {
+    const std::string& text = rows(static_cast<size_t>(state.range(0)), false);
+    for (auto _ : state) {
+        size_t count = 0;
+        for (std::string_view line : string_utils::split_view(text, '\n')) {
+            count += string_utils::split(std::string(line), ',').size();
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_CsvReader)->ArgNames({"bytes", "quoted"})->ArgsProduct({{4096, 1 << 20, 16 << 20}, {0, 1}});
+BENCHMARK(BM_FieldReaderSplit)->ArgName("bytes")->Arg(4096)->Arg(1 << 20)->Arg(16 << 20);
+BENCHMARK(BM_SplitLines)->ArgName("bytes")->Arg(4096)->Arg(1 << 20)->Arg(16 << 20);
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "multi_matcher.h"
+#include "string_utilities.h"
+
+namespace {
+
+// Lowercase words of 4 to 12 letters, the text mixes them into random filler
+// so every benchmark sees a realistic share of hits
+struct Corpus {
+    std::vector<std::string> words;
+    std::vector<std::string_view> patterns;
+    std::string text;
+};
+
+const Corpus& corpus(size_t pattern_count) {
+    static std::vector<std::pair<size_t, Corpus>> cache;
+    for (const auto& entry : cache) {
+        if (entry.first == pattern_count) return entry.second;
+    }
+
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> length(4, 12);
+
+    Corpus c;
+    for (size_t i = 0; i < pattern_count; ++i) {
+        std::string word(length(rng), ' ');
+        for (auto& ch : word) ch = static_cast<char>(letter(rng));
+        c.words.push_back(word);
+    }
+
+    std::uniform_int_distribution<size_t> pick(0, pattern_count - 1);
+    while (c.text.size() < 256 * 1024) {
+        c.text += c.words[pick(rng)];
+        for (size_t i = length(rng); i > 0; --i) c.text += static_cast<char>(letter(rng));
+        c.text += ' ';
+    }
+
+    cache.emplace_back(pattern_count, std::move(c));
+    Corpus& stored = cache.back().second;
+    stored.patterns.assign(stored.words.begin(), stored.words.end());
+    return stored;
+}
+
+void BM_MultiMatcherFindAll(benchmark::State& state) {
+    const Corpus& c = corpus(static_cast<size_t>(state.range(0)));
+    string_utils::MultiMatcher matcher(c.patterns);
+
+    for (auto _ : state) {
+        auto matches = matcher.find_all(c.text);
+        benchmark::DoNotOptimize(matches.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * c.text.size()));
+}
+
+void BM_RepeatedFindAll(benchmark::State& state) {
+    const Corpus& c = corpus(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (auto pattern : c.patterns) {
+            hits += string_utils::find_all(c.text, pattern).size();
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * c.text.size()));
+}
+
+void BM_MultiMatcherBuild(benchmark::State& state) {
+    const Corpus& c = corpus(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        string_utils::MultiMatcher matcher(c.patterns);
+        benchmark::DoNotOptimize(&matcher);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_MultiMatcherFindAll)->Arg(10)->Arg(100)->Arg(10000);
+BENCHMARK(BM_RepeatedFindAll)->Arg(10)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MultiMatcherBuild)->Arg(10)->Arg(100)->Arg(10000);
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include "parallel.h"
+#include "string_utilities.h"
+
+namespace {
+
+// 1GB of comma separated lines of random words, built once and shared
+const std::string& gigabyte() {
+    static const std::string text = [] {
+        constexpr size_t size = size_t{1} << 30;
+        std::mt19937 rng(2024);
+        std::uniform_int_distribution<int> letter('a', 'z');
+        std::uniform_int_distribution<int> length(2, 14);
+
+        std::string line;
+        for (int field = 0; field < 8; ++field) {
+            for (int i = length(rng); i > 0; --i) line += static_cast<char>(letter(rng));
+            line += field == 7 ? '\n' : ',';
+        }
+        // Repeat a handful of different lines, random generation of the whole
+        // gigabyte would dominate the benchmark start-up
+        std::string block;
+        while (block.size() < 1024 * 1024) {
+            for (auto& ch : line) {
+                if (ch != ',' && ch != '\n') ch = static_cast<char>(letter(rng));
+            }
+            block += line;
+        }
+        std::string out;
+        out.reserve(size);
+        while (out.size() + block.size() <= size) out += block;
+        return out;
+    }();
+    return text;
+}
+
+// Threads from 1 up to the hardware thread count, doubling
+void thread_counts(benchmark::internal::Benchmark* bench) {
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads < cores; threads *= 2) bench->Arg(threads);
+    bench->Arg(cores);
+}
+
+void BM_ParallelSplit(benchmark::State& state) {
+    const std::string& text = gigabyte();
+    string_utils::ThreadPool pool(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto lines = string_utils::parallel_split(text, '\n', pool);
+        benchmark::DoNotOptimize(lines.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void BM_ParallelCount(benchmark::State& state) {
+    const std::string& text = gigabyte();
+    string_utils::ThreadPool pool(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(string_utils::parallel_count_occurrences(text, "abc", pool));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_ParallelSplit)->Apply(thread_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ParallelCount)->Apply(thread_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
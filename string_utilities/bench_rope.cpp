@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "rope.h"
+#include "string_utilities.h"
+
+namespace {
+
+constexpr int placeholders = 50;
+
+// A templated document of about size bytes: paragraphs of filler with one of the
+// placeholders {{field0}} to {{field49}} in each
+const std::string& document(size_t size) {
+    static std::vector<std::pair<size_t, std::string>> cache;
+    for (const auto& entry : cache) {
+        if (entry.first == size) return entry.second;
+    }
+
+    std::string text;
+    for (int paragraph = 0; text.size() < size; ++paragraph) {
+        text += "<p>Lorem ipsum dolor sit amet, consectetur adipiscing elit, value {{field";
+        text += std::to_string(paragraph % placeholders);
+        text += "}} sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.</p>\n";
+    }
+    cache.emplace_back(size, std::move(text));
+    return cache.back().second;
+}
+
+const std::vector<std::pair<std::string, std::string>>& fields() {
+    static const std::vector<std::pair<std::string, std::string>> result = [] {
+        std::vector<std::pair<std::string, std::string>> f;
+        for (int i = 0; i < placeholders; ++i) {
+            f.emplace_back("{{field" + std::to_string(i) + "}}", "value number " + std::to_string(i * 7919));
+        }
+        return f;
+    }();
+    return result;
+}
+
+// Every placeholder filled in by its own replace_all(), each copying the document
+void BM_TemplateString(benchmark::State& state) {
+    const std::string& text = document(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::string result = text;
+        for (const auto& [from, to] : fields()) result = string_utils::replace_all(result, from, to);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// The same calls on a Rope, flattened once at the end
+void BM_TemplateRope(benchmark::State& state) {
+    const std::string& text = document(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        string_utils::Rope rope(text);
+        for (const auto& [from, to] : fields()) string_utils::replace_all(rope, from, to);
+        std::string result = rope.str();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// The single pass multi-pattern replace_all(), for reference
+void BM_TemplateSinglePass(benchmark::State& state) {
+    const std::string& text = document(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::string result = string_utils::replace_all(text, fields());
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// range(1) short insertions at random positions
+std::vector<size_t> insert_positions(size_t size, size_t count) {
+    std::mt19937 rng(20);
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < count; ++i) positions.push_back(std::uniform_int_distribution<size_t>(0, size + i * 5)(rng));
+    return positions;
+}
+
+void BM_RandomInsertsString(benchmark::State& state) {
+    const std::string& text = document(static_cast<size_t>(state.range(0)));
+    auto positions = insert_positions(text.size(), static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        std::string result = text;
+        for (size_t pos : positions) result.insert(pos, "12345");
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * positions.size()));
+}
+
+void BM_RandomInsertsRope(benchmark::State& state) {
+    const std::string& text = document(static_cast<size_t>(state.range(0)));
+    auto positions = insert_positions(text.size(), static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        string_utils::Rope rope(text);
+        for (size_t pos : positions) rope.insert(pos, "12345");
+        std::string result = rope.str();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * positions.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_TemplateString)->ArgName("bytes")->Arg(64 << 10)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TemplateRope)->ArgName("bytes")->Arg(64 << 10)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TemplateSinglePass)->ArgName("bytes")->Arg(64 << 10)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RandomInsertsString)->ArgNames({"bytes", "edits"})->Args({1 << 20, 10000})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RandomInsertsRope)->ArgNames({"bytes", "edits"})->Args({1 << 20, 10000})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "similarity.h"
+
+namespace {
+
+// Log lines of 80 to 200 bytes built from a few templates, where every other line
+// is a copy of the previous one with a handful of bytes changed, the near
+// duplicates a deduplication pass is looking for
+const std::vector<std::string>& log_lines() {
+    static const std::vector<std::string> lines = [] {
+        std::mt19937 rng(19);
+        std::uniform_int_distribution<int> digit('0', '9');
+        std::uniform_int_distribution<int> letter('a', 'z');
+        const std::vector<std::string> templates = {
+            "2026-10-17T08:15:##.###Z INFO  [worker-##] GET /api/v1/users/#### 200 in ##ms",
+            "2026-10-17T08:15:##.###Z WARN  [pool-#] connection reset by peer 10.0.#.##:5432, retrying in ###ms "
+            "(attempt # of 5)",
+            "2026-10-17T08:15:##.###Z ERROR [scheduler] job ######## failed: timeout after ####ms waiting for "
+            "lock 'orders/####', owner worker-## last seen ###ms ago",
+            "2026-10-17T08:15:##.###Z DEBUG [cache] evicted ### entries from shard ## (size ####KB, hit rate 0.##), "
+            "next compaction in ##s, pending writes ####, queue depth ##"};
+
+        std::vector<std::string> result;
+        for (size_t i = 0; i < 4096; ++i) {
+            std::string line = templates[i % templates.size()];
+            for (auto& ch : line) {
+                if (ch == '#') ch = static_cast<char>(digit(rng));
+            }
+            result.push_back(line);
+
+            // Near duplicate: a few substitutions, an insertion and a deletion
+            for (int e = 0; e < 4; ++e) {
+                line[std::uniform_int_distribution<size_t>(0, line.size() - 1)(rng)] = static_cast<char>(letter(rng));
+            }
+            line.insert(line.begin() + static_cast<std::ptrdiff_t>(line.size() / 2), static_cast<char>(letter(rng)));
+            line.erase(line.size() / 3, 1);
+            result.push_back(line);
+        }
+        return result;
+    }();
+    return lines;
+}
+
+// 1M index pairs into log_lines(), half of them a line and its near duplicate and
+// half of them two unrelated lines
+const std::vector<std::pair<uint32_t, uint32_t>>& pairs() {
+    static const std::vector<std::pair<uint32_t, uint32_t>> result = [] {
+        const uint32_t count = static_cast<uint32_t>(log_lines().size());
+        std::mt19937 rng(2019);
+        std::uniform_int_distribution<uint32_t> pick(0, count - 1);
+        std::vector<std::pair<uint32_t, uint32_t>> p;
+        p.reserve(1 << 20);
+        for (size_t i = 0; i < (1 << 20); ++i) {
+            uint32_t a = pick(rng) & ~1u;
+            p.emplace_back(a, i % 2 ? a + 1 : pick(rng));
+        }
+        return p;
+    }();
+    return result;
+}
+
+// The textbook dynamic programming the bit-parallel version replaces
+size_t dp_levenshtein(std::string_view a, std::string_view b, std::vector<size_t>& row) {
+    row.resize(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = j;
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+// The first range(0) pairs
+void BM_Levenshtein(benchmark::State& state) {
+    const auto& lines = log_lines();
+    const size_t count = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += string_utils::levenshtein(lines[pairs()[i].first], lines[pairs()[i].second]);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+void BM_LevenshteinDP(benchmark::State& state) {
+    const auto& lines = log_lines();
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<size_t> row;
+    for (auto _ : state) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += dp_levenshtein(lines[pairs()[i].first], lines[pairs()[i].second], row);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// Distance capped at range(1), the threshold of a deduplication pass
+void BM_LevenshteinBounded(benchmark::State& state) {
+    const auto& lines = log_lines();
+    const size_t count = static_cast<size_t>(state.range(0));
+    const size_t max = static_cast<size_t>(state.range(1));
+    for (auto _ : state) {
+        size_t similar = 0;
+        for (size_t i = 0; i < count; ++i) {
+            similar += string_utils::levenshtein_bounded(lines[pairs()[i].first], lines[pairs()[i].second], max) <= max;
+        }
+        benchmark::DoNotOptimize(similar);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// range(0) signatures of range(1) hashes each
+void BM_MinHashSignature(benchmark::State& state) {
+    const auto& lines = log_lines();
+    const size_t count = static_cast<size_t>(state.range(0));
+    string_utils::MinHasher hasher(static_cast<size_t>(state.range(1)));
+    std::vector<uint64_t> signature;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            hasher.signature(lines[i % lines.size()], signature);
+            benchmark::DoNotOptimize(signature.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// Comparing precomputed signatures of range(1) hashes for the first range(0) pairs
+void BM_MinHashSimilarity(benchmark::State& state) {
+    const auto& lines = log_lines();
+    const size_t count = static_cast<size_t>(state.range(0));
+    string_utils::MinHasher hasher(static_cast<size_t>(state.range(1)));
+    std::vector<std::vector<uint64_t>> signatures;
+    for (const auto& line : lines) signatures.push_back(hasher.signature(line));
+    for (auto _ : state) {
+        double total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += string_utils::MinHasher::similarity(signatures[pairs()[i].first], signatures[pairs()[i].second]);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+} // namespace
+
+BENCHMARK(BM_Levenshtein)->ArgName("pairs")->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+// The quadratic baseline gets fewer pairs, compare items per second
+BENCHMARK(BM_LevenshteinDP)->ArgName("pairs")->Arg(1 << 14)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LevenshteinBounded)
+    ->ArgNames({"pairs", "max"})
+    ->Args({1 << 20, 8})
+    ->Args({1 << 20, 32})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MinHashSignature)->ArgNames({"lines", "hashes"})->Args({1 << 16, 64})->Args({1 << 16, 128})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MinHashSimilarity)->ArgNames({"pairs", "hashes"})->Args({1 << 20, 64})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,711 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+#include "alloc_counter.h"
+#include "case_insensitive.h"
+#include "intern_pool.h"
+#include "line_reader.h"
+#include "mapped_file.h"
+#include "numeric_parse.h"
+#include "searcher.h"
+#include "split_result.h"
+#include "string_utilities.h"
+#include "utf8.h"
+
+// Benchmarks for the whole public string_utils API. Every benchmark takes the input
+// size, the corpus and, where it matters, how often the searched token occurs:
+//   args = {bytes, corpus, hits per 1000 bytes}
+// and reports bytes/s plus the heap allocations per iteration.
+namespace {
+
+enum Corpus { Ascii = 0, Mixed = 1, Utf8 = 2 };
+
+// The token that search, split and replace benchmarks look for. Neither its bytes
+// nor the delimiter ever occur in the filler, so the hit ratio is exact.
+constexpr std::string_view needle = "zz,";
+
+// Inputs built once per argument set. Inputs of 1MB and more are only kept until
+// another one is asked for: all the 16MB and 64MB ones together would hold about
+// 1GB for the whole run. Benchmarks ask for one input per run, so each large input
+// is built once per benchmark instead of once per run of the binary.
+template <typename Key>
+class InputCache {
+public:
+    template <typename Build>
+    const std::string& get(const Key& key, size_t size, Build&& build) {
+        if (size < large) {
+            auto it = m_small.find(key);
+            if (it == m_small.end()) it = m_small.emplace(key, build()).first;
+            return it->second;
+        }
+        if (!m_has_large || m_large_key != key) {
+            m_large = std::string(); // freed before the next one is built
+            m_large = build();
+            m_large_key = key;
+            m_has_large = true;
+        }
+        return m_large;
+    }
+
+private:
+    static constexpr size_t large = 1 << 20;
+
+    std::map<Key, std::string> m_small;
+    Key m_large_key{};
+    std::string m_large;
+    bool m_has_large = false;
+};
+
+// Lowercase words and spaces, or for the mixed corpus the same with every other
+// byte taken from 0x80-0xFF. The UTF-8 corpus is valid, mostly ASCII text with
+// a two or three byte character in every hundred bytes, about as many as in
+// Western European prose.
+const std::string& text(size_t size, int corpus, int hits) {
+    static InputCache<std::tuple<size_t, int, int>> cache;
+    return cache.get({size, corpus, hits}, size, [&] {
+        std::mt19937 rng(static_cast<unsigned>(size) ^ static_cast<unsigned>(corpus * 31 + hits));
+        std::uniform_int_distribution<int> letter('a', 'y');
+        std::uniform_int_distribution<int> high(0x80, 0xFF);
+        std::uniform_int_distribution<int> per_mille(0, 999);
+
+        std::string out;
+        out.reserve(size + needle.size());
+        while (out.size() < size) {
+            if (hits > 0 && per_mille(rng) < hits) {
+                out += needle;
+            } else if (out.size() % 8 == 7) {
+                out += ' ';
+            } else if (corpus == Utf8 && out.size() % 100 == 3) {
+                out += out.size() % 200 == 3 ? "\xC3\x89" : "\xE2\x82\xAC"; // É and €
+            } else if (corpus == Mixed && out.size() % 2 == 1) {
+                out += static_cast<char>(high(rng));
+            } else {
+                out += static_cast<char>(letter(rng));
+            }
+        }
+        out.resize(size);
+        return out;
+    });
+}
+
+const std::string& text(const benchmark::State& state) {
+    return text(static_cast<size_t>(state.range(0)), static_cast<int>(state.range(1)),
+                static_cast<int>(state.range(2)));
+}
+
+// Strings made of a single repeated byte, so the predicates scan all of them
+const std::string& uniform(size_t size, char ch) {
+    static InputCache<std::pair<size_t, char>> cache;
+    return cache.get({size, ch}, size, [&] { return std::string(size, ch); });
+}
+
+// Runs body once per iteration and records throughput and allocations. Inputs
+// must be built before the call so their allocations are not counted.
+template <typename Body>
+void measure(benchmark::State& state, size_t bytes, Body&& body) {
+    alloc_counter::Scope allocations;
+    for (auto _ : state) {
+        body();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations.count()),
+                                                  benchmark::Counter::kAvgIterations);
+}
+
+// 16B, 256B, 4KB, 64KB, 1MB, 16MB and 64MB
+void sizes(benchmark::internal::Benchmark* bench, const std::vector<int>& corpora, const std::vector<int>& hits) {
+    bench->ArgNames({"bytes", "corpus", "hits"});
+    for (int64_t size = 16; size <= 64 << 20; size = size == 16 << 20 ? 64 << 20 : size * 16) {
+        for (int corpus : corpora) {
+            for (int hit : hits) bench->Args({size, corpus, hit});
+        }
+    }
+}
+
+// Inputs where the hit ratio does not matter
+void corpora(benchmark::internal::Benchmark* bench) {
+    sizes(bench, {Ascii, Mixed}, {0});
+}
+
+// Searching inputs: no hits, a sparse 1 per 1000 bytes and a dense 50 per 1000
+void corpora_and_hits(benchmark::internal::Benchmark* bench) {
+    sizes(bench, {Ascii, Mixed}, {0, 1, 50});
+}
+
+// ASCII against ASCII-dominant UTF-8, for the UTF-8 aware functions
+void utf8_corpora(benchmark::internal::Benchmark* bench) {
+    sizes(bench, {Ascii, Utf8}, {0});
+}
+
+// Predicates always see a matching input, they only differ in size
+void plain(benchmark::internal::Benchmark* bench) {
+    sizes(bench, {Ascii}, {0});
+}
+
+void BM_ToUpper(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::to_upper(str)); });
+}
+
+void BM_ToLower(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::to_lower(str)); });
+}
+
+void BM_ToUpperInplace(benchmark::State& state) {
+    std::string str = text(state);
+    measure(state, str.size(), [&] {
+        string_utils::to_upper_inplace(str);
+        benchmark::DoNotOptimize(str.data());
+    });
+}
+
+void BM_ToLowerInplace(benchmark::State& state) {
+    std::string str = text(state);
+    measure(state, str.size(), [&] {
+        string_utils::to_lower_inplace(str);
+        benchmark::DoNotOptimize(str.data());
+    });
+}
+
+void BM_Utf8ToLower(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::utf8_to_lower(str)); });
+}
+
+void BM_Utf8ToUpper(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::utf8_to_upper(str)); });
+}
+
+void BM_Utf8FoldCase(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::utf8_fold_case(str)); });
+}
+
+void BM_IsValidUtf8(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::is_valid_utf8(str)); });
+}
+
+// Letters only, so the whole input is classified
+void BM_Utf8IsAlpha(benchmark::State& state) {
+    std::string str = text(state);
+    for (char& c : str) {
+        if (c == ' ') c = 'q';
+    }
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::utf8_is_alpha(str)); });
+}
+
+// Whitespace padding on both sides so trimming has something to remove
+const std::string& padded(const benchmark::State& state) {
+    static InputCache<std::tuple<int64_t, int64_t, int64_t>> cache;
+    const std::string& str = text(state);
+    return cache.get({state.range(0), state.range(1), state.range(2)}, str.size(),
+                     [&] { return " \t\n" + str + "\r\n "; });
+}
+
+void BM_Trim(benchmark::State& state) {
+    const std::string& str = padded(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::trim(str)); });
+}
+
+void BM_TrimLeft(benchmark::State& state) {
+    const std::string& str = padded(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::trim_left(str)); });
+}
+
+void BM_TrimRight(benchmark::State& state) {
+    const std::string& str = padded(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::trim_right(str)); });
+}
+
+void BM_TrimView(benchmark::State& state) {
+    const std::string& str = padded(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::trim_view(str)); });
+}
+
+void BM_TrimLeftView(benchmark::State& state) {
+    const std::string& str = padded(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::trim_left_view(str)); });
+}
+
+void BM_TrimRightView(benchmark::State& state) {
+    const std::string& str = padded(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::trim_right_view(str)); });
+}
+
+void BM_TrimInplace(benchmark::State& state) {
+    const std::string& str = padded(state);
+    std::string buffer = str;
+    measure(state, str.size(), [&] {
+        buffer.assign(str); // reuses the capacity, so no allocation
+        string_utils::trim_inplace(buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    });
+}
+
+// The row parsing pattern: every field of the text trimmed
+void BM_TrimFields(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] {
+        size_t length = 0;
+        for (std::string_view field : string_utils::split_view(str, ',')) {
+            length += string_utils::trim_view(field).size();
+        }
+        benchmark::DoNotOptimize(length);
+    });
+}
+
+void BM_SplitChar(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::split(str, ',')); });
+}
+
+void BM_SplitString(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::string delimiter = "z,";
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::split(str, delimiter)); });
+}
+
+// One SplitResult reused across iterations, the steady state of an ingest loop
+void BM_SplitInto(benchmark::State& state) {
+    const std::string& str = text(state);
+    string_utils::SplitResult tokens;
+    string_utils::split_into(tokens, str, ',');
+    measure(state, str.size(), [&] {
+        string_utils::split_into(tokens, str, ',');
+        benchmark::DoNotOptimize(tokens.size());
+    });
+}
+
+void BM_SplitViewChar(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] {
+        size_t tokens = 0;
+        for (std::string_view token : string_utils::split_view(str, ',')) tokens += token.size();
+        benchmark::DoNotOptimize(tokens);
+    });
+}
+
+void BM_SplitViewString(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] {
+        size_t tokens = 0;
+        for (std::string_view token : string_utils::split_view(str, "z,")) tokens += token.size();
+        benchmark::DoNotOptimize(tokens);
+    });
+}
+
+void BM_IsNumeric(benchmark::State& state) {
+    const std::string& str = uniform(static_cast<size_t>(state.range(0)), '7');
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::is_numeric(str)); });
+}
+
+void BM_IsAlpha(benchmark::State& state) {
+    const std::string& str = uniform(static_cast<size_t>(state.range(0)), 'q');
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::is_alpha(str)); });
+}
+
+void BM_IsAlphanumeric(benchmark::State& state) {
+    const std::string& str = uniform(static_cast<size_t>(state.range(0)), 'Q');
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::is_alphanumeric(str)); });
+}
+
+// The prefix and suffix are a quarter of the input, so the comparison is not free
+void BM_StartsWith(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::string prefix = str.substr(0, str.size() / 4);
+    measure(state, prefix.size(), [&] { benchmark::DoNotOptimize(string_utils::starts_with(str, prefix)); });
+}
+
+void BM_EndsWith(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::string suffix = str.substr(str.size() - str.size() / 4);
+    measure(state, suffix.size(), [&] { benchmark::DoNotOptimize(string_utils::ends_with(str, suffix)); });
+}
+
+void BM_ReplaceAll(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::string from = "zz";
+    const std::string to = "ZZZ";
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::replace_all(str, from, to)); });
+}
+
+void BM_ReplaceFirst(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::string from = "zz";
+    const std::string to = "ZZZ";
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::replace_first(str, from, to)); });
+}
+
+void BM_ReplaceAllMulti(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::vector<std::pair<std::string, std::string>> replacements = {
+        {"zz", "Z"}, {"z,", ";"}, {"zzz", "!"}, {"qqqq", "?"}};
+    measure(state, str.size(), [&] {
+        benchmark::DoNotOptimize(string_utils::replace_all(std::string_view(str), replacements));
+    });
+}
+
+void BM_Join(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::vector<std::string> tokens = string_utils::split(str, ',');
+    const std::string delimiter = ",";
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::join(tokens, delimiter)); });
+}
+
+// join_into() into a buffer that is reused, after the first iteration nothing allocates
+void BM_JoinInto(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::vector<std::string_view> tokens(string_utils::split_view(str, ',').begin(),
+                                               string_utils::split_view(str, ',').end());
+    std::string out;
+    out.reserve(str.size());
+    measure(state, str.size(), [&] {
+        out.clear();
+        string_utils::join_into(out, tokens, ",");
+        benchmark::DoNotOptimize(out.data());
+    });
+}
+
+void BM_FindAll(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::find_all(str, needle)); });
+}
+
+// Case-insensitive search against the two to_lower() copies it replaces
+void BM_IFindAll(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::ifind_all(str, "ZZ,")); });
+}
+
+void BM_LowerThenFindAll(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] {
+        benchmark::DoNotOptimize(string_utils::find_all(string_utils::to_lower(str), string_utils::to_lower("ZZ,")));
+    });
+}
+
+void BM_IEquals(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::string upper = string_utils::to_upper(str);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::iequals(str, upper)); });
+}
+
+void BM_IStartsWith(benchmark::State& state) {
+    const std::string& str = text(state);
+    const std::string prefix = string_utils::to_upper(str.substr(0, str.size() / 4));
+    measure(state, prefix.size(), [&] { benchmark::DoNotOptimize(string_utils::istarts_with(str, prefix)); });
+}
+
+void BM_CountOccurrences(benchmark::State& state) {
+    const std::string& str = text(state);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(string_utils::count_occurrences(str, needle)); });
+}
+
+void BM_SearcherCount(benchmark::State& state) {
+    const std::string& str = text(state);
+    const string_utils::Searcher searcher(needle);
+    measure(state, str.size(), [&] { benchmark::DoNotOptimize(searcher.count(str)); });
+}
+
+// Comma separated decimals, or integers, of about the given size
+const std::string& numbers(size_t size, bool integers) {
+    static InputCache<std::pair<size_t, bool>> cache;
+    return cache.get({size, integers}, size, [&] {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> value(-1e6, 1e6);
+        std::string str;
+        while (str.size() < size) {
+            str += integers ? std::to_string(static_cast<long long>(value(rng))) : std::to_string(value(rng));
+            str += ',';
+        }
+        str.resize(size);
+        while (!str.empty() && (str.back() == ',' || str.back() == '.' || str.back() == '-')) str.pop_back();
+        return str;
+    });
+}
+
+// Comma separated decimals, parsed back into doubles
+void BM_ParseColumn(benchmark::State& state) {
+    const std::string& str = numbers(static_cast<size_t>(state.range(0)), false);
+    std::vector<double> values;
+    string_utils::parse_column(string_utils::split_view(str, ','), values);
+    measure(state, str.size(), [&] {
+        values.clear();
+        benchmark::DoNotOptimize(string_utils::parse_column(string_utils::split_view(str, ','), values));
+    });
+}
+
+// Single values, one call per field of the column
+void BM_ParseInt(benchmark::State& state) {
+    const std::string& str = numbers(static_cast<size_t>(state.range(0)), true);
+    const string_utils::SplitView column = string_utils::split_view(str, ',');
+    const std::vector<std::string_view> fields(column.begin(), column.end());
+    measure(state, str.size(), [&] {
+        long long sum = 0;
+        for (std::string_view field : fields) {
+            long long value = 0;
+            string_utils::parse_int(field, value);
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    });
+}
+
+void BM_ParseDouble(benchmark::State& state) {
+    const std::string& str = numbers(static_cast<size_t>(state.range(0)), false);
+    const string_utils::SplitView column = string_utils::split_view(str, ',');
+    const std::vector<std::string_view> fields(column.begin(), column.end());
+    measure(state, str.size(), [&] {
+        double sum = 0;
+        for (std::string_view field : fields) {
+            double value = 0;
+            string_utils::parse_double(field, value);
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    });
+}
+
+// The text with every tenth space turned into a newline, lines of about 80 bytes
+// and ten space separated fields
+const std::string& lines(const benchmark::State& state) {
+    static InputCache<std::tuple<int64_t, int64_t, int64_t>> cache;
+    const std::string& str = text(state);
+    return cache.get({state.range(0), state.range(1), state.range(2)}, str.size(), [&] {
+        std::string out = str;
+        size_t spaces = 0;
+        for (char& c : out) {
+            if (c == ' ' && ++spaces % 10 == 0) c = '\n';
+        }
+        return out;
+    });
+}
+
+// An input written to a temporary file for the benchmark's duration
+class TempFile {
+public:
+    explicit TempFile(const std::string& contents)
+        : m_path((std::filesystem::temp_directory_path() / "string_bench_input.txt").string()) {
+        std::ofstream(m_path, std::ios::binary) << contents;
+    }
+    ~TempFile() { std::remove(m_path.c_str()); }
+
+    const std::string& path() const { return m_path; }
+
+private:
+    std::string m_path;
+};
+
+void BM_LineReader(benchmark::State& state) {
+    const std::string& str = lines(state);
+    measure(state, str.size(), [&] {
+        string_utils::LineReader reader(str);
+        std::string_view line;
+        size_t count = 0;
+        while (reader.next(line)) ++count;
+        benchmark::DoNotOptimize(count);
+    });
+}
+
+void BM_FieldReader(benchmark::State& state) {
+    const std::string& str = lines(state);
+    std::vector<std::string_view> fields;
+    string_utils::FieldReader(str, ' ').next(fields); // grows the vector outside the loop
+    measure(state, str.size(), [&] {
+        string_utils::FieldReader reader(str, ' ');
+        size_t count = 0;
+        while (reader.next(fields)) count += fields.size();
+        benchmark::DoNotOptimize(count);
+    });
+}
+
+// Opening and mapping the file, then reading its lines, from the page cache
+void BM_LineReaderMapped(benchmark::State& state) {
+    const TempFile file(lines(state));
+    measure(state, static_cast<size_t>(state.range(0)), [&] {
+        string_utils::MappedFile mapped(file.path());
+        string_utils::LineReader reader(mapped);
+        std::string_view line;
+        size_t count = 0;
+        while (reader.next(line)) ++count;
+        benchmark::DoNotOptimize(count);
+    });
+}
+
+// Only opening and mapping, the fixed cost a MappedFile adds over a string. It does
+// not grow with the file, so it is reported per open rather than per byte.
+void BM_MappedFileOpen(benchmark::State& state) {
+    const TempFile file(text(state));
+    alloc_counter::Scope allocations;
+    for (auto _ : state) {
+        string_utils::MappedFile mapped(file.path());
+        benchmark::DoNotOptimize(mapped.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations.count()),
+                                                  benchmark::Counter::kAvgIterations);
+}
+
+// Releasing every page and faulting each back in with one read
+void BM_MappedFileRelease(benchmark::State& state) {
+    const TempFile file(text(state));
+    string_utils::MappedFile mapped(file.path());
+    measure(state, mapped.size(), [&] {
+        mapped.release(0, mapped.size());
+        char sum = 0;
+        for (size_t i = 0; i < mapped.size(); i += 4096) sum ^= mapped.data()[i];
+        benchmark::DoNotOptimize(sum);
+    });
+}
+
+// 1M host name tokens drawn from distinct ones, the duplication of a typical log.
+// Locked, the lookup benchmarks call it from every thread.
+const std::vector<std::string>& tokens(size_t distinct) {
+    static std::map<size_t, std::vector<std::string>> cache;
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& out = cache[distinct];
+    if (out.empty()) {
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<size_t> pick(0, distinct - 1);
+        out.reserve(1000000);
+        for (size_t i = 0; i < 1000000; ++i) out.push_back("host-" + std::to_string(pick(rng)) + ".example.com");
+    }
+    return out;
+}
+
+// Interning every token into a fresh pool, "bytes" is what the result keeps alive
+void BM_InternPoolIntern(benchmark::State& state) {
+    const auto& input = tokens(static_cast<size_t>(state.range(0)));
+    long long bytes = 0;
+    for (auto _ : state) {
+        alloc_counter::Scope scope;
+        string_utils::InternPool pool;
+        for (const auto& token : input) benchmark::DoNotOptimize(pool.intern(token).id);
+        bytes = scope.bytes();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+
+void BM_UnorderedSetInsert(benchmark::State& state) {
+    const auto& input = tokens(static_cast<size_t>(state.range(0)));
+    long long bytes = 0;
+    for (auto _ : state) {
+        alloc_counter::Scope scope;
+        std::unordered_set<std::string> set;
+        for (const auto& token : input) benchmark::DoNotOptimize(&*set.insert(token).first);
+        bytes = scope.bytes();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+
+// Lookups of tokens that are all present, from every benchmark thread at once
+void BM_InternPoolFind(benchmark::State& state) {
+    const auto& input = tokens(static_cast<size_t>(state.range(0)));
+    static std::map<int64_t, std::unique_ptr<string_utils::InternPool>> pools;
+    static std::mutex mutex;
+    string_utils::InternPool* pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& stored = pools[state.range(0)];
+        if (!stored) {
+            stored = std::make_unique<string_utils::InternPool>();
+            for (const auto& token : input) stored->intern(token);
+        }
+        pool = stored.get();
+    }
+
+    string_utils::InternPool::Handle handle;
+    size_t i = static_cast<size_t>(state.thread_index()) * 7919;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pool->find(input[i++ % input.size()], handle));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_UnorderedSetFind(benchmark::State& state) {
+    const auto& input = tokens(static_cast<size_t>(state.range(0)));
+    static std::map<int64_t, std::unordered_set<std::string>> sets;
+    static std::mutex mutex;
+    const std::unordered_set<std::string>* set;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& stored = sets[state.range(0)];
+        if (stored.empty()) stored.insert(input.begin(), input.end());
+        set = &stored;
+    }
+
+    size_t i = static_cast<size_t>(state.thread_index()) * 7919;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(set->find(input[i++ % input.size()]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_ToUpper)->Apply(corpora);
+BENCHMARK(BM_ToLower)->Apply(corpora);
+BENCHMARK(BM_ToUpperInplace)->Apply(corpora);
+BENCHMARK(BM_ToLowerInplace)->Apply(corpora);
+BENCHMARK(BM_Utf8ToLower)->Apply(utf8_corpora);
+BENCHMARK(BM_Utf8ToUpper)->Apply(utf8_corpora);
+BENCHMARK(BM_Utf8FoldCase)->Apply(utf8_corpora);
+BENCHMARK(BM_IsValidUtf8)->Apply(utf8_corpora);
+BENCHMARK(BM_Utf8IsAlpha)->Apply(utf8_corpora);
+BENCHMARK(BM_Trim)->Apply(corpora);
+BENCHMARK(BM_TrimLeft)->Apply(corpora);
+BENCHMARK(BM_TrimRight)->Apply(corpora);
+BENCHMARK(BM_TrimView)->Apply(corpora);
+BENCHMARK(BM_TrimLeftView)->Apply(corpora);
+BENCHMARK(BM_TrimRightView)->Apply(corpora);
+BENCHMARK(BM_TrimInplace)->Apply(corpora);
+BENCHMARK(BM_TrimFields)->Apply(corpora);
+BENCHMARK(BM_SplitChar)->Apply(corpora_and_hits);
+BENCHMARK(BM_SplitString)->Apply(corpora_and_hits);
+BENCHMARK(BM_SplitInto)->Apply(corpora_and_hits);
+BENCHMARK(BM_SplitViewChar)->Apply(corpora_and_hits);
+BENCHMARK(BM_SplitViewString)->Apply(corpora_and_hits);
+BENCHMARK(BM_IsNumeric)->Apply(plain);
+BENCHMARK(BM_IsAlpha)->Apply(plain);
+BENCHMARK(BM_IsAlphanumeric)->Apply(plain);
+BENCHMARK(BM_StartsWith)->Apply(corpora);
+BENCHMARK(BM_IStartsWith)->Apply(corpora);
+BENCHMARK(BM_IEquals)->Apply(corpora);
+BENCHMARK(BM_EndsWith)->Apply(corpora);
+BENCHMARK(BM_ReplaceAll)->Apply(corpora_and_hits);
+BENCHMARK(BM_ReplaceFirst)->Apply(corpora_and_hits);
+BENCHMARK(BM_ReplaceAllMulti)->Apply(corpora_and_hits);
+BENCHMARK(BM_Join)->Apply(corpora_and_hits);
+BENCHMARK(BM_JoinInto)->Apply(corpora_and_hits);
+BENCHMARK(BM_FindAll)->Apply(corpora_and_hits);
+BENCHMARK(BM_IFindAll)->Apply(corpora_and_hits);
+BENCHMARK(BM_LowerThenFindAll)->Apply(corpora_and_hits);
+BENCHMARK(BM_CountOccurrences)->Apply(corpora_and_hits);
+BENCHMARK(BM_SearcherCount)->Apply(corpora_and_hits);
+BENCHMARK(BM_ParseColumn)->Apply(plain);
+BENCHMARK(BM_ParseInt)->Apply(plain);
+BENCHMARK(BM_ParseDouble)->Apply(plain);
+BENCHMARK(BM_LineReader)->Apply(corpora);
+BENCHMARK(BM_FieldReader)->Apply(corpora);
+BENCHMARK(BM_LineReaderMapped)->Apply(corpora);
+BENCHMARK(BM_MappedFileOpen)->Apply(plain);
+BENCHMARK(BM_MappedFileRelease)->Apply(plain);
+BENCHMARK(BM_InternPoolIntern)->Arg(100)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_UnorderedSetInsert)->Arg(100)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InternPoolFind)->Arg(100)->Arg(10000)->Arg(1000000)->ThreadRange(1, 8);
+BENCHMARK(BM_UnorderedSetFind)->Arg(100)->Arg(10000)->Arg(1000000)->ThreadRange(1, 8);
@@ -0,0 +1,54 @@
+#include "case_insensitive.h"
+#include "hash.h"
+#include "simd_ascii.h"
+
+namespace string_utils {
+
+namespace {
+
+// Lower cases the ASCII letters of eight bytes at once. Adding to the low seven
+// bits of each byte sets its top bit where the byte is at least 'A', or above 'Z',
+// without carrying into the next byte.
+uint64_t fold_word(uint64_t word) {
+    constexpr uint64_t ones = 0x0101010101010101ull;
+    uint64_t low = word & (0x7F * ones);
+    uint64_t at_least_a = low + (0x80 - 'A') * ones;
+    uint64_t above_z = low + (0x80 - 'Z' - 1) * ones;
+    uint64_t upper = at_least_a & ~above_z & ~word & (0x80 * ones);
+    return word | (upper >> 2);
+}
+
+} // namespace
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && detail::equal_ignore_case(a.data(), b.data(), a.size());
+}
+
+bool istarts_with(std::string_view str, std::string_view prefix) {
+    return prefix.size() <= str.size() && detail::equal_ignore_case(str.data(), prefix.data(), prefix.size());
+}
+
+bool iends_with(std::string_view str, std::string_view suffix) {
+    return suffix.size() <= str.size() &&
+           detail::equal_ignore_case(str.data() + str.size() - suffix.size(), suffix.data(), suffix.size());
+}
+
+size_t ifind(std::string_view str, std::string_view pattern, size_t from) {
+    return detail::find_ignore_case(str, pattern, from);
+}
+
+std::vector<size_t> ifind_all(std::string_view str, std::string_view pattern) {
+    std::vector<size_t> positions;
+    size_t pos = detail::find_ignore_case(str, pattern, 0);
+    while (pos != std::string_view::npos) {
+        positions.push_back(pos);
+        pos = detail::find_ignore_case(str, pattern, pos + 1);
+    }
+    return positions;
+}
+
+size_t ICaseHash::operator()(std::string_view str) const {
+    return static_cast<size_t>(detail::hash_words(str, fold_word));
+}
+
+} // namespace string_utils
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Allocation-free ASCII case-insensitive comparison, search and hashing, for header
+// names, keywords and other protocol tokens. Only the letters A-Z and a-z are folded,
+// see utf8_fold_case() for Unicode text.
+namespace string_utils {
+
+bool iequals(std::string_view a, std::string_view b);
+bool istarts_with(std::string_view str, std::string_view prefix);
+bool iends_with(std::string_view str, std::string_view suffix);
+
+// Like std::string_view::find() and find_all(), ignoring case
+size_t ifind(std::string_view str, std::string_view pattern, size_t from = 0);
+std::vector<size_t> ifind_all(std::string_view str, std::string_view pattern);
+
+// Hash and equality policies for unordered containers keyed case-insensitively:
+//     std::unordered_map<std::string, Header, ICaseHash, ICaseEqual> headers;
+// The hash of a string equals that of its lower case form, and both are transparent
+// so C++20 lookups by string_view do not build a key.
+struct ICaseHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const;
+};
+
+struct ICaseEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return iequals(a, b); }
+};
+
+} // namespace string_utils
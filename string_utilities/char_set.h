@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace string_utils {
+
+// A set of bytes, usable as a compile-time constant:
+//     constexpr CharSet separators(" \t,;");
+// Besides the 256-bit membership bitmap it keeps the nibble tables the AVX2 kernels
+// classify 32 bytes with, and the members themselves when there are few enough for
+// the SSE2 kernels to compare against one by one.
+class CharSet {
+public:
+    static constexpr size_t max_listed = 8;
+
+    constexpr CharSet() = default;
+    constexpr CharSet(std::string_view chars) { // NOLINT: implicit so a literal can be passed
+        for (char c : chars) add(static_cast<uint8_t>(c));
+    }
+
+    constexpr bool contains(char c) const {
+        uint8_t b = static_cast<uint8_t>(c);
+        return (m_bits[b >> 6] >> (b & 63)) & 1;
+    }
+
+    // Number of distinct members
+    constexpr size_t size() const { return m_size; }
+
+    // The members, only filled while size() <= max_listed
+    constexpr const char* listed() const { return m_listed; }
+
+    // Row lo of the nibble tables has bit (hi & 7) set if hi << 4 | lo is a member,
+    // the low table covers hi < 8 and the high table hi >= 8
+    constexpr const uint8_t* low_nibble_table() const { return m_low; }
+    constexpr const uint8_t* high_nibble_table() const { return m_high; }
+
+private:
+    constexpr void add(uint8_t b) {
+        if (contains(static_cast<char>(b))) return;
+        m_bits[b >> 6] |= uint64_t{1} << (b & 63);
+        if (m_size < max_listed) m_listed[m_size] = static_cast<char>(b);
+        ++m_size;
+        uint8_t hi = b >> 4;
+        (hi < 8 ? m_low : m_high)[b & 15] |= static_cast<uint8_t>(1u << (hi & 7));
+    }
+
+    uint64_t m_bits[4] = {};
+    uint8_t m_low[16] = {};
+    uint8_t m_high[16] = {};
+    char m_listed[max_listed] = {};
+    size_t m_size = 0;
+};
+
+inline constexpr CharSet whitespace_chars(" \t\n\r");
+
+namespace detail {
+
+// Number of leading and trailing bytes of str that belong to chars, vectorized for
+// long runs, see simd_scan.h for the kernels
+size_t leading_in_set(std::string_view str, const CharSet& chars);
+size_t trailing_in_set(std::string_view str, const CharSet& chars);
+
+} // namespace detail
+
+} // namespace string_utils
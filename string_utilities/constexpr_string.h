@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include "char_set.h"
+
+// True while a constexpr function is being evaluated at compile time, so it can take
+// a vectorized path at runtime. Compilers without the builtin always take the
+// constexpr path.
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define STRING_UTILS_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define STRING_UTILS_IS_CONSTANT_EVALUATED() true
+#endif
+
+// Compile-time versions of the string_view core. They follow the same rules as the
+// runtime functions in string_utilities.h, so configuration keys, protocol literals
+// and dispatch tables can be split and matched in constant expressions. At runtime
+// prefer the string_utilities.h functions, which are vectorized where it pays off.
+namespace string_utils::ct {
+
+// Trimming of any CharSet, whitespace_chars by default, for example ct::trim(field, CharSet(" \t\""))
+constexpr std::string_view trim_left(std::string_view str, const CharSet& chars) {
+    size_t start = 0;
+    while (start < str.size() && chars.contains(str[start])) ++start;
+    return str.substr(start);
+}
+
+constexpr std::string_view trim_right(std::string_view str, const CharSet& chars) {
+    size_t end = str.size();
+    while (end > 0 && chars.contains(str[end - 1])) --end;
+    return str.substr(0, end);
+}
+
+constexpr std::string_view trim(std::string_view str, const CharSet& chars) {
+    return trim_right(trim_left(str, chars), chars);
+}
+
+constexpr std::string_view trim_left(std::string_view str) { return trim_left(str, whitespace_chars); }
+constexpr std::string_view trim_right(std::string_view str) { return trim_right(str, whitespace_chars); }
+constexpr std::string_view trim(std::string_view str) { return trim(str, whitespace_chars); }
+
+constexpr bool starts_with(std::string_view str, std::string_view prefix) {
+    return prefix.size() <= str.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+constexpr bool ends_with(std::string_view str, std::string_view suffix) {
+    return suffix.size() <= str.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Position of the first pattern at or after pos, npos if there is none
+constexpr size_t find(std::string_view str, std::string_view pattern, size_t pos = 0) {
+    return str.find(pattern, pos);
+}
+
+constexpr size_t find(std::string_view str, char ch, size_t pos = 0) {
+    return str.find(ch, pos);
+}
+
+// Non-overlapping occurrences, an empty pattern occurs zero times
+constexpr size_t count_occurrences(std::string_view str, std::string_view pattern) {
+    if (pattern.empty()) return 0;
+
+    size_t count = 0;
+    for (size_t pos = str.find(pattern); pos != std::string_view::npos; pos = str.find(pattern, pos + pattern.size())) {
+        ++count;
+    }
+    return count;
+}
+
+// At most N tokens of a split, stored in place
+template <size_t N>
+class FixedSplit {
+public:
+    static_assert(N > 0, "FixedSplit needs room for at least one token");
+
+    constexpr size_t size() const { return m_size; }
+    constexpr bool empty() const { return m_size == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    constexpr std::string_view operator[](size_t i) const { return m_tokens[i]; }
+    constexpr const std::string_view* begin() const { return m_tokens.data(); }
+    constexpr const std::string_view* end() const { return m_tokens.data() + m_size; }
+
+    constexpr void push_back(std::string_view token) { m_tokens[m_size++] = token; }
+
+private:
+    std::array<std::string_view, N> m_tokens{};
+    size_t m_size = 0;
+};
+
+namespace detail {
+
+template <size_t N, typename Delimiter>
+constexpr FixedSplit<N> split(std::string_view str, Delimiter delimiter, size_t delimiter_size, bool single_char) {
+    FixedSplit<N> tokens;
+    // An empty delimiter never matches, the whole input is a single token
+    while (delimiter_size != 0 && tokens.size() + 1 < N) {
+        size_t pos = str.find(delimiter);
+        if (pos == std::string_view::npos) break;
+        tokens.push_back(str.substr(0, pos));
+        str = str.substr(pos + delimiter_size);
+        // A trailing single char delimiter does not start a new token
+        if (str.empty() && single_char) return tokens;
+    }
+    tokens.push_back(str);
+    return tokens;
+}
+
+} // namespace detail
+
+// Splits like split_view(), keeping the tokens in a FixedSplit. When there are more
+// than N tokens the last one holds the unsplit rest of the input, so
+// split<2>("key=a=b", '=') gives "key" and "a=b".
+template <size_t N>
+constexpr FixedSplit<N> split(std::string_view str, char delimiter) {
+    return detail::split<N>(str, delimiter, 1, true);
+}
+
+template <size_t N>
+constexpr FixedSplit<N> split(std::string_view str, std::string_view delimiter) {
+    return detail::split<N>(str, delimiter, delimiter.size(), false);
+}
+
+} // namespace string_utils::ct
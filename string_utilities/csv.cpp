@@ -0,0 +1,225 @@
+#include "csv.h"
+#include <cstring>
+
+namespace string_utils::detail {
+
+CsvMasks classify_csv_block_scalar(const char* block, char delimiter, char quote) {
+    CsvMasks masks{0, 0, 0};
+    for (int i = 0; i < 64; ++i) {
+        uint64_t bit = uint64_t{1} << i;
+        if (block[i] == quote) masks.quotes |= bit;
+        if (block[i] == delimiter) masks.delimiters |= bit;
+        if (block[i] == '\n') masks.newlines |= bit;
+    }
+    return masks;
+}
+
+#if STRING_UTILS_HAS_SSE2
+namespace {
+
+inline uint64_t equal_mask_sse2(__m128i v, __m128i needle) {
+    return static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+}
+
+} // namespace
+
+CsvMasks classify_csv_block_sse2(const char* block, char delimiter, char quote) {
+    const __m128i quotes = _mm_set1_epi8(quote);
+    const __m128i delimiters = _mm_set1_epi8(delimiter);
+    const __m128i newlines = _mm_set1_epi8('\n');
+
+    CsvMasks masks{0, 0, 0};
+    for (int i = 0; i < 64; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        masks.quotes |= equal_mask_sse2(v, quotes) << i;
+        masks.delimiters |= equal_mask_sse2(v, delimiters) << i;
+        masks.newlines |= equal_mask_sse2(v, newlines) << i;
+    }
+    return masks;
+}
+#endif
+
+#if STRING_UTILS_HAS_AVX2
+namespace {
+
+STRING_UTILS_TARGET_AVX2
+inline uint64_t equal_mask_avx2(__m256i lo, __m256i hi, __m256i needle) {
+    uint32_t low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+} // namespace
+
+STRING_UTILS_TARGET_AVX2
+CsvMasks classify_csv_block_avx2(const char* block, char delimiter, char quote) {
+    const __m256i quotes = _mm256_set1_epi8(quote);
+    const __m256i delimiters = _mm256_set1_epi8(delimiter);
+    const __m256i newlines = _mm256_set1_epi8('\n');
+
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    return CsvMasks{equal_mask_avx2(lo, hi, quotes), equal_mask_avx2(lo, hi, delimiters),
+                    equal_mask_avx2(lo, hi, newlines)};
+}
+#endif
+
+CsvMasks classify_csv_block(const char* block, char delimiter, char quote) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return classify_csv_block_avx2(block, delimiter, quote);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return classify_csv_block_sse2(block, delimiter, quote);
+#else
+    return classify_csv_block_scalar(block, delimiter, quote);
+#endif
+}
+
+} // namespace string_utils::detail
+
+namespace string_utils::csv {
+
+Reader::Reader(std::string_view text, Dialect dialect) : m_text(text), m_dialect(dialect) {}
+
+Reader::Reader(MappedFile& file, Dialect dialect) : Reader(file.view(), dialect) {
+    m_file = &file;
+}
+
+bool Reader::next(std::vector<std::string_view>& fields) {
+    if (m_pos >= m_text.size()) return false;
+
+    fields.clear();
+    m_unescaped.clear();
+    m_pending.clear();
+    m_error = std::errc{};
+
+    size_t begin = m_pos;
+    size_t pos;
+    bool newline = false;
+    while (next_separator(pos)) {
+        newline = (m_newlines >> (pos & 63)) & 1;
+        add_field(fields, begin, pos, newline);
+        begin = pos + 1;
+        if (newline) break;
+    }
+    if (newline) {
+        m_pos = pos + 1;
+    } else {
+        add_field(fields, begin, m_text.size(), true);
+        m_pos = m_text.size();
+    }
+
+    // Unescaped fields point into m_unescaped only now that it has stopped growing
+    for (const auto& [index, offset] : m_pending) {
+        fields[index] = std::string_view(m_unescaped.data() + offset, fields[index].size());
+    }
+
+    if (m_file && m_pos - m_released >= 2 * release_window) {
+        // Keep the most recent window resident, earlier records are rarely revisited
+        size_t until = m_pos - release_window;
+        m_file->release(m_released, until - m_released);
+        m_released = until;
+    }
+    return true;
+}
+
+bool Reader::next_separator(size_t& pos) {
+    while (m_separators == 0) {
+        if (m_block >= m_text.size()) return false;
+        load_block();
+    }
+    pos = m_block - 64 + static_cast<size_t>(detail::count_trailing_zeros64(m_separators));
+    m_separators &= m_separators - 1;
+    return true;
+}
+
+void Reader::load_block() {
+    const size_t left = m_text.size() - m_block;
+    detail::CsvMasks masks;
+    if (left >= 64) {
+        masks = detail::classify_csv_block(m_text.data() + m_block, m_dialect.delimiter, m_dialect.quote);
+    } else {
+        // The last partial block is classified from a copy, the bits past the end dropped
+        char tail[64] = {};
+        std::memcpy(tail, m_text.data() + m_block, left);
+        masks = detail::classify_csv_block(tail, m_dialect.delimiter, m_dialect.quote);
+        const uint64_t valid = (uint64_t{1} << left) - 1;
+        masks.quotes &= valid;
+        masks.delimiters &= valid;
+        masks.newlines &= valid;
+    }
+
+    if (masks.quotes) m_quotes_until = m_block + 64;
+    // Quote bits toggle the inside state, so separators after an odd number of quotes
+    // are data. A doubled quote toggles twice and leaves the state as it was. Outside
+    // quotes only a quote at the start of a field, or right after a closing one as
+    // the second of a doubled quote, opens one. Other quotes are data that would
+    // flip the state for the rest of the text, each pass drops the first of them,
+    // whose state is known to be right. Only malformed text needs a second pass.
+    const uint64_t separators = masks.delimiters | masks.newlines;
+    uint64_t quotes = masks.quotes;
+    uint64_t inside = detail::prefix_xor(quotes) ^ m_inside;
+    uint64_t closing = quotes & ~inside;
+    for (;;) {
+        const uint64_t openers = (separators << 1) | (closing << 1) | m_boundary;
+        const uint64_t stray = quotes & ~openers & ~(inside ^ quotes);
+        if (stray == 0) break;
+        quotes &= ~(stray & (0 - stray));
+        inside = detail::prefix_xor(quotes) ^ m_inside;
+        closing = quotes & ~inside;
+    }
+    m_inside = static_cast<uint64_t>(static_cast<int64_t>(inside) >> 63);
+    m_boundary = (separators | closing) >> 63;
+    m_newlines = masks.newlines & ~inside;
+    m_separators = (masks.delimiters | masks.newlines) & ~inside;
+    m_block += 64;
+}
+
+void Reader::add_field(std::vector<std::string_view>& fields, size_t begin, size_t end, bool last) {
+    std::string_view raw = m_text.substr(begin, end - begin);
+    if (last && !raw.empty() && raw.back() == '\r') raw.remove_suffix(1);
+
+    const char quote = m_dialect.quote;
+    if (raw.empty() || raw[0] != quote) {
+        // Only fields in a block with a quote need to be searched for a stray one
+        if (m_quotes_until > begin && raw.find(quote) != std::string_view::npos) {
+            m_error = std::errc::invalid_argument;
+        }
+        fields.push_back(raw);
+        return;
+    }
+
+    std::string_view body = raw.substr(1);
+    size_t close = body.find(quote);
+    if (close != std::string_view::npos && close + 1 == body.size()) {
+        fields.push_back(body.substr(0, close)); // "field" without escapes, the common case
+        return;
+    }
+
+    // Doubled quotes, text after the closing quote or no closing quote at all
+    const size_t offset = m_unescaped.size();
+    size_t from = 0;
+    for (;;) {
+        size_t q = body.find(quote, from);
+        if (q == std::string_view::npos) {
+            m_unescaped.append(body, from);
+            m_error = std::errc::invalid_argument;
+            break;
+        }
+        m_unescaped.append(body, from, q - from);
+        if (q + 1 < body.size() && body[q + 1] == quote) {
+            m_unescaped += quote;
+            from = q + 2;
+            continue;
+        }
+        if (q + 1 < body.size()) {
+            m_unescaped.append(body, q + 1);
+            m_error = std::errc::invalid_argument;
+        }
+        break;
+    }
+    m_pending.emplace_back(fields.size(), offset);
+    fields.push_back(std::string_view(nullptr, m_unescaped.size() - offset)); // pointed at m_unescaped by next()
+}
+
+} // namespace string_utils::csv
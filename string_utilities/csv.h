@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "mapped_file.h"
+#include "simd.h"
+
+// RFC 4180 records: fields separated by a delimiter, records by "\n" or "\r\n",
+// and fields that start with a quote may contain delimiters, newlines and quotes
+// doubled as "". The text is classified 64 bytes at a time into quote, delimiter
+// and newline bitmasks, and a prefix XOR over the quote bits tells which of the
+// other two sit inside quotes, so the fields are found without a per-byte state
+// machine. Quotes are only special at the start of a field and inside or right
+// after a quoted one, the bits of other quotes are cleared before the prefix XOR.
+namespace string_utils::csv {
+
+struct Dialect {
+    char delimiter = ',';
+    char quote = '"';
+};
+
+inline constexpr Dialect comma{',', '"'};
+inline constexpr Dialect tab{'\t', '"'};
+
+// Yields the records of a text as field views. A field is a view into the text,
+// unless it contained "" and had to be unescaped, then it points into a buffer of
+// the reader that is reused by the next call. Like FieldReader an empty line is a
+// record with one empty field and a final newline does not start another record.
+class Reader {
+public:
+    explicit Reader(std::string_view text, Dialect dialect = comma);
+    Reader(MappedFile& file, Dialect dialect = comma);
+
+    // Replaces fields with the fields of the next record, returns false once the text
+    // is exhausted. Reusing the same vector keeps the loop free of allocations.
+    bool next(std::vector<std::string_view>& fields);
+
+    // std::errc::invalid_argument if the last record was malformed: a quote inside an
+    // unquoted field, text after a closing quote or a quote that is never closed.
+    // The record is still returned, read as leniently as the bitmasks allow.
+    std::errc error() const { return m_error; }
+
+    // Bytes consumed so far
+    size_t offset() const { return m_pos; }
+
+private:
+    // Consumed bytes kept resident before they are handed back to the OS
+    static constexpr size_t release_window = 64 * 1024 * 1024;
+
+    bool next_separator(size_t& pos);
+    void load_block();
+    void add_field(std::vector<std::string_view>& fields, size_t begin, size_t end, bool last);
+
+    std::string_view m_text;
+    Dialect m_dialect;
+    MappedFile* m_file = nullptr;
+    size_t m_released = 0;
+
+    size_t m_pos = 0;          // start of the next record
+    size_t m_block = 0;        // offset of the block after the one in m_separators
+    uint64_t m_separators = 0; // unread delimiters and newlines outside quotes
+    uint64_t m_newlines = 0;   // the newlines among them
+    uint64_t m_inside = 0;     // all ones while the previous block ended inside quotes
+    uint64_t m_boundary = 1;   // 1 at the start and after a block ending in a separator or closing quote
+    size_t m_quotes_until = 0; // end of the last block that had a quote
+
+    std::string m_unescaped;
+    std::vector<std::pair<size_t, size_t>> m_pending; // field index and offset in m_unescaped
+    std::errc m_error{};
+};
+
+} // namespace string_utils::csv
+
+namespace string_utils::detail {
+
+struct CsvMasks {
+    uint64_t quotes;
+    uint64_t delimiters;
+    uint64_t newlines;
+};
+
+// Bit i of the result is the XOR of bits 0 to i of bits
+inline uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// Classifies the 64 bytes at block
+CsvMasks classify_csv_block(const char* block, char delimiter, char quote);
+
+CsvMasks classify_csv_block_scalar(const char* block, char delimiter, char quote);
+#if STRING_UTILS_HAS_SSE2
+CsvMasks classify_csv_block_sse2(const char* block, char delimiter, char quote);
+#endif
+#if STRING_UTILS_HAS_AVX2
+CsvMasks classify_csv_block_avx2(const char* block, char delimiter, char quote);
+#endif
+
+} // namespace string_utils::detail
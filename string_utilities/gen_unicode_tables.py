@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Generates unicode_tables.h from the Unicode database that ships with Python.
+
+Usage: python3 gen_unicode_tables.py > unicode_tables.h
+
+Only code points above ASCII are listed, ASCII is handled by the SIMD kernels.
+Case mappings are the one to one mappings, code points whose mapping expands to
+several characters (like U+00DF to "SS") are left unchanged.
+"""
+import sys
+import unicodedata
+
+MAX_CODE_POINT = 0x10FFFF
+
+
+def simple_mapping(convert):
+    pairs = []
+    for cp in range(0x80, MAX_CODE_POINT + 1):
+        ch = chr(cp)
+        mapped = convert(ch)
+        if len(mapped) == 1 and mapped != ch:
+            pairs.append((cp, ord(mapped)))
+    return pairs
+
+
+def case_ranges(pairs):
+    """Runs of code points with the same delta, one or two apart"""
+    ranges = []
+    for cp, mapped in pairs:
+        delta = mapped - cp
+        if ranges:
+            first, last, run_delta, stride = ranges[-1]
+            step = cp - last
+            if run_delta == delta and step in (1, 2) and (first == last or step == stride):
+                ranges[-1] = (first, cp, delta, step)
+                continue
+        ranges.append((cp, cp, delta, 1))
+    return ranges
+
+
+def code_ranges(predicate):
+    ranges = []
+    for cp in range(0x80, MAX_CODE_POINT + 1):
+        if not predicate(chr(cp)):
+            continue
+        if ranges and ranges[-1][1] == cp - 1:
+            ranges[-1] = (ranges[-1][0], cp)
+        else:
+            ranges.append((cp, cp))
+    return ranges
+
+
+def fold(ch):
+    # Simple case folding as lower(upper(c)): every member of a case pair ends up
+    # at the same code point, including the title case and the odd ones out like
+    # U+017F LATIN SMALL LETTER LONG S and U+212A KELVIN SIGN
+    upper = ch.upper()
+    if len(upper) != 1:
+        upper = ch
+    lower = upper.lower()
+    return lower if len(lower) == 1 else ch
+
+
+def emit_case(out, name, ranges):
+    out.append(f"inline constexpr CaseRange {name}[] = {{")
+    for first, last, delta, stride in ranges:
+        out.append(f"    {{0x{first:04X}, 0x{last:04X}, {delta}, {stride}}},")
+    out.append("};")
+    out.append("")
+
+
+def emit_code(out, name, ranges):
+    out.append(f"inline constexpr CodeRange {name}[] = {{")
+    for first, last in ranges:
+        out.append(f"    {{0x{first:04X}, 0x{last:04X}}},")
+    out.append("};")
+    out.append("")
+
+
+def main():
+    out = [
+        "#pragma once",
+        "#include <cstdint>",
+        "",
+        f"// Generated by gen_unicode_tables.py from Unicode {unicodedata.unidata_version}, do not edit.",
+        "// Every table is sorted and only covers code points above ASCII.",
+        "namespace string_utils::detail {",
+        "",
+        "// Maps every stride-th code point from first to last by adding delta",
+        "struct CaseRange {",
+        "    uint32_t first;",
+        "    uint32_t last;",
+        "    int32_t delta;",
+        "    uint32_t stride;",
+        "};",
+        "",
+        "struct CodeRange {",
+        "    uint32_t first;",
+        "    uint32_t last;",
+        "};",
+        "",
+    ]
+    emit_case(out, "lower_ranges", case_ranges(simple_mapping(str.lower)))
+    emit_case(out, "upper_ranges", case_ranges(simple_mapping(str.upper)))
+    emit_case(out, "fold_ranges", case_ranges(simple_mapping(fold)))
+    # Letters are general categories L*, digits are Nd
+    emit_code(out, "alpha_ranges", code_ranges(lambda ch: unicodedata.category(ch).startswith("L")))
+    emit_code(out, "digit_ranges", code_ranges(lambda ch: unicodedata.category(ch) == "Nd"))
+    out.append("} // namespace string_utils::detail")
+    sys.stdout.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
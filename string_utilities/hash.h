@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace string_utils::detail {
+
+// The hash behind hash_bytes(), with every eight byte word passed through fold
+// before it is mixed in, so callers can hash a normalized form without copying it
+template <typename Fold>
+inline uint64_t hash_words(std::string_view str, Fold fold) {
+    constexpr uint64_t k0 = 0x9E3779B97F4A7C15ull;
+    constexpr uint64_t k1 = 0xBF58476D1CE4E5B9ull;
+
+    const char* p = str.data();
+    size_t n = str.size();
+    uint64_t h = k0 ^ (n * k1);
+    while (n >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = (h ^ fold(word)) * k1;
+        h ^= h >> 29;
+        p += 8;
+        n -= 8;
+    }
+    if (n > 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, p, n);
+        h = (h ^ fold(word)) * k1;
+    }
+    // Final avalanche so both the low (slot) and high (shard, tag) bits are mixed
+    h ^= h >> 32;
+    h *= k0;
+    h ^= h >> 29;
+    return h;
+}
+
+} // namespace string_utils::detail
@@ -0,0 +1,197 @@
+#include "intern_pool.h"
+#include "hash.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace string_utils {
+
+namespace detail {
+
+uint64_t hash_bytes(std::string_view str) {
+    return hash_words(str, [](uint64_t word) { return word; });
+}
+
+} // namespace detail
+
+namespace {
+
+constexpr double max_load = 0.7;
+
+unsigned floor_log2(size_t v) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#endif
+}
+
+uint64_t make_slot(uint64_t hash, uint32_t local) {
+    return (hash & 0xFFFFFFFF00000000ull) | (static_cast<uint64_t>(local) + 1);
+}
+
+} // namespace
+
+InternPool::Table::Table(size_t capacity) : mask(capacity - 1), slots(new std::atomic<uint64_t>[capacity]()) {}
+
+InternPool::InternPool(size_t shards) {
+    while ((size_t{1} << m_shard_bits) < shards && m_shard_bits < 8) ++m_shard_bits;
+    m_shards = std::make_unique<Shard[]>(size_t{1} << m_shard_bits);
+}
+
+InternPool::~InternPool() noexcept {
+    for (size_t s = 0; s < (size_t{1} << m_shard_bits); ++s) {
+        for (auto& segment : m_shards[s].segments) delete[] segment.load();
+    }
+}
+
+const InternPool::Entry& InternPool::entry(const Shard& shard, uint32_t local) const {
+    unsigned k = floor_log2(local / first_segment + 1);
+    size_t offset = local - first_segment * ((size_t{1} << k) - 1);
+    return shard.segments[k].load(std::memory_order_acquire)[offset];
+}
+
+bool InternPool::find_in(const Shard& shard, std::string_view str, uint64_t hash, uint32_t& local) const {
+    const Table* table = shard.table.load(std::memory_order_acquire);
+    if (!table) return false;
+
+    const uint64_t tag = hash & 0xFFFFFFFF00000000ull;
+    for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+        uint64_t slot = table->slots[i].load(std::memory_order_acquire);
+        if (slot == 0) return false;
+        if ((slot & 0xFFFFFFFF00000000ull) != tag) continue;
+
+        uint32_t candidate = static_cast<uint32_t>(slot) - 1;
+        const Entry& e = entry(shard, candidate);
+        if (std::string_view(e.data, e.size) == str) {
+            local = candidate;
+            return true;
+        }
+    }
+}
+
+InternPool::Handle InternPool::intern(std::string_view str) {
+    uint64_t hash = detail::hash_bytes(str);
+    size_t s = m_shard_bits == 0 ? 0 : static_cast<size_t>(hash >> (64 - m_shard_bits));
+    Shard& shard = m_shards[s];
+
+    // Most tokens are repeats, those never take the lock
+    uint32_t local;
+    if (!find_in(shard, str, hash, local)) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!find_in(shard, str, hash, local)) local = insert(shard, str, hash);
+    }
+    const Entry& e = entry(shard, local);
+    return Handle{make_id(s, local), std::string_view(e.data, e.size)};
+}
+
+bool InternPool::find(std::string_view str, Handle& handle) const {
+    uint64_t hash = detail::hash_bytes(str);
+    size_t s = m_shard_bits == 0 ? 0 : static_cast<size_t>(hash >> (64 - m_shard_bits));
+
+    uint32_t local;
+    if (!find_in(m_shards[s], str, hash, local)) return false;
+    const Entry& e = entry(m_shards[s], local);
+    handle = Handle{make_id(s, local), std::string_view(e.data, e.size)};
+    return true;
+}
+
+std::string_view InternPool::view(uint32_t id) const {
+    const Shard& shard = m_shards[id & ((1u << m_shard_bits) - 1)];
+    const Entry& e = entry(shard, id >> m_shard_bits);
+    return std::string_view(e.data, e.size);
+}
+
+// Called with the shard locked
+uint32_t InternPool::insert(Shard& shard, std::string_view str, uint64_t hash) {
+    const uint32_t local = shard.count.load(std::memory_order_relaxed);
+    if (local >= (uint64_t{1} << (32 - m_shard_bits)) - 1) throw std::length_error("InternPool: out of ids");
+
+    // The entry is written before any slot refers to it
+    unsigned k = floor_log2(local / first_segment + 1);
+    if (k >= max_segments) throw std::length_error("InternPool: out of ids");
+    Entry* segment = shard.segments[k].load(std::memory_order_relaxed);
+    if (!segment) {
+        segment = new Entry[first_segment << k];
+        shard.segments[k].store(segment, std::memory_order_release);
+    }
+    segment[local - first_segment * ((size_t{1} << k) - 1)] = Entry{store(shard, str), str.size()};
+
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    if (!table || static_cast<double>(local + 1) > max_load * static_cast<double>(table->mask + 1)) {
+        // Readers still probing the old table see a complete, just older, set of
+        // strings, so it is kept instead of freed
+        auto grown = std::make_unique<Table>(table ? 2 * (table->mask + 1) : 64);
+        if (table) {
+            for (size_t i = 0; i <= table->mask; ++i) {
+                uint64_t slot = table->slots[i].load(std::memory_order_relaxed);
+                if (slot == 0) continue;
+                const Entry& e = entry(shard, static_cast<uint32_t>(slot) - 1);
+                size_t j = detail::hash_bytes(std::string_view(e.data, e.size)) & grown->mask;
+                while (grown->slots[j].load(std::memory_order_relaxed) != 0) j = (j + 1) & grown->mask;
+                grown->slots[j].store(slot, std::memory_order_relaxed);
+            }
+        }
+        table = grown.get();
+        shard.tables.push_back(std::move(grown));
+        shard.table.store(table, std::memory_order_release);
+    }
+
+    size_t i = hash & table->mask;
+    while (table->slots[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & table->mask;
+    table->slots[i].store(make_slot(hash, local), std::memory_order_release);
+    shard.count.store(local + 1, std::memory_order_release);
+    return local;
+}
+
+// Called with the shard locked
+const char* InternPool::store(Shard& shard, std::string_view str) {
+    if (str.size() > shard.left) {
+        // Long strings get a block of their own so the current block is not wasted
+        size_t block = std::min(max_arena_block, std::max(min_arena_block, shard.block_bytes));
+        size_t size = str.size() > block / 4 ? str.size() : block;
+        shard.blocks.push_back(std::make_unique<char[]>(size));
+        shard.block_bytes += size;
+        if (size != str.size()) {
+            shard.cursor = shard.blocks.back().get();
+            shard.left = size;
+        } else {
+            std::memcpy(shard.blocks.back().get(), str.data(), str.size());
+            return shard.blocks.back().get();
+        }
+    }
+    char* out = shard.cursor;
+    if (!str.empty()) std::memcpy(out, str.data(), str.size());
+    shard.cursor += str.size();
+    shard.left -= str.size();
+    return out;
+}
+
+size_t InternPool::size() const {
+    size_t total = 0;
+    for (size_t s = 0; s < (size_t{1} << m_shard_bits); ++s) {
+        total += m_shards[s].count.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+size_t InternPool::memory_usage() const {
+    size_t total = sizeof(*this) + (sizeof(Shard) << m_shard_bits);
+    for (size_t s = 0; s < (size_t{1} << m_shard_bits); ++s) {
+        Shard& shard = m_shards[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.block_bytes + shard.blocks.capacity() * sizeof(shard.blocks[0]);
+        for (const auto& table : shard.tables) total += (table->mask + 1) * sizeof(table->slots[0]);
+        for (size_t k = 0; k < max_segments; ++k) {
+            if (shard.segments[k].load(std::memory_order_relaxed)) total += (first_segment << k) * sizeof(Entry);
+        }
+    }
+    return total;
+}
+
+} // namespace string_utils
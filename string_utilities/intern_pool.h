@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace string_utils {
+
+// Stores one copy of every distinct string and hands out a stable handle for it, so
+// millions of repeated tokens (status codes, host names, field names) cost a 32-bit
+// id each instead of a std::string each. Interning is thread-safe and locks only one
+// of the shards, lookups never lock. Interned strings live as long as the pool.
+class InternPool {
+public:
+    struct Handle {
+        uint32_t id = 0;
+        std::string_view view; // points into the pool
+
+        friend bool operator==(const Handle& a, const Handle& b) { return a.id == b.id; }
+        friend bool operator!=(const Handle& a, const Handle& b) { return a.id != b.id; }
+    };
+
+    // shards is rounded up to a power of two, more shards means less contention
+    explicit InternPool(size_t shards = 16);
+    ~InternPool() noexcept;
+
+    InternPool(const InternPool&) = delete; // not copyable
+    InternPool& operator=(const InternPool&) = delete; // not copyable
+
+    // Handle of str, adding a copy of it on first sight. Throws std::length_error
+    // once a shard runs out of ids.
+    Handle intern(std::string_view str);
+
+    // Sets handle and returns true if str was interned, never blocks
+    bool find(std::string_view str, Handle& handle) const;
+
+    // The string behind an id handed out by this pool, never blocks
+    std::string_view view(uint32_t id) const;
+
+    // Number of distinct strings
+    size_t size() const;
+
+    // Bytes held by the pool: string storage, hash tables and the id directory
+    size_t memory_usage() const;
+
+private:
+    struct Entry {
+        const char* data;
+        size_t size;
+    };
+
+    // Open addressing table with linear probing. A slot holds the upper hash bits
+    // and the local index + 1 of its entry, zero marks an empty slot.
+    struct Table {
+        explicit Table(size_t capacity);
+        size_t mask;
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    };
+
+    // Entries are kept in segments that double in size and never move, so readers
+    // can follow an id without a lock while the shard keeps growing
+    static constexpr size_t first_segment = 64;
+    static constexpr size_t max_segments = 26;
+    // Arena blocks double from the smallest to the largest size, so small pools stay small
+    static constexpr size_t min_arena_block = 1024;
+    static constexpr size_t max_arena_block = 64 * 1024;
+
+    struct Shard {
+        std::mutex mutex;
+        std::atomic<Table*> table{nullptr};
+        std::vector<std::unique_ptr<Table>> tables; // current one last, earlier ones stay readable
+        std::atomic<Entry*> segments[max_segments] = {};
+        std::atomic<uint32_t> count{0};
+
+        // Arena the string bytes are copied into
+        std::vector<std::unique_ptr<char[]>> blocks;
+        size_t block_bytes = 0;
+        char* cursor = nullptr;
+        size_t left = 0;
+    };
+
+    const Entry& entry(const Shard& shard, uint32_t local) const;
+    bool find_in(const Shard& shard, std::string_view str, uint64_t hash, uint32_t& local) const;
+    uint32_t insert(Shard& shard, std::string_view str, uint64_t hash);
+    const char* store(Shard& shard, std::string_view str);
+    uint32_t make_id(size_t shard, uint32_t local) const { return (local << m_shard_bits) | static_cast<uint32_t>(shard); }
+
+    unsigned m_shard_bits = 0;
+    std::unique_ptr<Shard[]> m_shards;
+};
+
+namespace detail {
+
+// Fast non-cryptographic 64-bit hash, reads eight bytes at a time
+uint64_t hash_bytes(std::string_view str);
+
+} // namespace detail
+
+} // namespace string_utils
@@ -0,0 +1,40 @@
+#include "line_reader.h"
+#include "simd_scan.h"
+#include "string_utilities.h"
+
+namespace string_utils {
+
+bool LineReader::next(std::string_view& line) {
+    if (m_rest.empty()) return false;
+
+    size_t end = detail::find_char(m_rest, '\n');
+    if (end == std::string_view::npos) {
+        line = m_rest;
+        m_rest = m_rest.substr(m_rest.size());
+    } else {
+        line = m_rest.substr(0, end);
+        m_rest = m_rest.substr(end + 1);
+    }
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    if (m_file && offset() - m_released >= 2 * m_release_window) {
+        // Keep the most recent window resident, earlier lines are rarely revisited
+        size_t until = offset() - m_release_window;
+        m_file->release(m_released, until - m_released);
+        m_released = until;
+    }
+    return true;
+}
+
+bool FieldReader::next(std::vector<std::string_view>& fields) {
+    std::string_view line;
+    if (!m_lines.next(line)) return false;
+
+    fields.clear();
+    for (std::string_view field : split_view(line, m_delimiter)) {
+        fields.push_back(field);
+    }
+    return true;
+}
+
+} // namespace string_utils
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "mapped_file.h"
+
+namespace string_utils {
+
+// Yields the lines of a text as views into it, without copying. Lines end at '\n',
+// a trailing '\r' is dropped the same way trim() drops it, and a final newline does
+// not produce an extra empty line. When reading a MappedFile the pages of lines that
+// were consumed long ago are released, so memory use stays flat on huge files.
+class LineReader {
+public:
+    explicit LineReader(std::string_view text) : m_rest(text), m_begin(text.data()) {}
+    // release_window is how many consumed bytes are kept resident before they are
+    // handed back to the OS
+    explicit LineReader(MappedFile& file, size_t release_window = 64 * 1024 * 1024)
+        : LineReader(file.view()) {
+        m_file = &file;
+        m_release_window = release_window;
+    }
+
+    // Sets line to the next line, returns false once the text is exhausted
+    bool next(std::string_view& line);
+
+    // Bytes consumed so far
+    size_t offset() const { return static_cast<size_t>(m_rest.data() - m_begin); }
+
+    // Bytes at the start of a MappedFile handed back to the OS so far
+    size_t released() const { return m_released; }
+
+private:
+    std::string_view m_rest;
+    const char* m_begin;
+    MappedFile* m_file = nullptr;
+    size_t m_release_window = 0;
+    size_t m_released = 0;
+};
+
+// Splits every line of a LineReader into fields, following split_view() rules
+class FieldReader {
+public:
+    FieldReader(std::string_view text, char delimiter) : m_lines(text), m_delimiter(delimiter) {}
+    FieldReader(MappedFile& file, char delimiter) : m_lines(file), m_delimiter(delimiter) {}
+
+    // Replaces fields with the fields of the next line, returns false once the text is
+    // exhausted. Reusing the same vector keeps the loop free of allocations.
+    bool next(std::vector<std::string_view>& fields);
+
+private:
+    LineReader m_lines;
+    char m_delimiter;
+};
+
+} // namespace string_utils
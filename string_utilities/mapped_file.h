@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace string_utils {
+
+// Read-only memory mapping of a whole file, opened for sequential access.
+// Throws std::system_error when the file cannot be opened or mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete; // not copyable
+    MappedFile& operator=(const MappedFile&) = delete; // not copyable
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+    std::string_view view() const noexcept { return std::string_view(m_data, m_size); }
+
+    // Lets the OS drop the pages of a range that has been consumed, so resident
+    // memory stays bounded while streaming a large file. The contents stay valid
+    // and are read back from the file if the range is touched again.
+    void release(size_t offset, size_t length) noexcept;
+
+private:
+    void unmap() noexcept;
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace string_utils
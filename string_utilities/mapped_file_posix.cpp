@@ -0,0 +1,75 @@
+#include "mapped_file.h"
+#include <cerrno>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace string_utils {
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + path);
+    }
+
+    // mmap rejects empty mappings, an empty file is simply an empty view
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size > 0) {
+        void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "mmap " + path);
+        }
+        ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(mapping);
+    }
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() noexcept {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+void MappedFile::release(size_t offset, size_t length) noexcept {
+    if (!m_data || offset >= m_size) return;
+    if (length > m_size - offset) length = m_size - offset;
+
+    // Only whole pages inside the range can be dropped
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = offset + length == m_size ? m_size : (offset + length) / page * page;
+    if (begin >= end) return;
+
+    ::madvise(const_cast<char*>(m_data) + begin, end - begin, MADV_DONTNEED);
+}
+
+void MappedFile::unmap() noexcept {
+    if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+} // namespace string_utils
@@ -0,0 +1,83 @@
+#include "mapped_file.h"
+#include <system_error>
+#include <utility>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+namespace string_utils {
+
+namespace {
+
+[[noreturn]] void throw_last_error(const std::string& what) {
+    throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw_last_error("CreateFile " + path);
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        DWORD error = GetLastError();
+        CloseHandle(file);
+        throw std::system_error(static_cast<int>(error), std::system_category(), "GetFileSizeEx " + path);
+    }
+
+    // Empty files cannot be mapped, an empty file is simply an empty view
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            DWORD error = GetLastError();
+            CloseHandle(file);
+            throw std::system_error(static_cast<int>(error), std::system_category(), "CreateFileMapping " + path);
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        DWORD error = GetLastError();
+        // The view keeps the mapping and the file alive on its own
+        CloseHandle(mapping);
+        CloseHandle(file);
+        if (!view) throw std::system_error(static_cast<int>(error), std::system_category(), "MapViewOfFile " + path);
+        m_data = static_cast<const char*>(view);
+    } else {
+        CloseHandle(file);
+    }
+}
+
+MappedFile::~MappedFile() noexcept {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+void MappedFile::release(size_t offset, size_t length) noexcept {
+    if (!m_data || offset >= m_size) return;
+    if (length > m_size - offset) length = m_size - offset;
+
+    // Unlocking pages that were never locked removes them from the working set
+    VirtualUnlock(const_cast<char*>(m_data) + offset, length);
+}
+
+void MappedFile::unmap() noexcept {
+    if (m_data) UnmapViewOfFile(m_data);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+} // namespace string_utils
@@ -0,0 +1,185 @@
+#include "multi_matcher.h"
+#include <algorithm>
+#include <utility>
+
+namespace string_utils {
+
+namespace {
+
+// Pointer based trie used only while building, then flattened
+struct TrieNode {
+    std::vector<std::pair<uint8_t, int32_t>> children;
+    std::vector<uint32_t> ids;
+    uint32_t depth = 0;
+};
+
+} // namespace
+
+MultiMatcher::MultiMatcher(const std::vector<std::string_view>& patterns) : m_lengths(patterns.size()) {
+    std::vector<TrieNode> trie(1);
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        m_lengths[id] = patterns[id].size();
+        if (patterns[id].empty()) continue;
+
+        int32_t node = 0;
+        for (char ch : patterns[id]) {
+            uint8_t c = static_cast<uint8_t>(ch);
+            auto& children = trie[node].children;
+            auto it = std::find_if(children.begin(), children.end(),
+                                   [c](const auto& child) { return child.first == c; });
+            if (it != children.end()) {
+                node = it->second;
+                continue;
+            }
+            int32_t child = static_cast<int32_t>(trie.size());
+            children.emplace_back(c, child);
+            trie.push_back(TrieNode{});
+            trie.back().depth = trie[node].depth + 1;
+            node = child;
+        }
+        trie[node].ids.push_back(static_cast<uint32_t>(id));
+    }
+
+    // Number the states breadth first so the hot shallow states sit next to each other
+    std::vector<int32_t> order{0};
+    std::vector<int32_t> renumbered(trie.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto& children = trie[order[i]].children;
+        std::sort(children.begin(), children.end());
+        for (const auto& child : children) {
+            renumbered[child.second] = static_cast<int32_t>(order.size());
+            order.push_back(child.second);
+        }
+    }
+
+    m_states.resize(trie.size());
+    for (size_t s = 0; s < order.size(); ++s) {
+        const TrieNode& node = trie[order[s]];
+        State& state = m_states[s];
+        state.depth = node.depth;
+
+        state.edges_begin = static_cast<uint32_t>(m_edge_bytes.size());
+        for (const auto& child : node.children) {
+            m_edge_bytes.push_back(child.first);
+            m_edge_targets.push_back(renumbered[child.second]);
+        }
+        state.edges_end = static_cast<uint32_t>(m_edge_bytes.size());
+
+        state.outputs_begin = static_cast<uint32_t>(m_outputs.size());
+        m_outputs.insert(m_outputs.end(), node.ids.begin(), node.ids.end());
+        state.outputs_end = static_cast<uint32_t>(m_outputs.size());
+    }
+
+    // Breadth first order means a state's failure target is complete before it is needed
+    m_dense_offset.assign(m_states.size(), none);
+    m_reported.assign(m_states.size(), none);
+    for (size_t s = 0; s < m_states.size(); ++s) {
+        State& state = m_states[s];
+        m_reported[s] = state.outputs_begin != state.outputs_end ? static_cast<int32_t>(s) : state.output_link;
+
+        if (s < dense_states) {
+            m_dense_offset[s] = static_cast<int32_t>(m_dense.size());
+            m_dense.resize(m_dense.size() + 256);
+            int32_t* row = &m_dense[m_dense.size() - 256];
+            for (int c = 0; c < 256; ++c) {
+                row[c] = s == 0 ? 0 : next(state.fail, static_cast<uint8_t>(c));
+            }
+            for (uint32_t e = state.edges_begin; e < state.edges_end; ++e) {
+                row[m_edge_bytes[e]] = m_edge_targets[e];
+            }
+        }
+
+        for (uint32_t e = state.edges_begin; e < state.edges_end; ++e) {
+            State& child = m_states[m_edge_targets[e]];
+            child.fail = s == 0 ? 0 : next(state.fail, m_edge_bytes[e]);
+
+            const State& fail = m_states[child.fail];
+            child.output_link = fail.outputs_begin != fail.outputs_end ? child.fail : fail.output_link;
+        }
+    }
+}
+
+int32_t MultiMatcher::next(int32_t state, uint8_t c) const {
+    while (true) {
+        if (m_dense_offset[state] != none) return m_dense[m_dense_offset[state] + c];
+
+        const State& current = m_states[state];
+        for (uint32_t e = current.edges_begin; e < current.edges_end; ++e) {
+            if (m_edge_bytes[e] == c) return m_edge_targets[e];
+        }
+        state = current.fail;
+    }
+}
+
+int32_t MultiMatcher::longest_output(int32_t state) const {
+    const State& current = m_states[state];
+    if (current.outputs_begin != current.outputs_end) return static_cast<int32_t>(m_outputs[current.outputs_begin]);
+    if (current.output_link == none) return none;
+    return static_cast<int32_t>(m_outputs[m_states[current.output_link].outputs_begin]);
+}
+
+template <typename OnMatch>
+int32_t MultiMatcher::scan(int32_t state, std::string_view text, size_t offset, OnMatch&& on_match) const {
+    for (size_t i = 0; i < text.size(); ++i) {
+        state = next(state, static_cast<uint8_t>(text[i]));
+        if (m_reported[state] == none) continue;
+
+        const State* current = &m_states[m_reported[state]];
+        size_t end = offset + i + 1;
+        while (true) {
+            for (uint32_t o = current->outputs_begin; o < current->outputs_end; ++o) {
+                on_match(Match{m_outputs[o], end - m_lengths[m_outputs[o]]});
+            }
+            if (current->output_link == none) break;
+            current = &m_states[current->output_link];
+        }
+    }
+    return state;
+}
+
+std::vector<MultiMatcher::Match> MultiMatcher::find_all(std::string_view text) const {
+    std::vector<Match> matches;
+    scan(0, text, 0, [&matches](const Match& match) { matches.push_back(match); });
+    return matches;
+}
+
+std::vector<MultiMatcher::Match> MultiMatcher::find_leftmost_longest(std::string_view text) const {
+    std::vector<Match> matches;
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        // Restarting from the root at pos guarantees every candidate starts at or after it
+        bool found = false;
+        Match best{};
+        int32_t state = 0;
+        for (size_t i = pos; i < text.size(); ++i) {
+            state = next(state, static_cast<uint8_t>(text[i]));
+
+            // Nothing that is still in progress can start at or before the best match
+            if (found && i + 1 - m_states[state].depth > best.position) break;
+
+            int32_t id = longest_output(state);
+            if (id == none) continue;
+
+            size_t start = i + 1 - m_lengths[id];
+            if (!found || start < best.position ||
+                (start == best.position && m_lengths[id] > m_lengths[best.pattern])) {
+                best = {static_cast<size_t>(id), start};
+                found = true;
+            }
+        }
+
+        if (!found) break;
+        matches.push_back(best);
+        pos = best.position + m_lengths[best.pattern];
+    }
+
+    return matches;
+}
+
+void MultiMatcher::Stream::feed(std::string_view chunk, std::vector<Match>& matches) {
+    m_state = m_matcher->scan(m_state, chunk, m_offset, [&matches](const Match& match) { matches.push_back(match); });
+    m_offset += chunk.size();
+}
+
+} // namespace string_utils
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace string_utils {
+
+// Finds every occurrence of a set of patterns in one pass over the text (Aho-Corasick).
+// States are numbered breadth first and the first ones, the root levels where most
+// of the time is spent, get a full 256 entry transition row. Deeper states only store
+// their own edges in a flat sorted array and fall back along their failure link.
+class MultiMatcher {
+public:
+    struct Match {
+        size_t pattern;  // index into the patterns given to the constructor
+        size_t position; // start of the match in the text, or in the stream
+    };
+
+    // Empty patterns never match, duplicates are reported under each index
+    explicit MultiMatcher(const std::vector<std::string_view>& patterns);
+
+    size_t pattern_count() const { return m_lengths.size(); }
+    size_t pattern_length(size_t pattern) const { return m_lengths[pattern]; }
+
+    // Every match, overlapping ones included, ordered by end position
+    std::vector<Match> find_all(std::string_view text) const;
+
+    // Non-overlapping matches scanning left to right: the match starting first wins
+    // and among those starting at the same position the longest one
+    std::vector<Match> find_leftmost_longest(std::string_view text) const;
+
+    // Incremental search over text that arrives in chunks. Matches spanning chunk
+    // boundaries are found and positions count from the start of the stream.
+    class Stream {
+    public:
+        explicit Stream(const MultiMatcher& matcher) : m_matcher(&matcher) {}
+
+        // Appends the matches ending inside chunk to matches
+        void feed(std::string_view chunk, std::vector<Match>& matches);
+        void reset() {
+            m_state = 0;
+            m_offset = 0;
+        }
+
+    private:
+        const MultiMatcher* m_matcher;
+        int32_t m_state = 0;
+        size_t m_offset = 0; // stream position of the next chunk
+    };
+
+    Stream stream() const { return Stream(*this); }
+
+private:
+    static constexpr int32_t none = -1;
+    // Number of states, in breadth first order, that get a dense transition row
+    static constexpr size_t dense_states = 256;
+
+    struct State {
+        int32_t fail = 0;
+        uint32_t edges_begin = 0;  // sparse edges in m_edge_bytes/m_edge_targets
+        uint32_t edges_end = 0;
+        uint32_t outputs_begin = 0; // pattern ids ending exactly here
+        uint32_t outputs_end = 0;
+        int32_t output_link = none; // nearest state on the failure chain with outputs
+        uint32_t depth = 0;
+    };
+
+    int32_t next(int32_t state, uint8_t c) const;
+    // Longest pattern that is a suffix of the state, or none
+    int32_t longest_output(int32_t state) const;
+    template <typename OnMatch>
+    int32_t scan(int32_t state, std::string_view text, size_t offset, OnMatch&& on_match) const;
+
+    std::vector<State> m_states;            // state 0 is the root
+    // Hot per-state data kept apart from State so the scan loop touches less memory
+    std::vector<int32_t> m_dense_offset;    // start of the state's row in dense, or none
+    std::vector<int32_t> m_reported;        // first state on the failure chain with outputs, or none
+    std::vector<int32_t> m_dense;           // 256 targets per dense row
+    std::vector<uint8_t> m_edge_bytes;      // sorted per state
+    std::vector<int32_t> m_edge_targets;
+    std::vector<uint32_t> m_outputs;
+    std::vector<size_t> m_lengths;          // pattern lengths by index
+};
+
+} // namespace string_utils
@@ -0,0 +1,117 @@
+#include "numeric_parse.h"
+#include <charconv>
+#include <cstring>
+
+namespace string_utils {
+
+namespace detail {
+
+namespace {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool little_endian = false;
+#else
+constexpr bool little_endian = true;
+#endif
+
+inline uint64_t load8(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// All eight bytes in '0'..'9': the high nibble is 3 and adding 6 does not carry into it
+inline bool is_eight_digits(uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) |
+             (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+}
+
+// Combines eight ASCII digits (first digit in the lowest byte) pairwise, then by four
+inline uint32_t parse_eight_digits(uint64_t v) {
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 100 + (1000000ull << 32);
+    const uint64_t mul2 = 1 + (10000ull << 32);
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(v);
+}
+
+inline bool is_digit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// At most 19 digits, which cannot overflow 64 bits
+bool accumulate(std::string_view digits, uint64_t& value) {
+    size_t i = 0;
+    if (little_endian) {
+        for (; i + 8 <= digits.size(); i += 8) {
+            uint64_t chunk = load8(digits.data() + i);
+            if (!is_eight_digits(chunk)) return false;
+            value = value * 100000000 + parse_eight_digits(chunk);
+        }
+    }
+    for (; i < digits.size(); ++i) {
+        if (!is_digit(digits[i])) return false;
+        value = value * 10 + static_cast<uint64_t>(digits[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+std::errc parse_digits(std::string_view digits, uint64_t& value) {
+    if (digits.empty()) return std::errc::invalid_argument;
+
+    // Leading zeros do not count towards the 20 digits a uint64_t can hold
+    size_t zeros = 0;
+    while (zeros < digits.size() && digits[zeros] == '0') ++zeros;
+    std::string_view significant = digits.substr(zeros);
+
+    uint64_t result = 0;
+    if (significant.size() <= 19) {
+        if (!accumulate(significant, result)) return std::errc::invalid_argument;
+        value = result;
+        return std::errc{};
+    }
+
+    if (!accumulate(significant.substr(0, 19), result)) return std::errc::invalid_argument;
+    for (char c : significant.substr(19)) {
+        if (!is_digit(c)) return std::errc::invalid_argument;
+    }
+    const uint64_t max = std::numeric_limits<uint64_t>::max();
+    uint64_t last = static_cast<uint64_t>(significant[19] - '0');
+    if (significant.size() > 20 || result > (max - last) / 10) return std::errc::result_out_of_range;
+
+    value = result * 10 + last;
+    return std::errc{};
+}
+
+} // namespace detail
+
+std::errc parse_double(std::string_view str, double& value, ParseMode mode) {
+    if (mode == ParseMode::Strict) {
+        // is_numeric() accepts "." and "+." which are not numbers
+        if (!is_numeric(str) || str.find_first_of("0123456789") == std::string_view::npos) {
+            return std::errc::invalid_argument;
+        }
+        if (str[0] == '+') str.remove_prefix(1);
+    }
+
+    const char* last = str.data() + str.size();
+    auto result = std::from_chars(str.data(), last, value);
+    if (result.ec != std::errc{}) return result.ec;
+    return result.ptr == last ? std::errc{} : std::errc::invalid_argument;
+}
+
+std::errc parse_column(const SplitView& fields, std::vector<double>& values, ParseMode mode) {
+    for (std::string_view field : fields) {
+        double value;
+        std::errc ec = parse_double(field, value, mode);
+        if (ec != std::errc{}) return ec;
+        values.push_back(value);
+    }
+    return std::errc{};
+}
+
+} // namespace string_utils
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "string_utilities.h"
+
+// Number parsing that validates and converts in one scan. Functions return
+// std::errc{} on success, std::errc::invalid_argument when the text is not a
+// number and std::errc::result_out_of_range when it does not fit; nothing throws
+// and the locale is never consulted. The whole input must be the number.
+namespace string_utils {
+
+enum class ParseMode {
+    Standard, // std::from_chars rules: '-' but no '+', exponents, inf and nan for floats
+    Strict    // is_numeric() rules: optional '+' or '-', digits and at most one '.'
+};
+
+template <typename T>
+std::errc parse_int(std::string_view str, T& value, ParseMode mode = ParseMode::Standard);
+
+std::errc parse_double(std::string_view str, double& value, ParseMode mode = ParseMode::Standard);
+
+// Parses every field and appends it to values. Stops at the first bad field and
+// returns its error, values then ends with the fields before it.
+std::errc parse_column(const SplitView& fields, std::vector<double>& values,
+                       ParseMode mode = ParseMode::Standard);
+
+namespace detail {
+
+// Unsigned decimal digits only, eight at a time where possible
+std::errc parse_digits(std::string_view digits, uint64_t& value);
+
+} // namespace detail
+
+template <typename T>
+std::errc parse_int(std::string_view str, T& value, ParseMode mode) {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "parse_int needs an integer type");
+
+    bool negative = false;
+    if (!str.empty() && str[0] == '-') {
+        negative = true;
+        str.remove_prefix(1);
+    } else if (mode == ParseMode::Strict && !str.empty() && str[0] == '+') {
+        str.remove_prefix(1);
+    }
+
+    uint64_t magnitude = 0;
+    std::errc ec = detail::parse_digits(str, magnitude);
+    if (ec != std::errc{}) return ec;
+
+    if constexpr (std::is_signed_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+        if (magnitude > limit) return std::errc::result_out_of_range;
+        // Negate in the unsigned type so the most negative value does not overflow
+        value = static_cast<T>(negative ? static_cast<U>(0u - static_cast<U>(magnitude)) : static_cast<U>(magnitude));
+    } else {
+        if (negative) return std::errc::invalid_argument;
+        if (magnitude > std::numeric_limits<T>::max()) return std::errc::result_out_of_range;
+        value = static_cast<T>(magnitude);
+    }
+    return std::errc{};
+}
+
+} // namespace string_utils
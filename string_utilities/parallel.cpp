@@ -0,0 +1,130 @@
+#include "parallel.h"
+#include <algorithm>
+#include "simd_scan.h"
+#include "string_utilities.h"
+
+namespace string_utils {
+
+namespace {
+
+// A few chunks per thread so a slow chunk does not leave the other threads idle
+size_t chunk_size_for(size_t size, const ThreadPool& pool) {
+    return std::max(detail::parallel_min_chunk, size / (pool.size() * 4) + 1);
+}
+
+struct CountResult {
+    size_t count = 0;
+    size_t next = 0; // first position the next match may start at
+};
+
+// Non-overlapping matches starting in [from, end), scanning from left to right
+// exactly like count_occurrences(). A match may run past end.
+CountResult count_range(std::string_view str, std::string_view pattern, size_t from, size_t end) {
+    // Matches that start before end finish before end + pattern.size() - 1
+    std::string_view window = str.substr(0, std::min(str.size(), end + pattern.size() - 1));
+
+    CountResult result{0, from};
+    size_t pos = from;
+    while ((pos = detail::find_substring(window, pattern, pos)) != std::string_view::npos) {
+        ++result.count;
+        pos += pattern.size();
+        result.next = pos;
+    }
+    return result;
+}
+
+} // namespace
+
+std::vector<std::string> parallel_split(std::string_view str, char delimiter, ThreadPool& pool) {
+    return detail::parallel_split_chunked(str, delimiter, pool, chunk_size_for(str.size(), pool));
+}
+
+std::vector<std::string> parallel_split(std::string_view str, char delimiter) {
+    return parallel_split(str, delimiter, default_thread_pool());
+}
+
+size_t parallel_count_occurrences(std::string_view str, std::string_view pattern, ThreadPool& pool) {
+    return detail::parallel_count_chunked(str, pattern, pool, chunk_size_for(str.size(), pool));
+}
+
+size_t parallel_count_occurrences(std::string_view str, std::string_view pattern) {
+    return parallel_count_occurrences(str, pattern, default_thread_pool());
+}
+
+namespace detail {
+
+std::vector<std::string> parallel_split_chunked(std::string_view str, char delimiter, ThreadPool& pool,
+                                                size_t chunk_size) {
+    if (chunk_size == 0 || str.size() <= chunk_size) return split(std::string(str), delimiter);
+
+    // Single byte delimiters cannot straddle a chunk boundary, so every chunk can
+    // look for its own delimiters independently
+    const size_t chunks = (str.size() + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<size_t>> positions(chunks);
+    pool.run(chunks, [&](size_t k) {
+        size_t begin = k * chunk_size;
+        find_char_positions(str.substr(begin, chunk_size), delimiter, positions[k]);
+        for (size_t& pos : positions[k]) pos += begin;
+    });
+
+    // Every delimiter ends one token. Token numbering and the start of the first
+    // token of each chunk only depend on the chunks before it.
+    std::vector<size_t> first_token(chunks);
+    std::vector<size_t> first_start(chunks);
+    size_t tokens = 0;
+    size_t start = 0;
+    for (size_t k = 0; k < chunks; ++k) {
+        first_token[k] = tokens;
+        first_start[k] = start;
+        tokens += positions[k].size();
+        if (!positions[k].empty()) start = positions[k].back() + 1;
+    }
+    // Same trailing token rule as split()
+    const bool trailing = start < str.size() || tokens == 0;
+
+    std::vector<std::string> result(tokens + (trailing ? 1 : 0));
+    pool.run(chunks, [&](size_t k) {
+        size_t token = first_token[k];
+        size_t from = first_start[k];
+        for (size_t pos : positions[k]) {
+            result[token++].assign(str.data() + from, pos - from);
+            from = pos + 1;
+        }
+    });
+    if (trailing) result.back().assign(str.data() + start, str.size() - start);
+
+    return result;
+}
+
+size_t parallel_count_chunked(std::string_view str, std::string_view pattern, ThreadPool& pool,
+                              size_t chunk_size) {
+    if (pattern.empty()) return 0;
+    if (chunk_size == 0 || str.size() <= chunk_size) return count_occurrences(str, pattern);
+
+    // Every chunk counts the matches that start inside it, reading up to
+    // pattern.size() - 1 bytes into the next chunk to finish them
+    const size_t chunks = (str.size() + chunk_size - 1) / chunk_size;
+    std::vector<CountResult> counts(chunks);
+    pool.run(chunks, [&](size_t k) {
+        size_t begin = k * chunk_size;
+        counts[k] = count_range(str, pattern, begin, std::min(str.size(), begin + chunk_size));
+    });
+
+    // A chunk counted on its own assumes no match runs into it. When the previous
+    // match does, the chunk is recounted from where that match ends, which only
+    // happens for a match that straddles the boundary.
+    size_t total = 0;
+    size_t next = 0;
+    for (size_t k = 0; k < chunks; ++k) {
+        size_t begin = k * chunk_size;
+        size_t end = std::min(str.size(), begin + chunk_size);
+        CountResult chunk = next > begin ? count_range(str, pattern, std::min(next, end), end) : counts[k];
+        total += chunk.count;
+        next = std::max(next, chunk.next);
+    }
+    return total;
+}
+
+} // namespace detail
+
+} // namespace string_utils
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "thread_pool.h"
+
+namespace string_utils {
+
+// Multi-threaded versions of split() and count_occurrences() for buffers of hundreds
+// of megabytes and more. The input is cut into chunks that are scanned on a
+// ThreadPool and the results are stitched together in order, so they are identical
+// to the single-threaded functions. Small inputs are handled on the calling thread.
+
+std::vector<std::string> parallel_split(std::string_view str, char delimiter, ThreadPool& pool);
+std::vector<std::string> parallel_split(std::string_view str, char delimiter);
+
+size_t parallel_count_occurrences(std::string_view str, std::string_view pattern, ThreadPool& pool);
+size_t parallel_count_occurrences(std::string_view str, std::string_view pattern);
+
+namespace detail {
+
+// Smallest chunk worth handing to another thread
+constexpr size_t parallel_min_chunk = 1024 * 1024;
+
+// The parallel algorithms with an explicit chunk size, exposed so tests can force
+// chunk boundaries into small inputs
+std::vector<std::string> parallel_split_chunked(std::string_view str, char delimiter, ThreadPool& pool,
+                                                size_t chunk_size);
+size_t parallel_count_chunked(std::string_view str, std::string_view pattern, ThreadPool& pool,
+                              size_t chunk_size);
+
+} // namespace detail
+
+} // namespace string_utils
@@ -0,0 +1,449 @@
+#include "rope.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "simd_scan.h"
+
+namespace string_utils {
+
+Rope::Rope(std::string text) : m_original(std::move(text)) {
+    if (!m_original.empty()) m_root = make_node(false, 0, m_original.size(), next_priority());
+}
+
+char Rope::operator[](size_t pos) const {
+    int32_t node = m_root;
+    for (;;) {
+        const Node& n = m_nodes[node];
+        size_t left = length(n.left);
+        if (pos < left) {
+            node = n.left;
+        } else if (pos - left < n.length) {
+            return piece(n)[pos - left];
+        } else {
+            pos -= left + n.length;
+            node = n.right;
+        }
+    }
+}
+
+void Rope::insert(size_t pos, std::string_view text) {
+    replace(pos, 0, text);
+}
+
+void Rope::erase(size_t pos, size_t count) {
+    replace(pos, count, {});
+}
+
+void Rope::replace(size_t pos, size_t count, std::string_view text) {
+    check_position(pos);
+    count = std::min(count, size() - pos);
+    if (count == 0 && text.empty()) return;
+
+    int32_t before, rest, replaced, after;
+    split(m_root, pos, before, rest);
+    split(rest, count, replaced, after);
+    release(replaced);
+    int32_t inserted = text.empty() ? none : make_added(text);
+    m_root = merge(merge(before, inserted), after);
+}
+
+void Rope::apply(std::vector<Edit> edits) {
+    const size_t total = size();
+    for (auto& edit : edits) {
+        check_position(edit.position);
+        edit.length = std::min(edit.length, total - edit.position);
+    }
+    // An insertion at the start of a replaced range goes before the replacement
+    std::stable_sort(edits.begin(), edits.end(), [](const Edit& a, const Edit& b) {
+        return a.position < b.position || (a.position == b.position && a.length < b.length);
+    });
+    for (size_t i = 1; i < edits.size(); ++i) {
+        if (edits[i - 1].position + edits[i - 1].length > edits[i].position) {
+            throw std::invalid_argument("Rope::apply: edits overlap");
+        }
+    }
+
+    if (edits.size() * rebuild_ratio >= piece_count()) {
+        rebuild(edits);
+        return;
+    }
+
+    // Back to front, so the positions of the edits still to come do not move
+    std::string_view previous;
+    size_t previous_offset = 0;
+    for (auto edit = edits.rbegin(); edit != edits.rend(); ++edit) {
+        int32_t before, rest, replaced, after;
+        split(m_root, edit->position, before, rest);
+        split(rest, edit->length, replaced, after);
+        release(replaced);
+
+        int32_t inserted = none;
+        if (!edit->text.empty()) {
+            // Edits with the same text, like the replacements of replace_all(), share one copy of it
+            if (edit->text.data() != previous.data() || edit->text.size() != previous.size()) {
+                previous = edit->text;
+                previous_offset = add_text(previous);
+            }
+            inserted = make_node(true, previous_offset, previous.size(), next_priority());
+        }
+        m_root = merge(merge(before, inserted), after);
+    }
+}
+
+void Rope::rebuild(const std::vector<Edit>& edits) {
+    std::vector<Node> pieces;
+    pieces.reserve(piece_count());
+    collect(m_root, pieces);
+
+    // The new piece sequence: the old pieces, cut where the sorted edits begin and end
+    std::vector<Node> result;
+    result.reserve(pieces.size() + 2 * edits.size());
+    auto add = [&result](bool added, size_t offset, size_t length) {
+        Node node;
+        node.added = added;
+        node.offset = offset;
+        node.length = length;
+        result.push_back(node);
+    };
+    size_t index = 0;    // old piece holding position consumed
+    size_t start = 0;    // text position of pieces[index]
+    size_t consumed = 0; // old text handled so far
+    auto advance = [&](size_t until, bool keep) {
+        while (consumed < until) {
+            const Node& piece = pieces[index];
+            const size_t end = std::min(until, start + piece.length);
+            if (keep) add(piece.added, piece.offset + (consumed - start), end - consumed);
+            consumed = end;
+            if (end == start + piece.length) {
+                start = end;
+                ++index;
+            }
+        }
+    };
+
+    std::string_view previous;
+    size_t previous_offset = 0;
+    const size_t total = size();
+    for (const auto& edit : edits) {
+        advance(edit.position, true);
+        if (!edit.text.empty()) {
+            if (edit.text.data() != previous.data() || edit.text.size() != previous.size()) {
+                previous = edit.text;
+                previous_offset = add_text(previous);
+            }
+            add(true, previous_offset, previous.size());
+        }
+        advance(edit.position + edit.length, false);
+    }
+    advance(total, true);
+
+    // Treap over the sequence in linear time: the stack holds the right spine, and a
+    // node with a higher priority takes the part of it with lower ones as left child
+    m_nodes = std::move(result);
+    m_free.clear();
+    std::vector<int32_t> spine;
+    for (int32_t node = 0; node < static_cast<int32_t>(m_nodes.size()); ++node) {
+        m_nodes[node].priority = next_priority();
+        m_nodes[node].total = m_nodes[node].length;
+        int32_t last = none;
+        while (!spine.empty() && m_nodes[spine.back()].priority < m_nodes[node].priority) {
+            last = spine.back();
+            spine.pop_back();
+            update(last);
+        }
+        m_nodes[node].left = last;
+        if (!spine.empty()) m_nodes[spine.back()].right = node;
+        spine.push_back(node);
+    }
+    while (spine.size() > 1) {
+        update(spine.back());
+        spine.pop_back();
+    }
+    m_root = spine.empty() ? none : spine.front();
+    if (!spine.empty()) update(m_root);
+}
+
+void Rope::collect(int32_t node, std::vector<Node>& pieces) const {
+    while (node != none) {
+        collect(m_nodes[node].left, pieces);
+        pieces.push_back(m_nodes[node]);
+        node = m_nodes[node].right;
+    }
+}
+
+std::string Rope::substr(size_t pos, size_t count) const {
+    check_position(pos);
+    count = std::min(count, size() - pos);
+    std::string result;
+    result.reserve(count);
+    append_range(m_root, pos, pos + count, result);
+    return result;
+}
+
+std::string Rope::str() const {
+    std::string result;
+    flatten_into(result);
+    return result;
+}
+
+void Rope::flatten_into(std::string& out) const {
+    out.clear();
+    out.reserve(size());
+    for_each_piece([&out](std::string_view piece) {
+        out.append(piece);
+        return true;
+    });
+}
+
+void Rope::compact() {
+    std::string text = str();
+    m_added.clear();
+    m_nodes.clear();
+    m_free.clear();
+    m_original = std::move(text);
+    m_root = m_original.empty() ? none : make_node(false, 0, m_original.size(), next_priority());
+}
+
+uint32_t Rope::next_priority() {
+    // xorshift32, the treap only needs priorities that do not follow the positions
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return m_seed;
+}
+
+int32_t Rope::make_node(bool added, size_t offset, size_t length, uint32_t priority) {
+    Node node;
+    node.priority = priority;
+    node.added = added;
+    node.offset = offset;
+    node.length = length;
+    node.total = length;
+    if (!m_free.empty()) {
+        int32_t index = m_free.back();
+        m_free.pop_back();
+        m_nodes[index] = node;
+        return index;
+    }
+    m_nodes.push_back(node);
+    return static_cast<int32_t>(m_nodes.size() - 1);
+}
+
+size_t Rope::add_text(std::string_view text) {
+    const size_t offset = m_added.size();
+    if (text.data() >= m_added.data() && text.data() < m_added.data() + m_added.size()) {
+        // Text from the insert buffer itself would move when the buffer grows
+        m_added.append(std::string(text));
+    } else {
+        m_added.append(text);
+    }
+    return offset;
+}
+
+int32_t Rope::make_added(std::string_view text) {
+    return make_node(true, add_text(text), text.size(), next_priority());
+}
+
+void Rope::update(int32_t node) {
+    Node& n = m_nodes[node];
+    n.total = length(n.left) + n.length + length(n.right);
+}
+
+void Rope::split(int32_t tree, size_t pos, int32_t& left, int32_t& right) {
+    if (tree == none) {
+        left = right = none;
+        return;
+    }
+    // Indices rather than references, cutting a piece may reallocate m_nodes
+    const size_t left_length = length(m_nodes[tree].left);
+    const size_t piece_end = left_length + m_nodes[tree].length;
+    if (pos <= left_length) {
+        int32_t inner_left, inner_right;
+        split(m_nodes[tree].left, pos, inner_left, inner_right);
+        m_nodes[tree].left = inner_right;
+        update(tree);
+        left = inner_left;
+        right = tree;
+    } else if (pos >= piece_end) {
+        int32_t inner_left, inner_right;
+        split(m_nodes[tree].right, pos - piece_end, inner_left, inner_right);
+        m_nodes[tree].right = inner_left;
+        update(tree);
+        left = tree;
+        right = inner_right;
+    } else {
+        // The cut falls inside this piece: its tail becomes a node that takes over the
+        // right subtree, with the same priority so the heap order holds
+        const size_t cut = pos - left_length;
+        const Node& n = m_nodes[tree];
+        int32_t tail = make_node(n.added, n.offset + cut, n.length - cut, n.priority);
+        m_nodes[tail].right = m_nodes[tree].right;
+        update(tail);
+        m_nodes[tree].right = none;
+        m_nodes[tree].length = cut;
+        update(tree);
+        left = tree;
+        right = tail;
+    }
+}
+
+int32_t Rope::merge(int32_t left, int32_t right) {
+    if (left == none) return right;
+    if (right == none) return left;
+    if (m_nodes[left].priority >= m_nodes[right].priority) {
+        int32_t merged = merge(m_nodes[left].right, right);
+        m_nodes[left].right = merged;
+        update(left);
+        return left;
+    }
+    int32_t merged = merge(left, m_nodes[right].left);
+    m_nodes[right].left = merged;
+    update(right);
+    return right;
+}
+
+void Rope::release(int32_t tree) {
+    while (tree != none) {
+        release(m_nodes[tree].left);
+        m_free.push_back(tree);
+        tree = m_nodes[tree].right;
+    }
+}
+
+void Rope::check_position(size_t pos) const {
+    if (pos > size()) throw std::out_of_range("Rope: position past the end");
+}
+
+void Rope::append_range(int32_t node, size_t pos, size_t end, std::string& out) const {
+    // pos and end are relative to the subtree, subtrees outside them are skipped
+    while (node != none && pos < end) {
+        const Node& n = m_nodes[node];
+        const size_t left = length(n.left);
+        if (pos < left) append_range(n.left, pos, std::min(end, left), out);
+        if (end > left && pos < left + n.length) {
+            const size_t from = pos > left ? pos - left : 0;
+            out.append(piece(n).substr(from, std::min(end - left, n.length) - from));
+        }
+        if (end <= left + n.length) return;
+        pos = pos > left + n.length ? pos - left - n.length : 0;
+        end -= left + n.length;
+        node = n.right;
+    }
+}
+
+namespace {
+
+// Pieces shorter than this are copied together and searched as one, rather than
+// paying for a search call and a boundary check on each of them
+constexpr size_t small_piece = 256;
+constexpr size_t scratch_size = 16 * 1024;
+
+// Calls on_match with the start of every match, overlapping ones included, until it
+// returns false. Small pieces are gathered in a scratch buffer that keeps the last
+// pattern.size() - 1 bytes between searches, so matches spanning pieces are found.
+// Large pieces are searched where they are, after the buffer has been searched
+// together with their first bytes for the matches that start before them.
+template <typename OnMatch>
+void for_each_match(const Rope& rope, std::string_view pattern, OnMatch&& on_match) {
+    const size_t keep = pattern.size() - 1;
+    std::string scratch;
+    size_t scratch_start = 0; // text position of scratch[0]
+    size_t offset = 0;        // text position of the current piece
+
+    // Reports the matches in scratch starting before limit
+    auto search_scratch = [&](size_t limit) {
+        for (size_t pos = detail::find_substring(scratch, pattern, 0); pos < limit;
+             pos = detail::find_substring(scratch, pattern, pos + 1)) {
+            if (!on_match(scratch_start + pos)) return false;
+        }
+        return true;
+    };
+    auto keep_tail = [&] {
+        if (scratch.size() > keep) {
+            scratch_start += scratch.size() - keep;
+            scratch.erase(0, scratch.size() - keep);
+        }
+    };
+
+    bool finished = rope.for_each_piece([&](std::string_view piece) {
+        if (piece.size() < small_piece) {
+            scratch.append(piece);
+            offset += piece.size();
+            if (scratch.size() < scratch_size) return true;
+            if (!search_scratch(std::string_view::npos)) return false;
+            keep_tail();
+            return true;
+        }
+
+        // Only a buffer holding the first pattern byte can start a match that ends in the piece
+        const size_t before = scratch.size();
+        if (std::memchr(scratch.data(), pattern[0], before) != nullptr) {
+            scratch.append(piece.substr(0, keep));
+            if (!search_scratch(before)) return false;
+        }
+        for (size_t pos = detail::find_substring(piece, pattern, 0); pos != std::string_view::npos;
+             pos = detail::find_substring(piece, pattern, pos + 1)) {
+            if (!on_match(offset + pos)) return false;
+        }
+        scratch.resize(before);
+        if (piece.size() >= keep) {
+            scratch.assign(piece.substr(piece.size() - keep));
+            scratch_start = offset + piece.size() - keep;
+        } else {
+            scratch.append(piece);
+            keep_tail();
+        }
+        offset += piece.size();
+        return true;
+    });
+    if (finished) search_scratch(std::string_view::npos);
+}
+
+} // namespace
+
+std::vector<size_t> find_all(const Rope& rope, std::string_view pattern) {
+    std::vector<size_t> positions;
+    if (pattern.empty()) {
+        // Like find_all() on a string, an empty pattern matches at every position
+        for (size_t pos = 0; pos <= rope.size(); ++pos) positions.push_back(pos);
+        return positions;
+    }
+    for_each_match(rope, pattern, [&positions](size_t pos) {
+        positions.push_back(pos);
+        return true;
+    });
+    return positions;
+}
+
+size_t replace_all(Rope& rope, std::string_view from, std::string_view to) {
+    if (from.empty()) return 0;
+
+    std::vector<Rope::Edit> edits;
+    size_t next = 0;
+    for_each_match(rope, from, [&](size_t pos) {
+        // Matches do not overlap, the one starting first wins
+        if (pos >= next) {
+            edits.push_back(Rope::Edit{pos, from.size(), to});
+            next = pos + from.size();
+        }
+        return true;
+    });
+    const size_t count = edits.size();
+    rope.apply(std::move(edits));
+    return count;
+}
+
+bool replace_first(Rope& rope, std::string_view from, std::string_view to) {
+    if (from.empty()) return false;
+
+    size_t first = std::string_view::npos;
+    for_each_match(rope, from, [&first](size_t pos) {
+        first = pos;
+        return false;
+    });
+    if (first == std::string_view::npos) return false;
+    rope.replace(first, from.size(), to);
+    return true;
+}
+
+} // namespace string_utils
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace string_utils {
+
+// A string for many edits, kept as a piece table: the text is a sequence of pieces,
+// each a range of either the original text or of an append-only buffer holding all
+// inserted text. The pieces are the nodes of a treap ordered by position with the
+// byte count of every subtree, so insert, erase and replace split and merge it in
+// O(log pieces) without copying the text around them.
+class Rope {
+public:
+    // One replacement of a batch, positions refer to the text before the batch
+    struct Edit {
+        size_t position;
+        size_t length;         // bytes replaced, 0 for a plain insertion
+        std::string_view text; // replacement, empty for a plain erase
+    };
+
+    Rope() = default;
+    explicit Rope(std::string text);
+
+    size_t size() const { return length(m_root); }
+    bool empty() const { return size() == 0; }
+    // Number of pieces, grows with every edit until the rope is compacted
+    size_t piece_count() const { return m_nodes.size() - m_free.size(); }
+
+    // Byte at pos, which must be less than size()
+    char operator[](size_t pos) const;
+
+    // Positions past size() throw std::out_of_range, counts are clamped to the end
+    // like std::string's
+    void insert(size_t pos, std::string_view text);
+    void erase(size_t pos, size_t count = std::string::npos);
+    void replace(size_t pos, size_t count, std::string_view text);
+
+    // Applies edits that do not overlap, in any order, as if all were made at once.
+    // Throws std::invalid_argument if two of them overlap and std::out_of_range if
+    // one starts past size().
+    void apply(std::vector<Edit> edits);
+
+    std::string substr(size_t pos, size_t count = std::string::npos) const;
+
+    // The whole text in one contiguous buffer
+    std::string str() const;
+    void flatten_into(std::string& out) const;
+
+    // Replaces the pieces and the insert buffer with one piece of the flattened text
+    void compact();
+
+    // Calls visit with every piece as a std::string_view, in order, until it returns false.
+    // Returns false if it was stopped.
+    template <typename Visit>
+    bool for_each_piece(Visit&& visit) const {
+        return visit_pieces(m_root, visit);
+    }
+
+private:
+    static constexpr int32_t none = -1;
+    // Batches with at least one edit per this many pieces rebuild the tree in one pass
+    static constexpr size_t rebuild_ratio = 8;
+    // Stack depth of the piece traversal before it spills to the heap, treaps of a
+    // billion pieces are about 60 deep on average
+    static constexpr size_t max_depth = 128;
+
+    struct Node {
+        int32_t left = none;
+        int32_t right = none;
+        uint32_t priority = 0;
+        bool added = false; // in m_added rather than m_original
+        size_t offset = 0;  // start of the piece in its buffer
+        size_t length = 0;  // bytes in the piece
+        size_t total = 0;   // bytes in the subtree
+    };
+
+    size_t length(int32_t node) const { return node == none ? 0 : m_nodes[node].total; }
+    std::string_view piece(const Node& node) const {
+        return std::string_view((node.added ? m_added : m_original).data() + node.offset, node.length);
+    }
+
+    int32_t make_node(bool added, size_t offset, size_t length, uint32_t priority);
+    uint32_t next_priority();
+    // Appends text to m_added, returns its offset there
+    size_t add_text(std::string_view text);
+    int32_t make_added(std::string_view text);
+    void update(int32_t node);
+    // Splits tree into the first pos bytes and the rest, cutting a piece if needed
+    void split(int32_t tree, size_t pos, int32_t& left, int32_t& right);
+    int32_t merge(int32_t left, int32_t right);
+    void release(int32_t tree);
+    void rebuild(const std::vector<Edit>& edits);
+    void collect(int32_t node, std::vector<Node>& pieces) const;
+    void check_position(size_t pos) const;
+
+    void append_range(int32_t node, size_t pos, size_t end, std::string& out) const;
+
+    template <typename Visit>
+    bool visit_pieces(int32_t node, Visit& visit) const {
+        // In order with an explicit stack of the nodes whose left subtree is being visited
+        int32_t stack[max_depth];
+        size_t depth = 0;
+        std::vector<int32_t> deep; // only if the treap is far out of balance
+        for (;;) {
+            while (node != none) {
+                if (depth < max_depth) {
+                    stack[depth++] = node;
+                } else {
+                    deep.push_back(node);
+                }
+                node = m_nodes[node].left;
+            }
+            if (!deep.empty()) {
+                node = deep.back();
+                deep.pop_back();
+            } else if (depth > 0) {
+                node = stack[--depth];
+            } else {
+                return true;
+            }
+            const Node& n = m_nodes[node];
+            if (!visit(piece(n))) return false;
+            node = n.right;
+        }
+    }
+
+    std::string m_original;
+    std::string m_added;
+    std::vector<Node> m_nodes;
+    std::vector<int32_t> m_free; // indices of released nodes
+    int32_t m_root = none;
+    uint32_t m_seed = 0x9E3779B9u;
+};
+
+// Start of every match in the rope, overlapping ones included, like find_all() on
+// the flattened text. Matches spanning pieces are found too.
+std::vector<size_t> find_all(const Rope& rope, std::string_view pattern);
+
+// Replaces the matches in place, chosen like replace_all() on the flattened text.
+// Returns the number of replacements made, 0 for an empty from.
+size_t replace_all(Rope& rope, std::string_view from, std::string_view to);
+
+// Replaces the first match in place, like replace_first() on the flattened text.
+// Returns whether there was one to replace, false for an empty from.
+bool replace_first(Rope& rope, std::string_view from, std::string_view to);
+
+} // namespace string_utils
@@ -0,0 +1,67 @@
+#include "searcher.h"
+#include "simd_scan.h"
+#include <cstdint>
+#include <cstring>
+
+namespace string_utils {
+
+Searcher::Searcher(std::string_view pattern) : m_pattern(pattern) {
+    if (m_pattern.size() <= short_pattern) return;
+
+    // Distance from the last occurrence of each byte to the end of the pattern,
+    // the final byte itself does not count
+    const size_t m = m_pattern.size();
+    m_shift.fill(m);
+    for (size_t i = 0; i + 1 < m; ++i) {
+        m_shift[static_cast<uint8_t>(m_pattern[i])] = m - 1 - i;
+    }
+}
+
+size_t Searcher::find(std::string_view text, size_t from) const {
+    if (m_pattern.size() <= short_pattern) return detail::find_substring(text, m_pattern, from);
+    return find_horspool(text, from);
+}
+
+size_t Searcher::find_horspool(std::string_view text, size_t from) const {
+    const size_t m = m_pattern.size();
+    if (from > text.size() || text.size() - from < m) return std::string_view::npos;
+
+    const char* data = text.data();
+    const char last = m_pattern.back();
+    for (size_t pos = from; pos + m <= text.size();) {
+        char c = data[pos + m - 1];
+        if (c == last && std::memcmp(data + pos, m_pattern.data(), m - 1) == 0) return pos;
+        pos += m_shift[static_cast<uint8_t>(c)];
+    }
+    return std::string_view::npos;
+}
+
+std::vector<size_t> Searcher::find_all(std::string_view text) const {
+    std::vector<size_t> positions;
+    if (m_pattern.size() == 1) {
+        detail::find_char_positions(text, m_pattern[0], positions);
+        return positions;
+    }
+
+    size_t pos = find(text, 0);
+    while (pos != std::string_view::npos) {
+        positions.push_back(pos);
+        pos = find(text, pos + 1);
+    }
+    return positions;
+}
+
+size_t Searcher::count(std::string_view text, Overlap overlap) const {
+    if (m_pattern.empty()) return 0;
+
+    const size_t step = overlap == Overlap::Allowed ? 1 : m_pattern.size();
+    size_t count = 0;
+    size_t pos = 0;
+    while ((pos = find(text, pos)) != std::string_view::npos) {
+        ++count;
+        pos += step;
+    }
+    return count;
+}
+
+} // namespace string_utils
@@ -0,0 +1,41 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace string_utils {
+
+// A pattern preprocessed once and then searched for in any number of texts.
+// Short patterns use a vectorized first/last byte filter, longer ones
+// Boyer-Moore-Horspool with a precomputed bad character table.
+class Searcher {
+public:
+    enum class Overlap { Allowed, Disallowed };
+
+    explicit Searcher(std::string_view pattern);
+
+    const std::string& pattern() const { return m_pattern; }
+
+    // Position of the first match at or after from, or npos
+    size_t find(std::string_view text, size_t from = 0) const;
+    bool contains(std::string_view text) const { return find(text) != std::string_view::npos; }
+
+    // Start of every match, overlapping ones included, like string_utils::find_all()
+    std::vector<size_t> find_all(std::string_view text) const;
+
+    // Number of matches, an empty pattern never matches like string_utils::count_occurrences()
+    size_t count(std::string_view text, Overlap overlap = Overlap::Disallowed) const;
+
+private:
+    // Longest pattern searched with the vector filter instead of Horspool
+    static constexpr size_t short_pattern = 32;
+
+    size_t find_horspool(std::string_view text, size_t from) const;
+
+    std::string m_pattern;
+    std::array<size_t, 256> m_shift{}; // only filled in for long patterns
+};
+
+} // namespace string_utils
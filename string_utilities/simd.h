@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+
+// Internal helpers shared by the vectorized kernels.
+// SSE2 is part of the x86-64 baseline and is used unconditionally when the compiler
+// targets it; AVX2 kernels are compiled with a target attribute and only selected
+// at runtime when the CPU supports them (GCC/Clang only, MSVC stays on SSE2).
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_UTILS_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define STRING_UTILS_HAS_SSE2 0
+#endif
+
+#if STRING_UTILS_HAS_SSE2 && (defined(__GNUC__) || defined(__clang__))
+#define STRING_UTILS_HAS_AVX2 1
+#define STRING_UTILS_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#else
+#define STRING_UTILS_HAS_AVX2 0
+#define STRING_UTILS_TARGET_AVX2
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace string_utils::detail {
+
+inline bool cpu_has_avx2() {
+#if STRING_UTILS_HAS_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+#else
+    return false;
+#endif
+}
+
+// Index of the lowest set bit, mask must not be zero
+inline int count_trailing_zeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+inline int count_trailing_zeros64(uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Index of the highest set bit counted from bit 31, mask must not be zero
+inline int count_leading_zeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return 31 - static_cast<int>(index);
+#else
+    return __builtin_clz(mask);
+#endif
+}
+
+} // namespace string_utils::detail
@@ -0,0 +1,311 @@
+#include "simd_ascii.h"
+#include <cstdint>
+
+namespace string_utils::detail {
+
+namespace {
+
+// Unsigned range checks written so the compiler emits no branches
+inline bool in_range(uint8_t c, uint8_t first, uint8_t count) {
+    return static_cast<uint8_t>(c - first) < count;
+}
+
+inline bool byte_in_class(uint8_t c, CharClass cls) {
+    bool alpha = in_range(c | 0x20, 'a', 26);
+    bool digit = in_range(c, '0', 10);
+    switch (cls) {
+    case CharClass::Alpha: return alpha;
+    case CharClass::Digit: return digit;
+    case CharClass::Alnum: return alpha | digit;
+    }
+    return false;
+}
+
+} // namespace
+
+void convert_case_scalar(const char* src, char* dst, size_t n, bool upper) {
+    const uint8_t first = upper ? 'a' : 'A';
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t c = static_cast<uint8_t>(src[i]);
+        dst[i] = static_cast<char>(c ^ (in_range(c, first, 26) << 5));
+    }
+}
+
+bool all_of_class_scalar(std::string_view str, CharClass cls) {
+    for (char c : str) {
+        if (!byte_in_class(static_cast<uint8_t>(c), cls)) return false;
+    }
+    return true;
+}
+
+bool equal_ignore_case_scalar(const char* a, const char* b, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (fold_ascii(a[i]) != fold_ascii(b[i])) return false;
+    }
+    return true;
+}
+
+size_t find_ignore_case_scalar(std::string_view str, std::string_view pattern, size_t from) {
+    const size_t m = pattern.size();
+    if (from > str.size() || str.size() - from < m) return std::string_view::npos;
+    for (size_t i = from; i + m <= str.size(); ++i) {
+        if (equal_ignore_case_scalar(str.data() + i, pattern.data(), m)) return i;
+    }
+    return std::string_view::npos;
+}
+
+#if STRING_UTILS_HAS_SSE2
+namespace {
+
+// Bytes are biased by 0x80 so a signed compare acts as the unsigned c - first < count
+inline __m128i in_range_sse2(__m128i v, char first, char count) {
+    __m128i biased = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+    return _mm_cmplt_epi8(biased, _mm_set1_epi8(static_cast<char>(0x80 + count)));
+}
+
+// Lower case letters, other bytes unchanged
+inline __m128i fold_sse2(__m128i v) {
+    return _mm_or_si128(v, _mm_and_si128(in_range_sse2(v, 'A', 26), _mm_set1_epi8(0x20)));
+}
+
+inline __m128i class_mask_sse2(__m128i v, CharClass cls) {
+    __m128i alpha = in_range_sse2(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26);
+    __m128i digit = in_range_sse2(v, '0', 10);
+    switch (cls) {
+    case CharClass::Alpha: return alpha;
+    case CharClass::Digit: return digit;
+    case CharClass::Alnum: return _mm_or_si128(alpha, digit);
+    }
+    return _mm_setzero_si128();
+}
+
+} // namespace
+
+void convert_case_sse2(const char* src, char* dst, size_t n, bool upper) {
+    const char first = upper ? 'a' : 'A';
+    const __m128i flip = _mm_set1_epi8(0x20);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i letters = in_range_sse2(v, first, 26);
+        v = _mm_xor_si128(v, _mm_and_si128(letters, flip));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    convert_case_scalar(src + i, dst + i, n - i, upper);
+}
+
+bool all_of_class_sse2(std::string_view str, CharClass cls) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (_mm_movemask_epi8(class_mask_sse2(v, cls)) != 0xFFFF) return false;
+    }
+    return all_of_class_scalar(str.substr(i), cls);
+}
+
+bool equal_ignore_case_sse2(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m128i vb = fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) return false;
+    }
+    return equal_ignore_case_scalar(a + i, b + i, n - i);
+}
+
+// Candidates are found by comparing the folded first and last pattern byte across a
+// whole vector, like find_substring_sse2(). A single byte pattern needs no verification.
+size_t find_ignore_case_sse2(std::string_view str, std::string_view pattern, size_t from) {
+    const size_t m = pattern.size();
+    if (m == 0 || from > str.size() || str.size() - from < m) {
+        return find_ignore_case_scalar(str, pattern, from);
+    }
+
+    const char* data = str.data();
+    const __m128i first = _mm_set1_epi8(fold_ascii(pattern.front()));
+    const __m128i last = _mm_set1_epi8(fold_ascii(pattern.back()));
+
+    size_t i = from;
+    for (; i + m + 15 <= str.size(); i += 16) {
+        __m128i block_first = fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        __m128i block_last = fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + m - 1)));
+        __m128i candidates = _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(candidates));
+        while (mask) {
+            size_t pos = i + count_trailing_zeros(mask);
+            if (m < 2 || equal_ignore_case_sse2(data + pos + 1, pattern.data() + 1, m - 2)) return pos;
+            mask &= mask - 1;
+        }
+    }
+    return find_ignore_case_scalar(str, pattern, i);
+}
+#endif
+
+#if STRING_UTILS_HAS_AVX2
+namespace {
+
+STRING_UTILS_TARGET_AVX2
+inline __m256i in_range_avx2(__m256i v, char first, char count) {
+    __m256i biased = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + count)), biased);
+}
+
+STRING_UTILS_TARGET_AVX2
+inline __m256i fold_avx2(__m256i v) {
+    return _mm256_or_si256(v, _mm256_and_si256(in_range_avx2(v, 'A', 26), _mm256_set1_epi8(0x20)));
+}
+
+// Compared inline rather than by calling the SSE2 kernel, which would run legacy SSE
+// instructions while the search loop keeps values in the upper ymm halves
+STRING_UTILS_TARGET_AVX2
+inline bool equal_folded_avx2(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i va = fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        __m256i vb = fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb))) != 0xFFFFFFFFu) return false;
+    }
+    for (; i < n; ++i) {
+        if (fold_ascii(a[i]) != fold_ascii(b[i])) return false;
+    }
+    return true;
+}
+
+STRING_UTILS_TARGET_AVX2
+inline __m256i class_mask_avx2(__m256i v, CharClass cls) {
+    __m256i alpha = in_range_avx2(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 26);
+    __m256i digit = in_range_avx2(v, '0', 10);
+    switch (cls) {
+    case CharClass::Alpha: return alpha;
+    case CharClass::Digit: return digit;
+    case CharClass::Alnum: return _mm256_or_si256(alpha, digit);
+    }
+    return _mm256_setzero_si256();
+}
+
+} // namespace
+
+STRING_UTILS_TARGET_AVX2
+void convert_case_avx2(const char* src, char* dst, size_t n, bool upper) {
+    const char first = upper ? 'a' : 'A';
+    const __m256i flip = _mm256_set1_epi8(0x20);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i letters = in_range_avx2(v, first, 26);
+        v = _mm256_xor_si256(v, _mm256_and_si256(letters, flip));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    }
+    convert_case_sse2(src + i, dst + i, n - i, upper);
+}
+
+STRING_UTILS_TARGET_AVX2
+bool all_of_class_avx2(std::string_view str, CharClass cls) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(class_mask_avx2(v, cls))) != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return all_of_class_sse2(str.substr(i), cls);
+}
+
+STRING_UTILS_TARGET_AVX2
+bool equal_ignore_case_avx2(const char* a, const char* b, size_t n) {
+    return equal_folded_avx2(a, b, n);
+}
+
+STRING_UTILS_TARGET_AVX2
+size_t find_ignore_case_avx2(std::string_view str, std::string_view pattern, size_t from) {
+    const size_t m = pattern.size();
+    if (m == 0 || from > str.size() || str.size() - from < m) {
+        return find_ignore_case_scalar(str, pattern, from);
+    }
+
+    const char* data = str.data();
+    const __m256i first = _mm256_set1_epi8(fold_ascii(pattern.front()));
+    const __m256i last = _mm256_set1_epi8(fold_ascii(pattern.back()));
+
+    size_t i = from;
+    for (; i + m + 31 <= str.size(); i += 32) {
+        __m256i block_first = fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        __m256i block_last = fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + m - 1)));
+        __m256i candidates = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first),
+                                              _mm256_cmpeq_epi8(block_last, last));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(candidates));
+        while (mask) {
+            size_t pos = i + count_trailing_zeros(mask);
+            if (m < 2 || equal_folded_avx2(data + pos + 1, pattern.data() + 1, m - 2)) return pos;
+            mask &= mask - 1;
+        }
+    }
+    return find_ignore_case_sse2(str, pattern, i);
+}
+#endif
+
+namespace {
+
+void convert_case(const char* src, char* dst, size_t n, bool upper) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return convert_case_avx2(src, dst, n, upper);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    convert_case_sse2(src, dst, n, upper);
+#else
+    convert_case_scalar(src, dst, n, upper);
+#endif
+}
+
+} // namespace
+
+void to_upper_ascii(const char* src, char* dst, size_t n) {
+    convert_case(src, dst, n, true);
+}
+
+void to_lower_ascii(const char* src, char* dst, size_t n) {
+    convert_case(src, dst, n, false);
+}
+
+bool all_of_class(std::string_view str, CharClass cls) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return all_of_class_avx2(str, cls);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return all_of_class_sse2(str, cls);
+#else
+    return all_of_class_scalar(str, cls);
+#endif
+}
+
+bool equal_ignore_case(const char* a, const char* b, size_t n) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return equal_ignore_case_avx2(a, b, n);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return equal_ignore_case_sse2(a, b, n);
+#else
+    return equal_ignore_case_scalar(a, b, n);
+#endif
+}
+
+size_t find_ignore_case(std::string_view str, std::string_view pattern, size_t from) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return find_ignore_case_avx2(str, pattern, from);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return find_ignore_case_sse2(str, pattern, from);
+#else
+    return find_ignore_case_scalar(str, pattern, from);
+#endif
+}
+
+} // namespace string_utils::detail
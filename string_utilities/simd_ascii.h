@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "simd.h"
+
+// Branch-free ASCII case conversion and classification kernels.
+// Bytes outside the ASCII letters are copied unchanged and never classify as
+// alpha or digit, which matches the "C" locale behaviour of <cctype>.
+namespace string_utils::detail {
+
+enum class CharClass { Alpha, Digit, Alnum };
+
+// Converts n bytes from src into dst, src and dst may be the same buffer
+void to_upper_ascii(const char* src, char* dst, size_t n);
+void to_lower_ascii(const char* src, char* dst, size_t n);
+
+// True if every byte of str belongs to the class, also for an empty str
+bool all_of_class(std::string_view str, CharClass cls);
+
+// The byte with an ASCII upper case letter turned into lower case
+inline char fold_ascii(char c) {
+    return static_cast<char>(static_cast<uint8_t>(c - 'A') < 26 ? c | 0x20 : c);
+}
+
+// True if the n bytes at a and b only differ in the case of ASCII letters
+bool equal_ignore_case(const char* a, const char* b, size_t n);
+
+// Position of the first match of pattern at or after from ignoring ASCII case, or npos
+size_t find_ignore_case(std::string_view str, std::string_view pattern, size_t from = 0);
+
+void convert_case_scalar(const char* src, char* dst, size_t n, bool upper);
+bool all_of_class_scalar(std::string_view str, CharClass cls);
+bool equal_ignore_case_scalar(const char* a, const char* b, size_t n);
+size_t find_ignore_case_scalar(std::string_view str, std::string_view pattern, size_t from);
+#if STRING_UTILS_HAS_SSE2
+void convert_case_sse2(const char* src, char* dst, size_t n, bool upper);
+bool all_of_class_sse2(std::string_view str, CharClass cls);
+bool equal_ignore_case_sse2(const char* a, const char* b, size_t n);
+size_t find_ignore_case_sse2(std::string_view str, std::string_view pattern, size_t from);
+#endif
+#if STRING_UTILS_HAS_AVX2
+void convert_case_avx2(const char* src, char* dst, size_t n, bool upper);
+bool all_of_class_avx2(std::string_view str, CharClass cls);
+bool equal_ignore_case_avx2(const char* a, const char* b, size_t n);
+size_t find_ignore_case_avx2(std::string_view str, std::string_view pattern, size_t from);
+#endif
+
+} // namespace string_utils::detail
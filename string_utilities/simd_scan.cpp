@@ -0,0 +1,311 @@
+#include "simd_scan.h"
+#include <cstring>
+
+namespace string_utils::detail {
+
+size_t find_char_scalar(std::string_view str, char ch, size_t from) {
+    for (size_t i = from; i < str.size(); ++i) {
+        if (str[i] == ch) return i;
+    }
+    return std::string_view::npos;
+}
+
+void find_char_positions_scalar(std::string_view str, char ch, std::vector<size_t>& positions) {
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == ch) positions.push_back(i);
+    }
+}
+
+size_t find_substring_scalar(std::string_view str, std::string_view pattern, size_t from) {
+    return str.find(pattern, from);
+}
+
+size_t leading_in_set_scalar(std::string_view str, const CharSet& chars) {
+    size_t i = 0;
+    while (i < str.size() && chars.contains(str[i])) ++i;
+    return i;
+}
+
+size_t trailing_in_set_scalar(std::string_view str, const CharSet& chars) {
+    size_t i = str.size();
+    while (i > 0 && chars.contains(str[i - 1])) --i;
+    return str.size() - i;
+}
+
+#if STRING_UTILS_HAS_SSE2
+size_t find_char_sse2(std::string_view str, char ch, size_t from) {
+    const char* data = str.data();
+    const size_t n = str.size();
+    const __m128i needle = _mm_set1_epi8(ch);
+
+    size_t i = from;
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        if (mask) return i + count_trailing_zeros(mask);
+    }
+    return find_char_scalar(str, ch, i);
+}
+
+void find_char_positions_sse2(std::string_view str, char ch, std::vector<size_t>& positions) {
+    const char* data = str.data();
+    const size_t n = str.size();
+    const __m128i needle = _mm_set1_epi8(ch);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        while (mask) {
+            positions.push_back(i + count_trailing_zeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] == ch) positions.push_back(i);
+    }
+}
+
+size_t find_substring_sse2(std::string_view str, std::string_view pattern, size_t from) {
+    const size_t m = pattern.size();
+    if (m < 2 || from > str.size() || str.size() - from < m) {
+        return find_substring_scalar(str, pattern, from);
+    }
+
+    const char* data = str.data();
+    const __m128i first = _mm_set1_epi8(pattern.front());
+    const __m128i last = _mm_set1_epi8(pattern.back());
+
+    // i + m - 1 + 16 <= size keeps the block holding the last pattern byte in bounds
+    size_t i = from;
+    for (; i + m + 15 <= str.size(); i += 16) {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + m - 1));
+        __m128i candidates = _mm_and_si128(_mm_cmpeq_epi8(block_first, first),
+                                           _mm_cmpeq_epi8(block_last, last));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(candidates));
+        while (mask) {
+            size_t pos = i + count_trailing_zeros(mask);
+            if (std::memcmp(data + pos + 1, pattern.data() + 1, m - 2) == 0) return pos;
+            mask &= mask - 1;
+        }
+    }
+    return find_substring_scalar(str, pattern, i);
+}
+
+// Mask of the bytes in block that are not listed members of chars
+static uint32_t outside_listed(__m128i block, const CharSet& chars) {
+    __m128i members = _mm_setzero_si128();
+    for (size_t k = 0; k < chars.size(); ++k) {
+        members = _mm_or_si128(members, _mm_cmpeq_epi8(block, _mm_set1_epi8(chars.listed()[k])));
+    }
+    return ~static_cast<uint32_t>(_mm_movemask_epi8(members)) & 0xFFFF;
+}
+
+size_t leading_in_set_sse2(std::string_view str, const CharSet& chars) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint32_t mask = outside_listed(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), chars);
+        if (mask) return i + count_trailing_zeros(mask);
+    }
+    return i + leading_in_set_scalar(str.substr(i), chars);
+}
+
+size_t trailing_in_set_sse2(std::string_view str, const CharSet& chars) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    size_t end = n;
+    for (; end >= 16; end -= 16) {
+        uint32_t mask = outside_listed(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end - 16)), chars);
+        if (mask) return 15 - (31 - count_leading_zeros(mask)) + (n - end);
+    }
+    return (n - end) + trailing_in_set_scalar(str.substr(0, end), chars);
+}
+#endif
+
+#if STRING_UTILS_HAS_AVX2
+STRING_UTILS_TARGET_AVX2
+size_t find_char_avx2(std::string_view str, char ch, size_t from) {
+    const char* data = str.data();
+    const size_t n = str.size();
+    const __m256i needle = _mm256_set1_epi8(ch);
+
+    size_t i = from;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        if (mask) return i + count_trailing_zeros(mask);
+    }
+    return find_char_sse2(str, ch, i);
+}
+
+STRING_UTILS_TARGET_AVX2
+void find_char_positions_avx2(std::string_view str, char ch, std::vector<size_t>& positions) {
+    const char* data = str.data();
+    const size_t n = str.size();
+    const __m256i needle = _mm256_set1_epi8(ch);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        while (mask) {
+            positions.push_back(i + count_trailing_zeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] == ch) positions.push_back(i);
+    }
+}
+
+STRING_UTILS_TARGET_AVX2
+size_t find_substring_avx2(std::string_view str, std::string_view pattern, size_t from) {
+    const size_t m = pattern.size();
+    if (m < 2 || from > str.size() || str.size() - from < m) {
+        return find_substring_scalar(str, pattern, from);
+    }
+
+    const char* data = str.data();
+    const __m256i first = _mm256_set1_epi8(pattern.front());
+    const __m256i last = _mm256_set1_epi8(pattern.back());
+
+    size_t i = from;
+    for (; i + m + 31 <= str.size(); i += 32) {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + m - 1));
+        __m256i candidates = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first),
+                                              _mm256_cmpeq_epi8(block_last, last));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(candidates));
+        while (mask) {
+            size_t pos = i + count_trailing_zeros(mask);
+            if (std::memcmp(data + pos + 1, pattern.data() + 1, m - 2) == 0) return pos;
+            mask &= mask - 1;
+        }
+    }
+    return find_substring_sse2(str, pattern, i);
+}
+
+// Mask of the bytes in block that are not members of chars. The low nibble of every
+// byte picks a row of the nibble tables, the high nibble a bit in that row.
+STRING_UTILS_TARGET_AVX2
+static uint32_t outside_set(__m256i block, __m256i low_table, __m256i high_table) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i sign = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m256i bit_table = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                               1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+    __m256i low = _mm256_and_si256(block, nibble);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+    // An index with the sign bit set shuffles in zero, so each table only answers
+    // for its own half of the byte values
+    __m256i top = _mm256_and_si256(block, sign);
+    __m256i rows = _mm256_or_si256(_mm256_shuffle_epi8(low_table, _mm256_or_si256(low, top)),
+                                   _mm256_shuffle_epi8(high_table, _mm256_or_si256(low, _mm256_xor_si256(top, sign))));
+    __m256i hits = _mm256_and_si256(rows, _mm256_shuffle_epi8(bit_table, high));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hits, _mm256_setzero_si256())));
+}
+
+STRING_UTILS_TARGET_AVX2
+static __m256i broadcast_table(const uint8_t* table) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+STRING_UTILS_TARGET_AVX2
+size_t leading_in_set_avx2(std::string_view str, const CharSet& chars) {
+    const char* data = str.data();
+    const size_t n = str.size();
+    const __m256i low_table = broadcast_table(chars.low_nibble_table());
+    const __m256i high_table = broadcast_table(chars.high_nibble_table());
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = outside_set(block, low_table, high_table);
+        if (mask) return i + count_trailing_zeros(mask);
+    }
+    return i + leading_in_set_scalar(str.substr(i), chars);
+}
+
+STRING_UTILS_TARGET_AVX2
+size_t trailing_in_set_avx2(std::string_view str, const CharSet& chars) {
+    const char* data = str.data();
+    const size_t n = str.size();
+    const __m256i low_table = broadcast_table(chars.low_nibble_table());
+    const __m256i high_table = broadcast_table(chars.high_nibble_table());
+
+    size_t end = n;
+    for (; end >= 32; end -= 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + end - 32));
+        uint32_t mask = outside_set(block, low_table, high_table);
+        if (mask) return count_leading_zeros(mask) + (n - end);
+    }
+    return (n - end) + trailing_in_set_scalar(str.substr(0, end), chars);
+}
+#endif
+
+size_t find_char(std::string_view str, char ch, size_t from) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return find_char_avx2(str, ch, from);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return find_char_sse2(str, ch, from);
+#else
+    return find_char_scalar(str, ch, from);
+#endif
+}
+
+void find_char_positions(std::string_view str, char ch, std::vector<size_t>& positions) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return find_char_positions_avx2(str, ch, positions);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    find_char_positions_sse2(str, ch, positions);
+#else
+    find_char_positions_scalar(str, ch, positions);
+#endif
+}
+
+size_t find_substring(std::string_view str, std::string_view pattern, size_t from) {
+    if (pattern.size() == 1) return find_char(str, pattern[0], from);
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return find_substring_avx2(str, pattern, from);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return find_substring_sse2(str, pattern, from);
+#else
+    return find_substring_scalar(str, pattern, from);
+#endif
+}
+
+size_t leading_in_set(std::string_view str, const CharSet& chars) {
+    // Most fields carry no padding or a byte or two, which the first checks settle
+    if (str.empty() || !chars.contains(str[0])) return 0;
+    if (str.size() < 2 || !chars.contains(str[1])) return 1;
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return leading_in_set_avx2(str, chars);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    if (chars.size() <= CharSet::max_listed) return leading_in_set_sse2(str, chars);
+#endif
+    return leading_in_set_scalar(str, chars);
+}
+
+size_t trailing_in_set(std::string_view str, const CharSet& chars) {
+    const size_t n = str.size();
+    if (n == 0 || !chars.contains(str[n - 1])) return 0;
+    if (n < 2 || !chars.contains(str[n - 2])) return 1;
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return trailing_in_set_avx2(str, chars);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    if (chars.size() <= CharSet::max_listed) return trailing_in_set_sse2(str, chars);
+#endif
+    return trailing_in_set_scalar(str, chars);
+}
+
+} // namespace string_utils::detail
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "char_set.h"
+#include "simd.h"
+
+// Vectorized scanning used by split(), find_all(), Searcher and the trim functions.
+// The dispatching entry points pick the widest kernel the CPU supports,
+// the per-ISA kernels are exposed so tests can compare them against each other.
+namespace string_utils::detail {
+
+// Position of the first ch at or after from, or npos
+size_t find_char(std::string_view str, char ch, size_t from = 0);
+
+// Appends the position of every ch in str to positions, in increasing order
+void find_char_positions(std::string_view str, char ch, std::vector<size_t>& positions);
+
+// Position of the first pattern at or after from, or npos. Candidates are found by
+// comparing the first and last pattern byte across a whole vector at once and are
+// then verified, which works best for short patterns.
+size_t find_substring(std::string_view str, std::string_view pattern, size_t from = 0);
+
+size_t find_char_scalar(std::string_view str, char ch, size_t from);
+void find_char_positions_scalar(std::string_view str, char ch, std::vector<size_t>& positions);
+size_t find_substring_scalar(std::string_view str, std::string_view pattern, size_t from);
+size_t leading_in_set_scalar(std::string_view str, const CharSet& chars);
+size_t trailing_in_set_scalar(std::string_view str, const CharSet& chars);
+#if STRING_UTILS_HAS_SSE2
+size_t find_char_sse2(std::string_view str, char ch, size_t from);
+void find_char_positions_sse2(std::string_view str, char ch, std::vector<size_t>& positions);
+size_t find_substring_sse2(std::string_view str, std::string_view pattern, size_t from);
+// Only for sets with at most CharSet::max_listed members
+size_t leading_in_set_sse2(std::string_view str, const CharSet& chars);
+size_t trailing_in_set_sse2(std::string_view str, const CharSet& chars);
+#endif
+#if STRING_UTILS_HAS_AVX2
+size_t find_char_avx2(std::string_view str, char ch, size_t from);
+void find_char_positions_avx2(std::string_view str, char ch, std::vector<size_t>& positions);
+size_t find_substring_avx2(std::string_view str, std::string_view pattern, size_t from);
+size_t leading_in_set_avx2(std::string_view str, const CharSet& chars);
+size_t trailing_in_set_avx2(std::string_view str, const CharSet& chars);
+#endif
+
+} // namespace string_utils::detail
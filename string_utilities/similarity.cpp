@@ -0,0 +1,201 @@
+#include "similarity.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "hash.h"
+
+namespace string_utils {
+
+namespace {
+
+// Blocks of match masks kept on the stack, longer patterns allocate
+constexpr size_t stack_blocks = 4;
+
+// Drops the common prefix and suffix, which do not change the distance, and orders
+// the pair so the shorter string is a
+void strip_common(std::string_view& a, std::string_view& b) {
+    size_t prefix = 0;
+    size_t limit = std::min(a.size(), b.size());
+    while (prefix < limit && a[prefix] == b[prefix]) ++prefix;
+    a.remove_prefix(prefix);
+    b.remove_prefix(prefix);
+
+    size_t suffix = 0;
+    limit -= prefix;
+    while (suffix < limit && a[a.size() - 1 - suffix] == b[b.size() - 1 - suffix]) ++suffix;
+    a.remove_suffix(suffix);
+    b.remove_suffix(suffix);
+
+    if (a.size() > b.size()) std::swap(a, b);
+}
+
+// True once the distance can no longer come down to max: the last row changes by at
+// most one per column and columns left remain
+bool exceeds(size_t score, size_t max, size_t columns_left) {
+    return score > max && score - max > columns_left;
+}
+
+// Bit i of peq[c * blocks + i / 64] is set where a[i] == c. Only the rows of bytes
+// that occur in a or b are cleared, the others are never read.
+void build_match_masks(std::string_view a, std::string_view b, size_t blocks, uint64_t* peq) {
+    for (char c : a) std::fill_n(peq + static_cast<uint8_t>(c) * blocks, blocks, 0);
+    for (char c : b) std::fill_n(peq + static_cast<uint8_t>(c) * blocks, blocks, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        peq[static_cast<uint8_t>(a[i]) * blocks + i / 64] |= uint64_t{1} << (i % 64);
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+size_t levenshtein_single_word(std::string_view a, std::string_view b, size_t max) {
+    const size_t m = a.size();
+    const size_t n = b.size();
+    if (m == 0) return std::min(n, max + 1);
+
+    uint64_t peq[256];
+    build_match_masks(a, b, 1, peq);
+
+    // Pv and Mv hold the +1 and -1 vertical deltas of the current column, the
+    // score is the last row. Row 0 grows by one per column.
+    const unsigned last = static_cast<unsigned>(m - 1);
+    uint64_t pv = ~uint64_t{0};
+    uint64_t mv = 0;
+    size_t score = m;
+    for (size_t j = 0; j < n; ++j) {
+        uint64_t eq = peq[static_cast<uint8_t>(b[j])];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        // Branch-free, the sign of the delta is as good as random
+        score = score + ((ph >> last) & 1) - ((mh >> last) & 1);
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        if (exceeds(score, max, n - 1 - j)) return max + 1;
+    }
+    return std::min(score, max + 1);
+}
+
+size_t levenshtein_blocks(std::string_view a, std::string_view b, size_t max) {
+    const size_t m = a.size();
+    const size_t n = b.size();
+    if (m == 0) return std::min(n, max + 1);
+
+    const size_t blocks = (m + 63) / 64;
+    uint64_t stack_peq[256 * stack_blocks];
+    uint64_t stack_deltas[2 * stack_blocks];
+    std::vector<uint64_t> heap;
+    uint64_t* peq = stack_peq;
+    uint64_t* pv = stack_deltas;
+    if (blocks > stack_blocks) {
+        heap.resize(258 * blocks);
+        peq = heap.data();
+        pv = peq + 256 * blocks;
+    }
+    uint64_t* mv = pv + blocks;
+    build_match_masks(a, b, blocks, peq);
+    std::fill_n(pv, blocks, ~uint64_t{0});
+    std::fill_n(mv, blocks, 0);
+
+    // Every block passes the horizontal delta of its last row down to the next one as
+    // a +1 and a -1 bit, the same delta the single word version feeds in as the top row
+    const unsigned last = static_cast<unsigned>((m - 1) % 64);
+    size_t score = m;
+    for (size_t j = 0; j < n; ++j) {
+        const uint64_t* eqs = peq + static_cast<uint8_t>(b[j]) * blocks;
+        uint64_t plus = 1;
+        uint64_t minus = 0;
+        for (size_t k = 0; k < blocks; ++k) {
+            uint64_t eq = eqs[k];
+            uint64_t xv = eq | mv[k];
+            eq |= minus;
+            uint64_t xh = (((eq & pv[k]) + pv[k]) ^ pv[k]) | eq;
+            uint64_t ph = mv[k] | ~(xh | pv[k]);
+            uint64_t mh = pv[k] & xh;
+
+            const unsigned out = k + 1 == blocks ? last : 63;
+            uint64_t plus_out = (ph >> out) & 1;
+            uint64_t minus_out = (mh >> out) & 1;
+            ph = (ph << 1) | plus;
+            mh = (mh << 1) | minus;
+            pv[k] = mh | ~(xv | ph);
+            mv[k] = ph & xv;
+            plus = plus_out;
+            minus = minus_out;
+        }
+        score = score + plus - minus;
+        if (exceeds(score, max, n - 1 - j)) return max + 1;
+    }
+    return std::min(score, max + 1);
+}
+
+} // namespace detail
+
+size_t levenshtein(std::string_view a, std::string_view b) {
+    return levenshtein_bounded(a, b, std::numeric_limits<size_t>::max() - 1);
+}
+
+size_t levenshtein_bounded(std::string_view a, std::string_view b, size_t max) {
+    strip_common(a, b);
+    // Every extra byte of b costs an insertion
+    if (b.size() - a.size() > max) return max + 1;
+    if (a.size() <= 64) return detail::levenshtein_single_word(a, b, max);
+    return detail::levenshtein_blocks(a, b, max);
+}
+
+MinHasher::MinHasher(size_t hashes, size_t ngram, uint64_t seed) : m_ngram(ngram) {
+    if (hashes == 0 || ngram == 0) throw std::invalid_argument("MinHasher needs at least one hash and n-gram byte");
+
+    // splitmix64 stream for the parameters of the hash family h(x) = (x ^ offset) * multiplier
+    auto next = [&seed] {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    };
+    m_multipliers.resize(hashes);
+    m_offsets.resize(hashes);
+    for (size_t i = 0; i < hashes; ++i) {
+        m_multipliers[i] = next() | 1;
+        m_offsets[i] = next();
+    }
+}
+
+void MinHasher::signature(std::string_view str, std::vector<uint64_t>& signature) const {
+    const size_t k = hashes();
+    signature.assign(k, std::numeric_limits<uint64_t>::max());
+    if (str.empty()) return;
+
+    const size_t length = std::min(m_ngram, str.size());
+    const size_t grams = str.size() - length + 1;
+    const uint64_t* multipliers = m_multipliers.data();
+    const uint64_t* offsets = m_offsets.data();
+    uint64_t* mins = signature.data();
+    for (size_t g = 0; g < grams; ++g) {
+        // Every n-gram is hashed once, the family then permutes that hash
+        uint64_t h = detail::hash_words(str.substr(g, length), [](uint64_t word) { return word; });
+        for (size_t i = 0; i < k; ++i) {
+            mins[i] = std::min(mins[i], (h ^ offsets[i]) * multipliers[i]);
+        }
+    }
+}
+
+std::vector<uint64_t> MinHasher::signature(std::string_view str) const {
+    std::vector<uint64_t> result;
+    signature(str, result);
+    return result;
+}
+
+double MinHasher::similarity(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+    if (a.empty() || a.size() != b.size()) return 0.0;
+
+    size_t equal = 0;
+    for (size_t i = 0; i < a.size(); ++i) equal += a[i] == b[i];
+    return static_cast<double>(equal) / static_cast<double>(a.size());
+}
+
+} // namespace string_utils
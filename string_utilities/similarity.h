@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Fuzzy matching for deduplicating near-identical strings such as log lines.
+// Exact edit distances use Myers' bit-parallel algorithm, a column of the dynamic
+// programming matrix per 64-bit word operation; MinHash signatures estimate the
+// n-gram similarity of large sets of strings without comparing them pairwise.
+namespace string_utils {
+
+// Levenshtein distance: the fewest single byte insertions, deletions and
+// substitutions that turn a into b
+size_t levenshtein(std::string_view a, std::string_view b);
+
+// The Levenshtein distance if it is at most max, otherwise max + 1. Stops as soon as
+// the distance is known to exceed max, so rejecting dissimilar pairs is cheap.
+size_t levenshtein_bounded(std::string_view a, std::string_view b, size_t max);
+
+// Computes MinHash signatures over the byte n-grams of strings. The fraction of
+// equal positions in two signatures estimates the Jaccard similarity of the two
+// n-gram sets, with a standard error of about 1 / sqrt(hashes).
+class MinHasher {
+public:
+    // Throws std::invalid_argument if hashes or ngram is zero
+    explicit MinHasher(size_t hashes = 64, size_t ngram = 3, uint64_t seed = 0);
+
+    // Replaces signature with the signature of str. A string shorter than the n-gram
+    // size counts as a single n-gram, an empty one has no n-grams.
+    void signature(std::string_view str, std::vector<uint64_t>& signature) const;
+    std::vector<uint64_t> signature(std::string_view str) const;
+
+    size_t hashes() const { return m_multipliers.size(); }
+    size_t ngram() const { return m_ngram; }
+
+    // Estimated Jaccard similarity in [0, 1] of two signatures from the same MinHasher
+    static double similarity(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b);
+
+private:
+    std::vector<uint64_t> m_multipliers;
+    std::vector<uint64_t> m_offsets;
+    size_t m_ngram;
+};
+
+namespace detail {
+
+// Myers' algorithm for a of at most 64 bytes, and blockwise for any length
+size_t levenshtein_single_word(std::string_view a, std::string_view b, size_t max);
+size_t levenshtein_blocks(std::string_view a, std::string_view b, size_t max);
+
+} // namespace detail
+
+} // namespace string_utils
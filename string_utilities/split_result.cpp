@@ -0,0 +1,28 @@
+#include "split_result.h"
+#include "string_utilities.h"
+
+namespace string_utils {
+
+namespace {
+
+template <typename Delimiter>
+void fill(SplitResult& out, std::string_view str, Delimiter delimiter) {
+    out.reset();
+    // The tokens never take more room than the input, so the buffer grows at most once
+    out.reserve(0, str.size());
+    for (std::string_view token : split_view(str, delimiter)) {
+        out.push_back(token);
+    }
+}
+
+} // namespace
+
+void split_into(SplitResult& out, std::string_view str, char delimiter) {
+    fill(out, str, delimiter);
+}
+
+void split_into(SplitResult& out, std::string_view str, std::string_view delimiter) {
+    fill(out, str, delimiter);
+}
+
+} // namespace string_utils
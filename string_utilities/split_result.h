@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace string_utils {
+
+// Tokens stored back to back in a single buffer, with the end of every token kept in
+// an offsets array. Unlike std::vector<std::string> a long token is not a separate
+// allocation, and since reset() keeps the capacity, refilling the same SplitResult
+// with similar input does not allocate at all.
+class SplitResult {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        iterator() = default;
+
+        reference operator*() const { return (*m_result)[m_index]; }
+
+        iterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++m_index;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_index == b.m_index; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+        friend class SplitResult;
+        iterator(const SplitResult* result, size_t index) : m_result(result), m_index(index) {}
+
+        const SplitResult* m_result = nullptr;
+        size_t m_index = 0;
+    };
+
+    size_t size() const { return m_ends.size(); }
+    bool empty() const { return m_ends.empty(); }
+
+    // Views stay valid until the next push_back(), reset() or split_into()
+    std::string_view operator[](size_t i) const {
+        size_t begin = i == 0 ? 0 : m_ends[i - 1];
+        return std::string_view(m_buffer.data() + begin, m_ends[i] - begin);
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
+
+    void push_back(std::string_view token) {
+        m_buffer.append(token);
+        m_ends.push_back(m_buffer.size());
+    }
+
+    // Removes every token but keeps the memory for the next use
+    void reset() {
+        m_buffer.clear();
+        m_ends.clear();
+    }
+
+    // Reserves room for tokens totalling bytes, delimiters excluded
+    void reserve(size_t tokens, size_t bytes) {
+        m_ends.reserve(tokens);
+        m_buffer.reserve(bytes);
+    }
+
+private:
+    std::string m_buffer;
+    std::vector<size_t> m_ends;
+};
+
+// Replaces the contents of out with the tokens of str, following split() rules
+void split_into(SplitResult& out, std::string_view str, char delimiter);
+void split_into(SplitResult& out, std::string_view str, std::string_view delimiter);
+
+} // namespace string_utils
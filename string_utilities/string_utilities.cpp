@@ -1,170 +1,264 @@
-#include "string_utilities.h"
-#include <algorithm>
-#include <cctype>
-#include <sstream>
-
-namespace string_utils {
-
-std::string to_upper(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-    return result;
-}
-
-std::string to_lower(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
-}
-
-std::string trim_left(const std::string& str) {
-    auto start = str.find_first_not_of(" \t\n\r");
-    return (start == std::string::npos) ? "" : str.substr(start);
-}
-
-std::string trim_right(const std::string& str) {
-    auto end = str.find_last_not_of(" \t\n\r");
-    return (end == std::string::npos) ? "" : str.substr(0, end + 1);
-}
-
-std::string trim(const std::string& str) {
-    return trim_right(trim_left(str));
-}
-
-std::vector<std::string> split(const std::string& str, char delimiter) {
-    std::vector<std::string> tokens;
-    std::stringstream ss(str);
-    std::string token;
-
-    if (str == "")
-    {
-        tokens.push_back(str);
-    }
-
-    while (std::getline(ss, token, delimiter)) {
-        tokens.push_back(token);
-    }
-
-    return tokens;
-}
-
-std::vector<std::string> split(const std::string& str, const std::string& delimiter) {
-    std::vector<std::string> tokens;
-    size_t start = 0;
-    size_t end = str.find(delimiter);
-
-    while (end != std::string::npos) {
-        tokens.push_back(str.substr(start, end - start));
-        start = end + delimiter.length();
-        end = str.find(delimiter, start);
-    }
-
-    tokens.push_back(str.substr(start));
-    return tokens;
-}
-
-bool is_numeric(const std::string& str) {
-    if (str.empty()) return false;
-
-    size_t start = 0;
-    if (str[0] == '+' || str[0] == '-') start = 1;
-    if (start >= str.length()) return false;
-
-    bool has_decimal = false;
-    for (size_t i = start; i < str.length(); ++i) {
-        if (str[i] == '.') {
-            if (has_decimal) return false;
-            has_decimal = true;
-        } else if (!std::isdigit(str[i])) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
-bool is_alpha(const std::string& str) {
-    if (str.empty()) return false;
-    return std::all_of(str.begin(), str.end(),
-                      [](char c) { return std::isalpha(c); });
-}
-
-bool is_alphanumeric(const std::string& str) {
-    if (str.empty()) return false;
-    return std::all_of(str.begin(), str.end(),
-                      [](char c) { return std::isalnum(c); });
-}
-
-bool starts_with(const std::string& str, const std::string& prefix) {
-    if (prefix.length() > str.length()) return false;
-    return str.substr(0, prefix.length()) == prefix;
-}
-
-bool ends_with(const std::string& str, const std::string& suffix) {
-    if (suffix.length() > str.length()) return false;
-    return str.substr(str.length() - suffix.length()) == suffix;
-}
-
-std::string replace_all(const std::string& str, const std::string& from, const std::string& to) {
-    if (from.empty()) return str;
-
-    std::string result = str;
-    size_t pos = 0;
-
-    while ((pos = result.find(from, pos)) != std::string::npos) {
-        result.replace(pos, from.length(), to);
-        pos += to.length();
-    }
-
-    return result;
-}
-
-std::string replace_first(const std::string& str, const std::string& from, const std::string& to) {
-    if (from.empty()) return str;
-
-    size_t pos = str.find(from);
-    if (pos == std::string::npos) return str;
-
-    std::string result = str;
-    result.replace(pos, from.length(), to);
-    return result;
-}
-
-std::string join(const std::vector<std::string>& strings, const std::string& delimiter) {
-    if (strings.empty()) return "";
-
-    std::string result = strings[0];
-    for (size_t i = 1; i < strings.size(); ++i) {
-        result += delimiter + strings[i];
-    }
-
-    return result;
-}
-
-std::vector<size_t> find_all(const std::string& str, const std::string& pattern) {
-    std::vector<size_t> positions;
-    size_t pos = str.find(pattern, 0);
-
-    while (pos != std::string::npos) {
-        positions.push_back(pos);
-        pos = str.find(pattern, pos + 1);
-    }
-
-    return positions;
-}
-
-size_t count_occurrences(const std::string& str, const std::string& pattern) {
-    if (pattern.empty()) return 0;
-
-    size_t count = 0;
-    size_t pos = 0;
-
-    while ((pos = str.find(pattern, pos)) != std::string::npos) {
-        ++count;
-        pos += pattern.length();
-    }
-
-    return count;
-}
-
+#include "string_utilities.h"
+#include "multi_matcher.h"
+#include "simd_ascii.h"
+#include "simd_scan.h"
+
+namespace string_utils {
+
+std::string to_upper(const std::string& str) {
+    std::string result = str;
+    to_upper_inplace(result);
+    return result;
+}
+
+std::string to_lower(const std::string& str) {
+    std::string result = str;
+    to_lower_inplace(result);
+    return result;
+}
+
+void to_upper_inplace(std::string& str) {
+    detail::to_upper_ascii(str.data(), str.data(), str.size());
+}
+
+void to_lower_inplace(std::string& str) {
+    detail::to_lower_ascii(str.data(), str.data(), str.size());
+}
+
+std::string trim_left(const std::string& str) {
+    return std::string(trim_left_view(str));
+}
+
+std::string trim_right(const std::string& str) {
+    return std::string(trim_right_view(str));
+}
+
+std::string trim(const std::string& str) {
+    return std::string(trim_view(str));
+}
+
+void trim_inplace(std::string& str, const CharSet& chars) {
+    str.resize(str.size() - detail::trailing_in_set(str, chars));
+    str.erase(0, detail::leading_in_set(str, chars));
+}
+
+std::vector<std::string> split(const std::string& str, char delimiter) {
+    std::vector<size_t> positions;
+    detail::find_char_positions(str, delimiter, positions);
+
+    std::vector<std::string> tokens;
+    tokens.reserve(positions.size() + 1);
+
+    size_t start = 0;
+    for (size_t pos : positions) {
+        tokens.emplace_back(str, start, pos - start);
+        start = pos + 1;
+    }
+    // A trailing delimiter does not start a new token, but an empty input is one empty token
+    if (start < str.size() || positions.empty()) {
+        tokens.emplace_back(str, start);
+    }
+
+    return tokens;
+}
+
+std::vector<std::string> split(const std::string& str, const std::string& delimiter) {
+    std::vector<std::string> tokens;
+    for (std::string_view token : split_view(str, delimiter)) {
+        tokens.emplace_back(token);
+    }
+    return tokens;
+}
+
+size_t SplitView::Delimiter::find(std::string_view text) const {
+    if (single_char) return detail::find_char(text, ch);
+
+    // Scan for the first delimiter byte and verify the rest in place
+    size_t pos = 0;
+    while ((pos = detail::find_char(text, str[0], pos)) != std::string_view::npos) {
+        if (text.compare(pos, str.size(), str) == 0) return pos;
+        ++pos;
+    }
+    return std::string_view::npos;
+}
+
+SplitView split_view(std::string_view str, char delimiter) {
+    return SplitView(str, delimiter);
+}
+
+SplitView split_view(std::string_view str, std::string_view delimiter) {
+    return SplitView(str, delimiter);
+}
+
+SplitView::SplitView(std::string_view str, char delimiter) : m_str(str) {
+    m_delimiter.ch = delimiter;
+    m_delimiter.single_char = true;
+}
+
+SplitView::SplitView(std::string_view str, std::string_view delimiter) : m_str(str) {
+    m_delimiter.str = delimiter;
+}
+
+SplitView::iterator::iterator(std::string_view str, Delimiter delimiter)
+    : m_delimiter(delimiter), m_rest(str), m_has_rest(true), m_done(false) {
+    next_token();
+}
+
+SplitView::iterator& SplitView::iterator::operator++() {
+    if (m_has_rest) {
+        next_token();
+    } else {
+        m_done = true;
+        m_token = std::string_view();
+    }
+    return *this;
+}
+
+void SplitView::iterator::next_token() {
+    // An empty delimiter never matches, the whole input is a single token
+    size_t pos = m_delimiter.size() == 0 ? std::string_view::npos : m_delimiter.find(m_rest);
+    if (pos == std::string_view::npos) {
+        m_token = m_rest;
+        m_rest = std::string_view();
+        m_has_rest = false;
+        return;
+    }
+
+    m_token = m_rest.substr(0, pos);
+    m_rest = m_rest.substr(pos + m_delimiter.size());
+    // std::getline based splitting never produced a token after a trailing delimiter
+    m_has_rest = !(m_rest.empty() && m_delimiter.single_char);
+}
+
+bool is_numeric(std::string_view str) {
+    if (str.empty()) return false;
+
+    size_t start = 0;
+    if (str[0] == '+' || str[0] == '-') start = 1;
+    if (start >= str.length()) return false;
+
+    // Digits with at most one decimal point anywhere after the sign
+    std::string_view digits = str.substr(start);
+    size_t dot = detail::find_char(digits, '.');
+    if (dot == std::string_view::npos) {
+        return detail::all_of_class(digits, detail::CharClass::Digit);
+    }
+    return detail::all_of_class(digits.substr(0, dot), detail::CharClass::Digit) &&
+           detail::all_of_class(digits.substr(dot + 1), detail::CharClass::Digit);
+}
+
+bool is_alpha(std::string_view str) {
+    if (str.empty()) return false;
+    return detail::all_of_class(str, detail::CharClass::Alpha);
+}
+
+bool is_alphanumeric(std::string_view str) {
+    if (str.empty()) return false;
+    return detail::all_of_class(str, detail::CharClass::Alnum);
+}
+
+std::string replace_all(const std::string& str, const std::string& from, const std::string& to) {
+    if (from.empty()) return str;
+
+    // Find every match first so the result can be sized and written exactly once
+    std::vector<size_t> positions;
+    size_t pos = 0;
+    while ((pos = str.find(from, pos)) != std::string::npos) {
+        positions.push_back(pos);
+        pos += from.length();
+    }
+    if (positions.empty()) return str;
+
+    std::string result;
+    result.reserve(str.length() - positions.size() * from.length() + positions.size() * to.length());
+
+    size_t copied = 0;
+    for (size_t match : positions) {
+        result.append(str, copied, match - copied);
+        result.append(to);
+        copied = match + from.length();
+    }
+    result.append(str, copied, std::string::npos);
+
+    return result;
+}
+
+std::string replace_all(std::string_view str,
+                        const std::vector<std::pair<std::string, std::string>>& replacements) {
+    std::vector<std::string_view> patterns;
+    patterns.reserve(replacements.size());
+    for (const auto& replacement : replacements) {
+        patterns.push_back(replacement.first);
+    }
+
+    MultiMatcher matcher(patterns);
+    auto matches = matcher.find_leftmost_longest(str);
+
+    size_t length = str.length();
+    for (const auto& match : matches) {
+        length = length - matcher.pattern_length(match.pattern) + replacements[match.pattern].second.length();
+    }
+
+    std::string result;
+    result.reserve(length);
+
+    size_t copied = 0;
+    for (const auto& match : matches) {
+        result.append(str.substr(copied, match.position - copied));
+        result.append(replacements[match.pattern].second);
+        copied = match.position + matcher.pattern_length(match.pattern);
+    }
+    result.append(str.substr(copied));
+
+    return result;
+}
+
+std::string replace_first(const std::string& str, const std::string& from, const std::string& to) {
+    if (from.empty()) return str;
+
+    size_t pos = str.find(from);
+    if (pos == std::string::npos) return str;
+
+    std::string result = str;
+    result.replace(pos, from.length(), to);
+    return result;
+}
+
+std::string join(const std::vector<std::string>& strings, const std::string& delimiter) {
+    std::string result;
+    join_into(result, strings, delimiter);
+    return result;
+}
+
+std::vector<size_t> find_all(std::string_view str, std::string_view pattern) {
+    std::vector<size_t> positions;
+    if (pattern.size() == 1) {
+        detail::find_char_positions(str, pattern[0], positions);
+        return positions;
+    }
+
+    size_t pos = detail::find_substring(str, pattern, 0);
+
+    while (pos != std::string_view::npos) {
+        positions.push_back(pos);
+        pos = detail::find_substring(str, pattern, pos + 1);
+    }
+
+    return positions;
+}
+
+size_t count_occurrences(std::string_view str, std::string_view pattern) {
+    if (pattern.empty()) return 0;
+
+    size_t count = 0;
+    size_t pos = 0;
+
+    while ((pos = detail::find_substring(str, pattern, pos)) != std::string_view::npos) {
+        ++count;
+        pos += pattern.length();
+    }
+
+    return count;
+}
+
 } // namespace string_utils
\ No newline at end of file
@@ -1,38 +1,188 @@
-#pragma once
-#include <string>
-#include <vector>
-
-namespace string_utils {
-
-// Case conversion utilities
-std::string to_upper(const std::string& str);
-std::string to_lower(const std::string& str);
-
-// Trimming utilities
-std::string trim_left(const std::string& str);
-std::string trim_right(const std::string& str);
-std::string trim(const std::string& str);
-
-// String splitting and tokenization
-std::vector<std::string> split(const std::string& str, char delimiter);
-std::vector<std::string> split(const std::string& str, const std::string& delimiter);
-
-// String validation utilities
-bool is_numeric(const std::string& str);
-bool is_alpha(const std::string& str);
-bool is_alphanumeric(const std::string& str);
-bool starts_with(const std::string& str, const std::string& prefix);
-bool ends_with(const std::string& str, const std::string& suffix);
-
-// String replacement utilities
-std::string replace_all(const std::string& str, const std::string& from, const std::string& to);
-std::string replace_first(const std::string& str, const std::string& from, const std::string& to);
-
-// String joining
-std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
-
-// Advanced search utilities
-std::vector<size_t> find_all(const std::string& str, const std::string& pattern);
-size_t count_occurrences(const std::string& str, const std::string& pattern);
-
-} // namespace string_utils
\ No newline at end of file
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "constexpr_string.h"
+
+namespace string_utils {
+
+class SplitView;
+
+// Case conversion utilities
+std::string to_upper(const std::string& str);
+std::string to_lower(const std::string& str);
+void to_upper_inplace(std::string& str);
+void to_lower_inplace(std::string& str);
+
+// Trimming utilities
+std::string trim_left(const std::string& str);
+std::string trim_right(const std::string& str);
+std::string trim(const std::string& str);
+
+// Non-owning trimming, the result points into the input. chars defaults to
+// whitespace_chars and can be any CharSet, built at compile time or at runtime.
+// Usable in constant expressions; at runtime long runs are skipped with SIMD.
+constexpr std::string_view trim_left_view(std::string_view str, const CharSet& chars = whitespace_chars);
+constexpr std::string_view trim_right_view(std::string_view str, const CharSet& chars = whitespace_chars);
+constexpr std::string_view trim_view(std::string_view str, const CharSet& chars = whitespace_chars);
+
+// Trims str in place, the characters are moved down without reallocating
+void trim_inplace(std::string& str, const CharSet& chars = whitespace_chars);
+
+// String splitting and tokenization
+std::vector<std::string> split(const std::string& str, char delimiter);
+std::vector<std::string> split(const std::string& str, const std::string& delimiter);
+
+// Lazy splitting, tokens are produced on iteration without allocating
+SplitView split_view(std::string_view str, char delimiter);
+SplitView split_view(std::string_view str, std::string_view delimiter);
+
+// String validation utilities
+bool is_numeric(std::string_view str);
+bool is_alpha(std::string_view str);
+bool is_alphanumeric(std::string_view str);
+constexpr bool starts_with(std::string_view str, std::string_view prefix) { return ct::starts_with(str, prefix); }
+constexpr bool ends_with(std::string_view str, std::string_view suffix) { return ct::ends_with(str, suffix); }
+
+// String replacement utilities
+std::string replace_all(const std::string& str, const std::string& from, const std::string& to);
+std::string replace_first(const std::string& str, const std::string& from, const std::string& to);
+
+// Performs every from -> to substitution in a single pass over str. Replacements are
+// not rescanned; where patterns overlap, the match starting first wins and among those
+// starting at the same position the longest one.
+std::string replace_all(std::string_view str,
+                        const std::vector<std::pair<std::string, std::string>>& replacements);
+
+// String joining
+std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
+
+// Joins any range of string-like elements (std::string, std::string_view, const char*,
+// split_view() tokens). join_into() appends to out, so a buffer can be reused across calls.
+template <typename Range>
+void join_into(std::string& out, const Range& strings, std::string_view delimiter);
+template <typename Range>
+std::string join(const Range& strings, std::string_view delimiter);
+
+// Advanced search utilities, see Searcher for a pattern that is searched for repeatedly
+// and ct::count_occurrences() for constant expressions
+std::vector<size_t> find_all(std::string_view str, std::string_view pattern);
+size_t count_occurrences(std::string_view str, std::string_view pattern);
+
+// Range over the tokens of a string, yielding string_views into it.
+// Follows the same rules as split(): an empty input yields one empty token and,
+// for a single char delimiter, a trailing delimiter does not produce a token.
+// The viewed string must outlive the range and its iterators.
+class SplitView {
+    struct Delimiter {
+        std::string_view str;
+        char ch = '\0';
+        bool single_char = false;
+
+        size_t find(std::string_view text) const;
+        size_t size() const { return single_char ? 1 : str.size(); }
+    };
+
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        iterator() = default;
+
+        reference operator*() const { return m_token; }
+        pointer operator->() const { return &m_token; }
+
+        iterator& operator++();
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.m_done == b.m_done && (a.m_done || a.m_token.data() == b.m_token.data());
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+        friend class SplitView;
+        iterator(std::string_view str, Delimiter delimiter);
+        void next_token();
+
+        Delimiter m_delimiter;
+        std::string_view m_token;
+        std::string_view m_rest;
+        bool m_has_rest = false; // another token follows the current one
+        bool m_done = true;
+    };
+
+    SplitView(std::string_view str, char delimiter);
+    SplitView(std::string_view str, std::string_view delimiter);
+
+    iterator begin() const { return iterator(m_str, m_delimiter); }
+    iterator end() const { return iterator(); }
+
+private:
+    std::string_view m_str;
+    Delimiter m_delimiter;
+};
+
+constexpr std::string_view trim_left_view(std::string_view str, const CharSet& chars) {
+    if (STRING_UTILS_IS_CONSTANT_EVALUATED()) return ct::trim_left(str, chars);
+    return str.substr(detail::leading_in_set(str, chars));
+}
+
+constexpr std::string_view trim_right_view(std::string_view str, const CharSet& chars) {
+    if (STRING_UTILS_IS_CONSTANT_EVALUATED()) return ct::trim_right(str, chars);
+    return str.substr(0, str.size() - detail::trailing_in_set(str, chars));
+}
+
+constexpr std::string_view trim_view(std::string_view str, const CharSet& chars) {
+    // One pass: the trailing scan starts where the leading one stopped
+    return trim_right_view(trim_left_view(str, chars), chars);
+}
+
+template <typename Range>
+void join_into(std::string& out, const Range& strings, std::string_view delimiter) {
+    using std::begin;
+    using std::end;
+    auto first = begin(strings);
+    auto last = end(strings);
+    if (first == last) return;
+
+    // Multi-pass ranges are measured first so out grows exactly once
+    using Category = typename std::iterator_traits<decltype(first)>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        size_t length = 0;
+        size_t count = 0;
+        for (auto it = first; it != last; ++it) {
+            length += std::string_view(*it).size();
+            ++count;
+        }
+        out.reserve(out.size() + length + (count - 1) * delimiter.size());
+    }
+
+    out.append(std::string_view(*first));
+    for (++first; first != last; ++first) {
+        out.append(delimiter);
+        out.append(std::string_view(*first));
+    }
+}
+
+template <typename Range>
+std::string join(const Range& strings, std::string_view delimiter) {
+    std::string result;
+    join_into(result, strings, delimiter);
+    return result;
+}
+
+} // namespace string_utils
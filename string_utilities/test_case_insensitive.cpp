@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "case_insensitive.h"
+#include "intern_pool.h"
+#include "simd_ascii.h"
+#include "string_utilities.h"
+
+using namespace string_utils;
+
+// Random mixed case text with a few bytes just outside the letter ranges
+static std::string random_text(std::mt19937& rng, size_t length) {
+    const char alphabet[] = {'a', 'A', 'b', 'B', '@', '[', '`', '{', '\xC1', '\xE1'};
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 1);
+    std::string text(length, ' ');
+    for (auto& c : text) c = alphabet[pick(rng)];
+    return text;
+}
+
+static size_t reference_ifind(std::string_view str, std::string_view pattern, size_t from) {
+    return to_lower(std::string(str)).find(to_lower(std::string(pattern)), from);
+}
+
+TEST(CaseInsensitiveTest, Basics) {
+    EXPECT_TRUE(iequals("Content-Length", "content-length"));
+    EXPECT_TRUE(iequals("", ""));
+    EXPECT_FALSE(iequals("Content-Length", "Content-Lengths"));
+    EXPECT_FALSE(iequals("@", "`")); // 0x40 and 0x60 only differ in the case bit
+    EXPECT_FALSE(iequals("[", "{"));
+    EXPECT_FALSE(iequals("\xC1", "\xE1"));
+
+    EXPECT_TRUE(istarts_with("HOST: example.com", "host:"));
+    EXPECT_FALSE(istarts_with("Ho", "host"));
+    EXPECT_TRUE(iends_with("text/HTML", "/html"));
+    EXPECT_FALSE(iends_with("html", "/html"));
+
+    EXPECT_EQ(ifind("Transfer-Encoding: CHUNKED", "chunked"), 19);
+    EXPECT_EQ(ifind("abc", "D"), std::string_view::npos);
+    EXPECT_EQ(ifind("abc", "", 2), 2);
+    EXPECT_EQ(ifind_all("aAaA", "aa"), (std::vector<size_t>{0, 1, 2}));
+    EXPECT_EQ(ifind_all("abc", ""), find_all("abc", ""));
+}
+
+TEST(CaseInsensitiveTest, KernelsMatchReference) {
+    std::mt19937 rng(17);
+    for (size_t length = 0; length < 150; ++length) {
+        std::string a = random_text(rng, length);
+        std::string b = to_upper(a);
+        for (size_t k = 0; k < length; k += 7) {
+            if (k % 2) b[k] = '@'; // breaks equality wherever it lands on a letter
+        }
+        bool expected = to_lower(a) == to_lower(b);
+        EXPECT_EQ(detail::equal_ignore_case_scalar(a.data(), b.data(), length), expected);
+        EXPECT_EQ(detail::equal_ignore_case(a.data(), b.data(), length), expected) << length;
+#if STRING_UTILS_HAS_SSE2
+        EXPECT_EQ(detail::equal_ignore_case_sse2(a.data(), b.data(), length), expected);
+#endif
+#if STRING_UTILS_HAS_AVX2
+        if (detail::cpu_has_avx2()) { EXPECT_EQ(detail::equal_ignore_case_avx2(a.data(), b.data(), length), expected); }
+#endif
+
+        for (size_t m = 1; m < 5; ++m) {
+            std::string pattern = random_text(rng, m);
+            for (size_t from : {size_t{0}, size_t{1}, length / 2, length}) {
+                size_t expected_pos = reference_ifind(a, pattern, from);
+                EXPECT_EQ(detail::find_ignore_case_scalar(a, pattern, from), expected_pos);
+                EXPECT_EQ(ifind(a, pattern, from), expected_pos) << length << " " << pattern;
+#if STRING_UTILS_HAS_SSE2
+                EXPECT_EQ(detail::find_ignore_case_sse2(a, pattern, from), expected_pos);
+#endif
+#if STRING_UTILS_HAS_AVX2
+                if (detail::cpu_has_avx2()) { EXPECT_EQ(detail::find_ignore_case_avx2(a, pattern, from), expected_pos); }
+#endif
+            }
+        }
+    }
+}
+
+TEST(CaseInsensitiveTest, HashMatchesLowerCase) {
+    std::mt19937 rng(5);
+    ICaseHash hash;
+    for (size_t length = 0; length < 40; ++length) {
+        std::string str = random_text(rng, length);
+        EXPECT_EQ(hash(str), hash(to_upper(str)));
+        EXPECT_EQ(hash(str), detail::hash_bytes(to_lower(str)));
+    }
+    EXPECT_NE(hash("@"), hash("`"));
+}
+
+TEST(CaseInsensitiveTest, UnorderedMapPolicies) {
+    std::unordered_map<std::string, int, ICaseHash, ICaseEqual> headers;
+    headers["Content-Type"] = 1;
+    headers["content-type"] = 2;
+    headers["ACCEPT"] = 3;
+    EXPECT_EQ(headers.size(), 2);
+    EXPECT_EQ(headers.at("CONTENT-TYPE"), 2);
+    EXPECT_EQ(headers.count("accept"), 1);
+    EXPECT_EQ(headers.count("accepts"), 0);
+}
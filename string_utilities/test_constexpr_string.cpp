@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "constexpr_string.h"
+#include "string_utilities.h"
+
+using namespace std::string_view_literals;
+namespace ct = string_utils::ct;
+
+// Everything below is checked by the compiler, the TESTs only compare with the runtime functions
+
+static_assert(ct::trim("  \tkey \r\n") == "key");
+static_assert(ct::trim_left("  key ") == "key ");
+static_assert(ct::trim_right("  key ") == "  key");
+static_assert(ct::trim(" \t\n\r").empty());
+static_assert(ct::trim("").empty());
+static_assert(string_utils::trim_view("  both  ") == "both");
+
+static_assert(ct::starts_with("Content-Length: 12", "Content-Length:"));
+static_assert(!ct::starts_with("Content", "Content-Length:"));
+static_assert(ct::starts_with("anything", ""));
+static_assert(ct::ends_with("config.json", ".json"));
+static_assert(!ct::ends_with("json", ".json"));
+static_assert(string_utils::starts_with("GET /", "GET") && string_utils::ends_with("GET /", "/"));
+
+static_assert(ct::find("a=b=c", '=') == 1);
+static_assert(ct::find("a=b=c", '=', 2) == 3);
+static_assert(ct::find("a=b=c", "b=") == 2);
+static_assert(ct::find("abc", "x") == std::string_view::npos);
+
+static_assert(ct::count_occurrences("aaaa", "aa") == 2);
+static_assert(ct::count_occurrences("abcabc", "bc") == 2);
+static_assert(ct::count_occurrences("abc", "") == 0);
+static_assert(ct::count_occurrences("", "a") == 0);
+
+constexpr auto request_line = ct::split<3>("GET /index.html HTTP/1.1", ' ');
+static_assert(request_line.size() == 3);
+static_assert(request_line[0] == "GET" && request_line[1] == "/index.html" && request_line[2] == "HTTP/1.1");
+
+// The last token keeps the rest when there are more tokens than room
+constexpr auto key_value = ct::split<2>("key=a=b", '=');
+static_assert(key_value.size() == 2 && key_value[0] == "key" && key_value[1] == "a=b");
+
+// The split() rules: empty input is one empty token, a trailing char delimiter adds none
+static_assert(ct::split<4>("", ',').size() == 1 && ct::split<4>("", ',')[0].empty());
+static_assert(ct::split<4>("a,b,", ',').size() == 2);
+static_assert(ct::split<4>("a::b::", "::").size() == 3);
+static_assert(ct::split<4>("a::b", "").size() == 1);
+
+// A dispatch table built at compile time
+constexpr int method_id(std::string_view line) {
+    constexpr std::string_view methods[] = {"GET", "POST", "PUT"};
+    auto method = ct::split<2>(ct::trim(line), ' ')[0];
+    for (int i = 0; i < 3; ++i) {
+        if (methods[i] == method) return i;
+    }
+    return -1;
+}
+static_assert(method_id("  POST /form HTTP/1.1") == 1);
+static_assert(method_id("DELETE /x") == -1);
+
+template <size_t N>
+static std::vector<std::string> to_strings(const ct::FixedSplit<N>& tokens) {
+    return std::vector<std::string>(tokens.begin(), tokens.end());
+}
+
+TEST(ConstexprStringTest, MatchesRuntimeFunctions) {
+    for (std::string_view text : {""sv, " "sv, " a "sv, "\t\r\nword\n"sv, "a,b"sv, ",,"sv, "aaaa"sv, "abcabcab"sv}) {
+        EXPECT_EQ(ct::trim(text), string_utils::trim(std::string(text)));
+        EXPECT_EQ(ct::trim_left(text), string_utils::trim_left(std::string(text)));
+        EXPECT_EQ(ct::trim_right(text), string_utils::trim_right(std::string(text)));
+        for (std::string_view pattern : {"a"sv, "ab"sv, "aa"sv, ","sv, ""sv}) {
+            EXPECT_EQ(ct::count_occurrences(text, pattern), string_utils::count_occurrences(text, pattern))
+                << text << " " << pattern;
+        }
+    }
+}
+
+TEST(ConstexprStringTest, SplitMatchesSplit) {
+    for (std::string text : {"", ",", "a", "a,b", "a,,b,", ",leading", "no delimiters here"}) {
+        EXPECT_EQ(to_strings(ct::split<8>(text, ',')), string_utils::split(text, ',')) << text;
+    }
+    for (std::string text : {"", "::", "a::b", "a::b::", "a:::b"}) {
+        EXPECT_EQ(to_strings(ct::split<8>(text, "::")), string_utils::split(text, "::")) << text;
+    }
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "csv.h"
+#include "line_reader.h"
+
+using string_utils::csv::Reader;
+using Records = std::vector<std::vector<std::string>>;
+
+static Records read_all(std::string_view text, string_utils::csv::Dialect dialect = string_utils::csv::comma) {
+    Reader reader(text, dialect);
+    std::vector<std::string_view> fields;
+    Records records;
+    while (reader.next(fields)) {
+        EXPECT_EQ(reader.error(), std::errc{}) << text;
+        records.emplace_back(fields.begin(), fields.end());
+    }
+    EXPECT_EQ(reader.offset(), text.size());
+    return records;
+}
+
+// Byte at a time RFC 4180 parser for well-formed input
+static Records reference_parse(std::string_view text) {
+    Records records;
+    if (text.empty()) return records;
+    std::vector<std::string> record(1);
+    bool quoted = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (quoted) {
+            if (c != '"') {
+                record.back() += c;
+            } else if (i + 1 < text.size() && text[i + 1] == '"') {
+                record.back() += '"';
+                ++i;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"' && record.back().empty()) {
+            quoted = true;
+        } else if (c == ',') {
+            record.emplace_back();
+        } else if (c == '\n' || (c == '\r' && i + 1 < text.size() && text[i + 1] == '\n')) {
+            if (c == '\r') ++i;
+            records.push_back(record);
+            record.assign(1, "");
+        } else {
+            record.back() += c;
+        }
+    }
+    if (text.back() != '\n') records.push_back(record);
+    return records;
+}
+
+TEST(CsvTest, Rfc4180Records) {
+    EXPECT_EQ(read_all(""), Records{});
+    EXPECT_EQ(read_all("a,b,c"), (Records{{"a", "b", "c"}}));
+    EXPECT_EQ(read_all("a,b\n1,2\n"), (Records{{"a", "b"}, {"1", "2"}}));
+    EXPECT_EQ(read_all("a,b\r\n1,2\r\n"), (Records{{"a", "b"}, {"1", "2"}}));
+    EXPECT_EQ(read_all("\n,\n"), (Records{{""}, {"", ""}}));
+
+    // Quoted delimiters, newlines and doubled quotes
+    EXPECT_EQ(read_all("\"a,b\",\"line\nbreak\",\"say \"\"hi\"\"\"\nx"),
+              (Records{{"a,b", "line\nbreak", "say \"hi\""}, {"x"}}));
+    EXPECT_EQ(read_all("\"\",\"\"\"\""), (Records{{"", "\""}}));
+    EXPECT_EQ(read_all("\"quoted\"\r\n"), (Records{{"quoted"}}));
+
+    EXPECT_EQ(read_all("a\tb,c\n\"x\ty\"\tz", string_utils::csv::tab), (Records{{"a", "b,c"}, {"x\ty", "z"}}));
+}
+
+TEST(CsvTest, FieldsAreViewsUnlessUnescaped) {
+    const std::string text = "plain,\"quoted\",\"esc\"\"aped\"";
+    Reader reader(text);
+    std::vector<std::string_view> fields;
+    ASSERT_TRUE(reader.next(fields));
+    ASSERT_EQ(fields.size(), 3);
+    EXPECT_EQ(fields[0].data(), text.data());
+    EXPECT_EQ(fields[1].data(), text.data() + 7);
+    EXPECT_EQ(fields[2], "esc\"aped");
+    EXPECT_FALSE(fields[2].data() >= text.data() && fields[2].data() < text.data() + text.size());
+}
+
+TEST(CsvTest, MalformedRecords) {
+    std::vector<std::string_view> fields;
+
+    // A quote inside an unquoted field is data and does not open a quoted field
+    // for the rest of the text
+    Reader stray("5\" screen,next\nfoo,bar\nx,y\n");
+    ASSERT_TRUE(stray.next(fields));
+    EXPECT_EQ(stray.error(), std::errc::invalid_argument);
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"5\" screen", "next"}));
+    ASSERT_TRUE(stray.next(fields));
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"foo", "bar"}));
+    ASSERT_TRUE(stray.next(fields));
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"x", "y"}));
+    EXPECT_FALSE(stray.next(fields));
+
+    // The same with the stray quote and the quoted field after it on both sides of
+    // a block boundary
+    for (size_t pos = 1; pos < 70; ++pos) {
+        const std::string first = std::string(pos, 'a') + "\"b";
+        const std::string text = first + ",c\n\"d,e\"\nf\n";
+        Reader reader(text);
+        ASSERT_TRUE(reader.next(fields));
+        EXPECT_EQ(reader.error(), std::errc::invalid_argument);
+        EXPECT_EQ(fields, (std::vector<std::string_view>{first, "c"})) << pos;
+        ASSERT_TRUE(reader.next(fields));
+        EXPECT_EQ(fields, std::vector<std::string_view>{"d,e"}) << pos;
+        ASSERT_TRUE(reader.next(fields));
+        EXPECT_EQ(fields, std::vector<std::string_view>{"f"}) << pos;
+        EXPECT_FALSE(reader.next(fields));
+    }
+
+    Reader trailing("\"ab\"cd,e\nok");
+    ASSERT_TRUE(trailing.next(fields));
+    EXPECT_EQ(trailing.error(), std::errc::invalid_argument);
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"abcd", "e"}));
+    ASSERT_TRUE(trailing.next(fields));
+    EXPECT_EQ(trailing.error(), std::errc{}); // the error is per record
+    EXPECT_EQ(fields, std::vector<std::string_view>{"ok"});
+
+    Reader unterminated("a,\"never closed,b\nc");
+    ASSERT_TRUE(unterminated.next(fields));
+    EXPECT_EQ(unterminated.error(), std::errc::invalid_argument);
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"a", "never closed,b\nc"}));
+    EXPECT_FALSE(unterminated.next(fields));
+}
+
+TEST(CsvTest, MatchesReferenceAcrossBlocks) {
+    std::mt19937 rng(18);
+    const std::vector<std::string> pieces = {"a", "bc", "def", "", "\"q,\"", "\"x\"\"y\"", "\"line\nbreak\"", "\"\"",
+                                             "\"x\"\",\"\"\n\"\"\""};
+    std::uniform_int_distribution<size_t> piece(0, pieces.size() - 1);
+    std::uniform_int_distribution<int> separator(0, 9);
+
+    for (int round = 0; round < 300; ++round) {
+        std::string text;
+        int length = round % 50 + 1;
+        for (int i = 0; i < length; ++i) {
+            text += pieces[piece(rng)];
+            int s = separator(rng);
+            text += s < 6 ? "," : s < 8 ? "\n" : "\r\n";
+        }
+        if (round % 2) { // with and without a final newline
+            text.pop_back();
+            if (text.back() == '\r') text.pop_back();
+        }
+        EXPECT_EQ(read_all(text), reference_parse(text)) << text;
+    }
+}
+
+TEST(CsvTest, UnquotedMatchesFieldReader) {
+    std::string text;
+    for (int i = 0; i < 500; ++i) text += std::to_string(i) + ",name" + std::to_string(i * 7) + ",,x\n";
+    string_utils::FieldReader lines(text, ',');
+    Reader reader(text);
+    std::vector<std::string_view> expected;
+    std::vector<std::string_view> fields;
+    while (lines.next(expected)) {
+        ASSERT_TRUE(reader.next(fields));
+        EXPECT_EQ(fields, expected);
+    }
+    EXPECT_FALSE(reader.next(fields));
+}
+
+TEST(CsvTest, ClassifyKernelsMatchScalar) {
+    std::mt19937 rng(7);
+    const char alphabet[] = {'a', ',', '"', '\n', '\t', '\r'};
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 1);
+    for (int round = 0; round < 200; ++round) {
+        char block[64];
+        for (char& c : block) c = alphabet[pick(rng)];
+        auto expected = string_utils::detail::classify_csv_block_scalar(block, ',', '"');
+        auto check = [&](const string_utils::detail::CsvMasks& masks) {
+            EXPECT_EQ(masks.quotes, expected.quotes);
+            EXPECT_EQ(masks.delimiters, expected.delimiters);
+            EXPECT_EQ(masks.newlines, expected.newlines);
+        };
+        check(string_utils::detail::classify_csv_block(block, ',', '"'));
+#if STRING_UTILS_HAS_SSE2
+        check(string_utils::detail::classify_csv_block_sse2(block, ',', '"'));
+#endif
+#if STRING_UTILS_HAS_AVX2
+        if (string_utils::detail::cpu_has_avx2()) check(string_utils::detail::classify_csv_block_avx2(block, ',', '"'));
+#endif
+    }
+    EXPECT_EQ(string_utils::detail::prefix_xor(0b1001), 0b0111);
+}
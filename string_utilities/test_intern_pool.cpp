@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "intern_pool.h"
+
+using string_utils::InternPool;
+
+TEST(InternPoolTest, SameStringSameHandle) {
+    InternPool pool;
+    std::string first = "status_200";
+    std::string second = "status_200";
+
+    InternPool::Handle a = pool.intern(first);
+    InternPool::Handle b = pool.intern(second);
+    InternPool::Handle c = pool.intern("status_404");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a.view.data(), b.view.data()); // one stored copy
+    EXPECT_NE(a.view.data(), first.data());
+    EXPECT_EQ(a.view, "status_200");
+    EXPECT_EQ(pool.view(c.id), "status_404");
+    EXPECT_EQ(pool.size(), 2);
+}
+
+TEST(InternPoolTest, Find) {
+    InternPool pool;
+    InternPool::Handle handle;
+    EXPECT_FALSE(pool.find("missing", handle));
+
+    InternPool::Handle host = pool.intern("example.com");
+    ASSERT_TRUE(pool.find("example.com", handle));
+    EXPECT_EQ(handle, host);
+    EXPECT_EQ(handle.view, "example.com");
+    EXPECT_FALSE(pool.find("example.co", handle));
+    EXPECT_EQ(pool.size(), 1);
+}
+
+TEST(InternPoolTest, EmptyAndLongStrings) {
+    InternPool pool(1);
+    InternPool::Handle empty = pool.intern("");
+    EXPECT_EQ(pool.intern(""), empty);
+    EXPECT_TRUE(empty.view.empty());
+
+    std::string big(100000, 'x');
+    InternPool::Handle long_one = pool.intern(big);
+    EXPECT_EQ(long_one.view, big);
+    EXPECT_EQ(pool.intern(big), long_one);
+    EXPECT_NE(long_one, empty);
+}
+
+TEST(InternPoolTest, GrowthKeepsHandlesStable) {
+    InternPool pool(4);
+    std::vector<InternPool::Handle> handles;
+    for (int i = 0; i < 100000; ++i) {
+        handles.push_back(pool.intern("token_" + std::to_string(i)));
+    }
+    EXPECT_EQ(pool.size(), 100000);
+
+    std::set<uint32_t> ids;
+    for (int i = 0; i < 100000; ++i) {
+        std::string token = "token_" + std::to_string(i);
+        ASSERT_EQ(handles[i].view, token);
+        ASSERT_EQ(pool.view(handles[i].id), token);
+        ASSERT_EQ(pool.intern(token), handles[i]);
+        ids.insert(handles[i].id);
+    }
+    EXPECT_EQ(ids.size(), 100000);
+    EXPECT_GT(pool.memory_usage(), 100000 * 6);
+}
+
+TEST(InternPoolTest, ConcurrentInterning) {
+    InternPool pool(8);
+    constexpr int threads = 4;
+    constexpr int tokens = 20000;
+
+    // Every thread interns the same tokens in a different order
+    std::vector<std::vector<uint32_t>> ids(threads, std::vector<uint32_t>(tokens));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int n = 0; n < tokens; ++n) {
+                int i = t % 2 == 0 ? (n + t * 977) % tokens : tokens - 1 - n;
+                ids[t][i] = pool.intern("host-" + std::to_string(i)).id;
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    EXPECT_EQ(pool.size(), tokens);
+    for (int i = 0; i < tokens; ++i) {
+        for (int t = 1; t < threads; ++t) ASSERT_EQ(ids[t][i], ids[0][i]);
+        ASSERT_EQ(pool.view(ids[0][i]), "host-" + std::to_string(i));
+    }
+}
+
+TEST(InternPoolTest, HashSpreadsSimilarKeys) {
+    std::set<uint64_t> low_bits;
+    for (int i = 0; i < 1000; ++i) {
+        low_bits.insert(string_utils::detail::hash_bytes("key" + std::to_string(i)) & 0xFFF);
+    }
+    // 1000 keys over 4096 buckets should rarely collide
+    EXPECT_GT(low_bits.size(), 850);
+}
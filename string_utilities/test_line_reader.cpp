@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "line_reader.h"
+#include "mapped_file.h"
+
+using string_utils::FieldReader;
+using string_utils::LineReader;
+using string_utils::MappedFile;
+
+// Writes contents to a file in the test temp directory and removes it afterwards
+class TempFile {
+public:
+    TempFile(const std::string& name, const std::string& contents) : m_path(::testing::TempDir() + name) {
+        std::ofstream out(m_path, std::ios::binary);
+        out << contents;
+    }
+    ~TempFile() { std::remove(m_path.c_str()); }
+
+    const std::string& path() const { return m_path; }
+
+private:
+    std::string m_path;
+};
+
+static std::vector<std::string> read_lines(LineReader& reader) {
+    std::vector<std::string> lines;
+    std::string_view line;
+    while (reader.next(line)) lines.emplace_back(line);
+    return lines;
+}
+
+TEST(LineReaderTest, TextLines) {
+    LineReader reader("first\nsecond\r\n\nlast");
+    EXPECT_EQ(read_lines(reader), (std::vector<std::string>{"first", "second", "", "last"}));
+    EXPECT_EQ(reader.offset(), 19);
+}
+
+TEST(LineReaderTest, FinalNewline) {
+    LineReader trailing("a\nb\n");
+    EXPECT_EQ(read_lines(trailing), (std::vector<std::string>{"a", "b"}));
+
+    LineReader empty("");
+    EXPECT_TRUE(read_lines(empty).empty());
+
+    LineReader blank("\n");
+    EXPECT_EQ(read_lines(blank), (std::vector<std::string>{""}));
+}
+
+TEST(LineReaderTest, MappedFile) {
+    TempFile file("line_reader_mapped.txt", "alpha\r\nbeta\ngamma\n");
+    MappedFile mapped(file.path());
+    EXPECT_EQ(mapped.size(), 18);
+    EXPECT_EQ(mapped.view(), "alpha\r\nbeta\ngamma\n");
+
+    LineReader reader(mapped);
+    EXPECT_EQ(read_lines(reader), (std::vector<std::string>{"alpha", "beta", "gamma"}));
+}
+
+TEST(LineReaderTest, EmptyFile) {
+    TempFile file("line_reader_empty.txt", "");
+    MappedFile mapped(file.path());
+    EXPECT_EQ(mapped.size(), 0);
+    EXPECT_TRUE(mapped.view().empty());
+
+    LineReader reader(mapped);
+    EXPECT_TRUE(read_lines(reader).empty());
+}
+
+TEST(LineReaderTest, MissingFileThrows) {
+    EXPECT_THROW(MappedFile(::testing::TempDir() + "line_reader_missing.txt"), std::system_error);
+}
+
+TEST(LineReaderTest, MoveKeepsMapping) {
+    TempFile file("line_reader_move.txt", "moved");
+    MappedFile first(file.path());
+    MappedFile second(std::move(first));
+    EXPECT_EQ(first.size(), 0);
+    EXPECT_EQ(second.view(), "moved");
+
+    // Releasing pages keeps the contents readable
+    second.release(0, second.size());
+    EXPECT_EQ(second.view(), "moved");
+}
+
+TEST(LineReaderTest, FieldReader) {
+    TempFile file("line_reader_fields.csv", "name,age\r\nalice,30\nbob,\n");
+    MappedFile mapped(file.path());
+    FieldReader reader(mapped, ',');
+
+    std::vector<std::string_view> fields;
+    ASSERT_TRUE(reader.next(fields));
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"name", "age"}));
+    ASSERT_TRUE(reader.next(fields));
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"alice", "30"}));
+    // Same trailing delimiter rule as split_view()
+    ASSERT_TRUE(reader.next(fields));
+    EXPECT_EQ(fields, (std::vector<std::string_view>{"bob"}));
+    EXPECT_FALSE(reader.next(fields));
+}
+
+// Passes the release window several times, so LineReader hands pages back more
+// than once and has to keep reading correct lines afterwards
+TEST(LineReaderTest, ReleasesConsumedPages) {
+    constexpr size_t window = 4 * 4096;
+    constexpr size_t line_size = 100;
+    const size_t count = 10 * window / line_size;
+    std::string contents;
+    contents.reserve(count * line_size);
+    const std::string filler(line_size - 11, 'x');
+    char number[11];
+    for (size_t i = 0; i < count; ++i) {
+        std::snprintf(number, sizeof number, "%09zu,", i);
+        contents.append(number).append(filler).push_back('\n');
+    }
+    TempFile file("line_reader_release.txt", contents);
+    MappedFile mapped(file.path());
+    ASSERT_EQ(mapped.size(), count * line_size);
+
+    LineReader reader(mapped, window);
+    std::string_view line;
+    size_t lines = 0;
+    bool all_match = true;
+    while (reader.next(line)) {
+        std::snprintf(number, sizeof number, "%09zu,", lines);
+        all_match = all_match && line.size() == line_size - 1 && line.substr(0, 10) == number;
+        ++lines;
+    }
+    EXPECT_TRUE(all_match);
+    EXPECT_EQ(lines, count);
+    EXPECT_GE(reader.released(), mapped.size() - 2 * window);
+    EXPECT_LE(reader.released(), mapped.size() - window);
+    // Released pages are read back from the file
+    EXPECT_EQ(mapped.view().substr(0, 10), "000000000,");
+
+    FieldReader fields_reader(mapped, ',');
+    std::vector<std::string_view> fields;
+    size_t records = 0;
+    while (fields_reader.next(fields)) {
+        all_match = all_match && fields.size() == 2 && fields[1] == filler;
+        ++records;
+    }
+    EXPECT_TRUE(all_match);
+    EXPECT_EQ(records, count);
+}
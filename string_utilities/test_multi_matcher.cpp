@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "multi_matcher.h"
+#include "string_utilities.h"
+
+using string_utils::MultiMatcher;
+
+// (pattern, position) pairs in a canonical order for comparisons
+static std::vector<std::pair<size_t, size_t>> sorted_hits(const std::vector<MultiMatcher::Match>& matches) {
+    std::vector<std::pair<size_t, size_t>> hits;
+    for (const auto& match : matches) hits.emplace_back(match.pattern, match.position);
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+// What a loop of find_all() calls, one per pattern, reports
+static std::vector<std::pair<size_t, size_t>> expected_hits(std::string_view text,
+                                                            const std::vector<std::string_view>& patterns) {
+    std::vector<std::pair<size_t, size_t>> hits;
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        if (patterns[id].empty()) continue;
+        for (size_t pos : string_utils::find_all(text, patterns[id])) hits.emplace_back(id, pos);
+    }
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+TEST(MultiMatcherTest, ClassicExample) {
+    std::vector<std::string_view> patterns = {"he", "she", "his", "hers"};
+    MultiMatcher matcher(patterns);
+
+    auto matches = matcher.find_all("ushers");
+    ASSERT_EQ(matches.size(), 3);
+    // Ordered by end position, longer matches first at the same end
+    EXPECT_EQ(matches[0].pattern, 1);
+    EXPECT_EQ(matches[0].position, 1);
+    EXPECT_EQ(matches[1].pattern, 0);
+    EXPECT_EQ(matches[1].position, 2);
+    EXPECT_EQ(matches[2].pattern, 3);
+    EXPECT_EQ(matches[2].position, 2);
+}
+
+TEST(MultiMatcherTest, EmptyAndDuplicatePatterns) {
+    std::vector<std::string_view> patterns = {"", "ab", "ab"};
+    MultiMatcher matcher(patterns);
+
+    EXPECT_EQ(matcher.pattern_count(), 3);
+    EXPECT_EQ(sorted_hits(matcher.find_all("abab")),
+              (std::vector<std::pair<size_t, size_t>>{{1, 0}, {1, 2}, {2, 0}, {2, 2}}));
+    EXPECT_TRUE(matcher.find_all("").empty());
+    EXPECT_TRUE(MultiMatcher({}).find_all("abc").empty());
+}
+
+TEST(MultiMatcherTest, LeftmostLongest) {
+    std::vector<std::string_view> patterns = {"b", "c", "abcx", "bcd"};
+    MultiMatcher matcher(patterns);
+
+    auto matches = matcher.find_leftmost_longest("abcdabc");
+    ASSERT_EQ(matches.size(), 3);
+    EXPECT_EQ(matches[0].pattern, 3); // "bcd" beats "b" starting at the same position
+    EXPECT_EQ(matches[0].position, 1);
+    EXPECT_EQ(matches[1].pattern, 0);
+    EXPECT_EQ(matches[1].position, 5);
+    EXPECT_EQ(matches[2].pattern, 1);
+    EXPECT_EQ(matches[2].position, 6);
+}
+
+// Many random patterns over a small alphabet exercise both dense and sparse states
+TEST(MultiMatcherTest, MatchesRepeatedFindAll) {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> pick(0, 3);
+    std::uniform_int_distribution<size_t> length(1, 6);
+
+    std::string text(3000, ' ');
+    for (auto& c : text) c = "abcd"[pick(rng)];
+
+    std::vector<std::string> storage;
+    for (int i = 0; i < 200; ++i) {
+        std::string pattern(length(rng), ' ');
+        for (auto& c : pattern) c = "abcd"[pick(rng)];
+        storage.push_back(pattern);
+    }
+    std::vector<std::string_view> patterns(storage.begin(), storage.end());
+
+    MultiMatcher matcher(patterns);
+    EXPECT_EQ(sorted_hits(matcher.find_all(text)), expected_hits(text, patterns));
+}
+
+TEST(MultiMatcherTest, StreamFindsMatchesAcrossChunks) {
+    std::vector<std::string_view> patterns = {"needle", "haystack", "eh"};
+    MultiMatcher matcher(patterns);
+    std::string text = "a needle in a haystack, another needle in the haystack";
+
+    auto whole = matcher.find_all(text);
+    for (size_t chunk_size : {1, 2, 3, 5, 7, 64}) {
+        auto stream = matcher.stream();
+        std::vector<MultiMatcher::Match> streamed;
+        for (size_t pos = 0; pos < text.size(); pos += chunk_size) {
+            stream.feed(std::string_view(text).substr(pos, chunk_size), streamed);
+        }
+        EXPECT_EQ(sorted_hits(streamed), sorted_hits(whole)) << "chunk size " << chunk_size;
+    }
+
+    auto stream = matcher.stream();
+    std::vector<MultiMatcher::Match> streamed;
+    stream.feed("nee", streamed);
+    stream.reset();
+    stream.feed("dle", streamed);
+    EXPECT_TRUE(streamed.empty());
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "numeric_parse.h"
+#include "string_utilities.h"
+
+using string_utils::ParseMode;
+
+TEST(NumericParseTest, Integers) {
+    int value = 0;
+    EXPECT_EQ(string_utils::parse_int("12345", value), std::errc{});
+    EXPECT_EQ(value, 12345);
+    EXPECT_EQ(string_utils::parse_int("-42", value), std::errc{});
+    EXPECT_EQ(value, -42);
+    EXPECT_EQ(string_utils::parse_int("000000000000000000000000007", value), std::errc{});
+    EXPECT_EQ(value, 7);
+
+    EXPECT_EQ(string_utils::parse_int("", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_int("-", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_int("12a4", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_int("1234567a", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_int(" 1", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_int("+1", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_int("2147483648", value), std::errc::result_out_of_range);
+
+    unsigned u = 0;
+    EXPECT_EQ(string_utils::parse_int("-1", u), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_int("4294967295", u), std::errc{});
+    EXPECT_EQ(u, 4294967295u);
+}
+
+TEST(NumericParseTest, IntegerLimits) {
+    int64_t i64 = 0;
+    EXPECT_EQ(string_utils::parse_int("-9223372036854775808", i64), std::errc{});
+    EXPECT_EQ(i64, std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(string_utils::parse_int("9223372036854775808", i64), std::errc::result_out_of_range);
+
+    uint64_t u64 = 0;
+    EXPECT_EQ(string_utils::parse_int("18446744073709551615", u64), std::errc{});
+    EXPECT_EQ(u64, std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(string_utils::parse_int("18446744073709551616", u64), std::errc::result_out_of_range);
+    EXPECT_EQ(string_utils::parse_int("123456789012345678901", u64), std::errc::result_out_of_range);
+
+    int8_t i8 = 0;
+    EXPECT_EQ(string_utils::parse_int("-128", i8), std::errc{});
+    EXPECT_EQ(i8, -128);
+    EXPECT_EQ(string_utils::parse_int("128", i8), std::errc::result_out_of_range);
+}
+
+// The eight digit fast path must agree with std::from_chars on every length
+TEST(NumericParseTest, IntegersMatchFromChars) {
+    std::mt19937_64 rng(11);
+    for (int round = 0; round < 5000; ++round) {
+        uint64_t number = rng() >> (rng() % 64);
+        std::string text = std::to_string(number);
+        if (round % 7 == 0) text[rng() % text.size()] = "x:/ "[round % 4];
+
+        uint64_t expected = 0;
+        auto reference = std::from_chars(text.data(), text.data() + text.size(), expected);
+        bool valid = reference.ec == std::errc{} && reference.ptr == text.data() + text.size();
+
+        uint64_t value = 0;
+        std::errc ec = string_utils::parse_int(text, value);
+        EXPECT_EQ(ec == std::errc{}, valid) << text;
+        if (valid) { EXPECT_EQ(value, expected) << text; }
+    }
+}
+
+TEST(NumericParseTest, Doubles) {
+    double value = 0;
+    EXPECT_EQ(string_utils::parse_double("123.45", value), std::errc{});
+    EXPECT_DOUBLE_EQ(value, 123.45);
+    EXPECT_EQ(string_utils::parse_double("-1e3", value), std::errc{});
+    EXPECT_DOUBLE_EQ(value, -1000.0);
+    EXPECT_EQ(string_utils::parse_double(".5", value), std::errc{});
+    EXPECT_DOUBLE_EQ(value, 0.5);
+
+    EXPECT_EQ(string_utils::parse_double("", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_double("1.5x", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_double("+1", value), std::errc::invalid_argument);
+    EXPECT_EQ(string_utils::parse_double("1e999", value), std::errc::result_out_of_range);
+}
+
+// Strict mode accepts what is_numeric() accepts, as long as it is a number at all
+TEST(NumericParseTest, StrictModeFollowsIsNumeric) {
+    for (const char* text : {"123", "-123", "+123", "123.45", "-123.45", "", "abc", "12.34.56",
+                             "12a34", "1e5", "inf", "1.", ".5", "+."}) {
+        double value = 0;
+        bool parsed = string_utils::parse_double(text, value, ParseMode::Strict) == std::errc{};
+        bool has_digit = std::string(text).find_first_of("0123456789") != std::string::npos;
+        EXPECT_EQ(parsed, string_utils::is_numeric(text) && has_digit) << text;
+    }
+
+    double value = 0;
+    EXPECT_EQ(string_utils::parse_double("+2.5", value, ParseMode::Strict), std::errc{});
+    EXPECT_DOUBLE_EQ(value, 2.5);
+
+    int i = 0;
+    EXPECT_EQ(string_utils::parse_int("+17", i, ParseMode::Strict), std::errc{});
+    EXPECT_EQ(i, 17);
+    EXPECT_EQ(string_utils::parse_int("1.5", i, ParseMode::Strict), std::errc::invalid_argument);
+}
+
+TEST(NumericParseTest, ParseColumn) {
+    std::vector<double> values;
+    EXPECT_EQ(string_utils::parse_column(string_utils::split_view("1.5,-2,3e2", ','), values), std::errc{});
+    EXPECT_EQ(values, (std::vector<double>{1.5, -2.0, 300.0}));
+
+    values.clear();
+    EXPECT_EQ(string_utils::parse_column(string_utils::split_view("4,x,6", ','), values),
+              std::errc::invalid_argument);
+    EXPECT_EQ(values, (std::vector<double>{4.0})); // fields before the bad one
+
+    values.clear();
+    EXPECT_EQ(string_utils::parse_column(string_utils::split_view("+1;2", ';'), values, ParseMode::Strict),
+              std::errc{});
+    EXPECT_EQ(values, (std::vector<double>{1.0, 2.0}));
+}
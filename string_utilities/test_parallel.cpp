@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "parallel.h"
+#include "string_utilities.h"
+
+using string_utils::ThreadPool;
+using string_utils::detail::parallel_count_chunked;
+using string_utils::detail::parallel_split_chunked;
+
+// Small alphabet so delimiters and self-overlapping patterns land on chunk boundaries
+static std::string random_text(std::mt19937& rng, size_t size) {
+    std::uniform_int_distribution<int> letter('a', 'c');
+    std::string text(size, ' ');
+    for (auto& ch : text) ch = static_cast<char>(letter(rng));
+    return text;
+}
+
+TEST(ParallelTest, ThreadPoolRunsEveryTask) {
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.size(), 3);
+
+    std::vector<int> seen(100, 0);
+    pool.run(seen.size(), [&](size_t i) { seen[i] += 1; });
+    EXPECT_EQ(seen, std::vector<int>(100, 1));
+
+    // The pool can be reused, and an empty batch returns immediately
+    pool.run(seen.size(), [&](size_t i) { seen[i] += 1; });
+    EXPECT_EQ(seen, std::vector<int>(100, 2));
+    pool.run(0, [](size_t) { FAIL(); });
+}
+
+TEST(ParallelTest, ThreadPoolRethrows) {
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.run(8, [](size_t i) { if (i == 5) throw std::runtime_error("task"); }), std::runtime_error);
+
+    // Still usable after a failed batch
+    size_t ran = 0;
+    pool.run(1, [&](size_t) { ++ran; });
+    EXPECT_EQ(ran, 1);
+}
+
+TEST(ParallelTest, SplitMatchesSequential) {
+    ThreadPool pool(3);
+    std::mt19937 rng(7);
+    for (size_t size : {0, 1, 2, 5, 31, 64, 257}) {
+        std::string text = random_text(rng, size);
+        for (size_t chunk : {1, 2, 3, 7, 16}) {
+            EXPECT_EQ(parallel_split_chunked(text, 'a', pool, chunk), string_utils::split(text, 'a'))
+                << text << " chunk " << chunk;
+        }
+    }
+
+    // Leading, trailing and repeated delimiters
+    for (std::string text : {",", ",,", ",a,,b,", "a,b,c,"}) {
+        EXPECT_EQ(parallel_split_chunked(text, ',', pool, 1), string_utils::split(text, ','));
+    }
+}
+
+TEST(ParallelTest, CountMatchesSequential) {
+    ThreadPool pool(3);
+    std::mt19937 rng(11);
+    for (size_t size : {0, 1, 3, 40, 257, 1000}) {
+        std::string text = random_text(rng, size);
+        for (std::string pattern : {"a", "aa", "aba", "abcab", "cccc"}) {
+            for (size_t chunk : {1, 2, 3, 5, 64}) {
+                EXPECT_EQ(parallel_count_chunked(text, pattern, pool, chunk),
+                          string_utils::count_occurrences(text, pattern))
+                    << text << " pattern " << pattern << " chunk " << chunk;
+            }
+        }
+    }
+
+    // Matches straddling every boundary shift the greedy alignment of the next chunk
+    std::string run(100, 'a');
+    EXPECT_EQ(parallel_count_chunked(run, "aaa", pool, 4), 33);
+    EXPECT_EQ(parallel_count_chunked(run, "", pool, 4), 0);
+}
+
+TEST(ParallelTest, DefaultPool) {
+    std::string text = "one two  three";
+    EXPECT_EQ(string_utils::parallel_split(text, ' '), string_utils::split(text, ' '));
+    EXPECT_EQ(string_utils::parallel_count_occurrences(text, "o"), 2);
+}
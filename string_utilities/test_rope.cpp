@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "rope.h"
+#include "string_utilities.h"
+
+using string_utils::Rope;
+
+static std::string random_text(std::mt19937& rng, size_t length, char last_letter = 'c') {
+    std::uniform_int_distribution<int> letter('a', last_letter);
+    std::string text(length, ' ');
+    for (auto& ch : text) ch = static_cast<char>(letter(rng));
+    return text;
+}
+
+// Concatenation of the pieces, checked against str() and substr() as well
+static std::string pieces_of(const Rope& rope) {
+    std::string joined;
+    size_t count = 0;
+    rope.for_each_piece([&](std::string_view piece) {
+        EXPECT_FALSE(piece.empty());
+        joined.append(piece);
+        ++count;
+        return true;
+    });
+    EXPECT_EQ(count, rope.piece_count());
+    EXPECT_EQ(joined, rope.str());
+    EXPECT_EQ(joined, rope.substr(0));
+    EXPECT_EQ(joined.size(), rope.size());
+    return joined;
+}
+
+TEST(RopeTest, Basics) {
+    Rope empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.str(), "");
+    EXPECT_EQ(empty.piece_count(), 0);
+
+    Rope rope(std::string("hello world"));
+    EXPECT_EQ(rope.size(), 11);
+    EXPECT_EQ(rope.piece_count(), 1);
+
+    rope.insert(5, ",");
+    rope.insert(rope.size(), "!");
+    rope.insert(0, ">> ");
+    EXPECT_EQ(pieces_of(rope), ">> hello, world!");
+    EXPECT_EQ(rope[3], 'h');
+    EXPECT_EQ(rope[8], ',');
+    EXPECT_EQ(rope[rope.size() - 1], '!');
+
+    rope.replace(10, 5, "rope");
+    EXPECT_EQ(pieces_of(rope), ">> hello, rope!");
+    rope.erase(0, 3);
+    EXPECT_EQ(pieces_of(rope), "hello, rope!");
+    EXPECT_EQ(rope.substr(7, 4), "rope");
+    EXPECT_EQ(rope.substr(7), "rope!");
+    rope.erase(5);
+    EXPECT_EQ(pieces_of(rope), "hello");
+
+    // Counts are clamped, positions past the end throw
+    rope.erase(3, 100);
+    EXPECT_EQ(rope.str(), "hel");
+    EXPECT_THROW(rope.insert(4, "x"), std::out_of_range);
+    EXPECT_THROW(rope.erase(4, 1), std::out_of_range);
+    EXPECT_THROW(rope.substr(4), std::out_of_range);
+    EXPECT_EQ(rope.substr(3), "");
+
+    rope.compact();
+    EXPECT_EQ(rope.piece_count(), 1);
+    EXPECT_EQ(pieces_of(rope), "hel");
+}
+
+TEST(RopeTest, RandomEditsMatchString) {
+    std::mt19937 rng(20);
+    std::string model = random_text(rng, 500);
+    Rope rope(model);
+
+    for (int step = 0; step < 3000; ++step) {
+        size_t pos = std::uniform_int_distribution<size_t>(0, model.size())(rng);
+        size_t count = std::uniform_int_distribution<size_t>(0, 20)(rng);
+        std::string text = random_text(rng, std::uniform_int_distribution<size_t>(0, 12)(rng));
+        switch (step % 3) {
+        case 0:
+            model.insert(pos, text);
+            rope.insert(pos, text);
+            break;
+        case 1:
+            model.erase(pos, count);
+            rope.erase(pos, count);
+            break;
+        default:
+            model.replace(pos, count, text);
+            rope.replace(pos, count, text);
+            break;
+        }
+        ASSERT_EQ(rope.size(), model.size()) << step;
+        if (step % 100 == 0) {
+            ASSERT_EQ(pieces_of(rope), model) << step;
+            size_t from = std::uniform_int_distribution<size_t>(0, model.size())(rng);
+            EXPECT_EQ(rope.substr(from, count * 10), model.substr(from, count * 10));
+            if (!model.empty()) {
+                EXPECT_EQ(rope[from % model.size()], model[from % model.size()]);
+            }
+        }
+        if (step == 1500) rope.compact();
+    }
+    EXPECT_EQ(rope.str(), model);
+}
+
+TEST(RopeTest, BatchedEdits) {
+    Rope rope(std::string("The quick brown fox"));
+    rope.apply({{16, 3, "dog"}, {4, 6, ""}, {0, 0, "> "}, {19, 0, "."}, {10, 0, "very "}});
+    EXPECT_EQ(pieces_of(rope), "> The very brown dog.");
+
+    // An insertion at the start of a replaced range goes in front of the replacement
+    Rope front(std::string("abc"));
+    front.apply({{1, 1, "X"}, {1, 0, "+"}});
+    EXPECT_EQ(front.str(), "a+Xc");
+
+    Rope overlapping(std::string("abcdef"));
+    EXPECT_THROW(overlapping.apply({{0, 3, "x"}, {2, 1, "y"}}), std::invalid_argument);
+    EXPECT_THROW(overlapping.apply({{7, 0, "x"}}), std::out_of_range);
+    EXPECT_EQ(overlapping.str(), "abcdef");
+
+    // Edits given in any order match the same edits applied one by one from the back
+    std::mt19937 rng(5);
+    std::string model = random_text(rng, 2000);
+    Rope batched(model);
+    std::vector<Rope::Edit> edits;
+    std::vector<std::string> texts;
+    texts.reserve(100);
+    for (size_t pos = 0; pos + 20 <= model.size(); pos += 20) {
+        texts.push_back(random_text(rng, pos % 7));
+        edits.push_back({pos + pos % 5, pos % 11, texts.back()});
+    }
+    for (auto edit = edits.rbegin(); edit != edits.rend(); ++edit) {
+        model.replace(edit->position, edit->length, edit->text);
+    }
+    std::shuffle(edits.begin(), edits.end(), rng);
+    batched.apply(edits);
+    EXPECT_EQ(pieces_of(batched), model);
+
+    // A small batch on a rope of many pieces is applied one edit at a time
+    ASSERT_GT(batched.piece_count(), 100);
+    batched.apply({{10, 5, "small"}, {1000, 0, "batch"}, {10, 0, "a "}});
+    model.replace(1000, 0, "batch");
+    model.replace(10, 5, "a small");
+    EXPECT_EQ(pieces_of(batched), model);
+}
+
+TEST(RopeTest, FindAllAcrossPieces) {
+    std::mt19937 rng(11);
+    for (int round = 0; round < 200; ++round) {
+        // Many small pieces so matches straddle several of them, and every other round
+        // large ones as well, which are searched in place rather than copied
+        const bool large = round % 2 != 0;
+        std::string model = random_text(rng, large ? 2000 : 50, 'b');
+        Rope rope(model);
+        for (int i = 0; i < 30; ++i) {
+            size_t pos = std::uniform_int_distribution<size_t>(0, model.size())(rng);
+            size_t length = large && i % 3 == 0 ? 300 : std::uniform_int_distribution<size_t>(1, 3)(rng);
+            std::string text = random_text(rng, length, 'b');
+            model.insert(pos, text);
+            rope.insert(pos, text);
+        }
+        for (const char* pattern : {"a", "ab", "aba", "bbab", "aabba", "abababab"}) {
+            EXPECT_EQ(string_utils::find_all(rope, pattern), string_utils::find_all(model, pattern))
+                << model << " / " << pattern;
+        }
+    }
+    // A pattern longer than the large piece in its middle
+    Rope spanning(std::string(600, 'a'));
+    spanning.insert(300, std::string(300, 'b'));
+    const std::string pattern = std::string(100, 'a') + std::string(300, 'b') + std::string(100, 'a');
+    EXPECT_EQ(string_utils::find_all(spanning, pattern), std::vector<size_t>{200});
+
+    EXPECT_EQ(string_utils::find_all(Rope(std::string("abc")), ""), (std::vector<size_t>{0, 1, 2, 3}));
+    EXPECT_TRUE(string_utils::find_all(Rope(), "a").empty());
+}
+
+TEST(RopeTest, ReplaceMatchesStringVersions) {
+    std::mt19937 rng(3);
+    for (int round = 0; round < 200; ++round) {
+        std::string model = random_text(rng, 80, 'b');
+        Rope rope(model);
+        rope.insert(40, "ab");
+        model.insert(40, "ab");
+
+        const std::string from = random_text(rng, static_cast<size_t>(round % 4 + 1), 'b');
+        const std::string to = random_text(rng, static_cast<size_t>(round % 3), 'c');
+        std::string expected = string_utils::replace_all(model, from, to);
+        size_t count = string_utils::replace_all(rope, from, to);
+        EXPECT_EQ(count, string_utils::count_occurrences(model, from));
+        EXPECT_EQ(pieces_of(rope), expected);
+
+        std::string first = string_utils::replace_first(expected, from, "X");
+        EXPECT_EQ(string_utils::replace_first(rope, from, "X"), expected.find(from) != std::string::npos);
+        EXPECT_EQ(rope.str(), first);
+    }
+
+    Rope rope(std::string("{{name}} and {{name}}"));
+    EXPECT_EQ(string_utils::replace_all(rope, "", "x"), 0);
+    EXPECT_FALSE(string_utils::replace_first(rope, "", "x"));
+    EXPECT_EQ(string_utils::replace_all(rope, "{{name}}", "Ada"), 2);
+    EXPECT_EQ(rope.str(), "Ada and Ada");
+    EXPECT_FALSE(string_utils::replace_first(rope, "Bob", "x"));
+}
+
+TEST(RopeTest, ChainedTemplateReplacements) {
+    std::string document;
+    for (int i = 0; i < 200; ++i) {
+        document += "<p>Dear {{title}} {{name}}, order {{order}} ships on {{date}}.</p>\n";
+    }
+    Rope rope(document);
+    const std::vector<std::pair<std::string, std::string>> fields = {
+        {"{{title}}", "Dr."}, {"{{name}}", "Ada Lovelace"}, {"{{order}}", "#1815"}, {"{{date}}", "Monday"}};
+    for (const auto& [from, to] : fields) {
+        document = string_utils::replace_all(document, from, to);
+        EXPECT_EQ(string_utils::replace_all(rope, from, to), 200);
+    }
+    EXPECT_EQ(rope.str(), document);
+    // Every replacement became a piece, the text around them was not copied
+    EXPECT_GT(rope.piece_count(), 800);
+}
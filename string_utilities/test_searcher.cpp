@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "searcher.h"
+#include "string_utilities.h"
+
+using string_utils::Searcher;
+
+// Straightforward std::string_view::find based references
+static std::vector<size_t> naive_find_all(std::string_view text, std::string_view pattern) {
+    std::vector<size_t> positions;
+    for (size_t pos = text.find(pattern); pos != std::string_view::npos; pos = text.find(pattern, pos + 1)) {
+        positions.push_back(pos);
+    }
+    return positions;
+}
+
+static size_t naive_count(std::string_view text, std::string_view pattern, size_t step) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string_view::npos; pos = text.find(pattern, pos + step)) {
+        ++count;
+    }
+    return count;
+}
+
+TEST(SearcherTest, BasicSearch) {
+    std::string text = "the quick brown fox jumps over the lazy fox";
+    Searcher fox("fox");
+
+    EXPECT_EQ(fox.pattern(), "fox");
+    EXPECT_EQ(fox.find(text), 16);
+    EXPECT_EQ(fox.find(text, 17), 40);
+    EXPECT_EQ(fox.find(text, 41), std::string::npos);
+    EXPECT_EQ(fox.find_all(text), (std::vector<size_t>{16, 40}));
+    EXPECT_EQ(fox.count(text), 2);
+    EXPECT_TRUE(fox.contains(text));
+    EXPECT_FALSE(Searcher("cat").contains(text));
+}
+
+TEST(SearcherTest, OverlapModes) {
+    Searcher aa("aa");
+    EXPECT_EQ(aa.count("aaaaa"), 2);
+    EXPECT_EQ(aa.count("aaaaa", Searcher::Overlap::Disallowed), 2);
+    EXPECT_EQ(aa.count("aaaaa", Searcher::Overlap::Allowed), 4);
+    EXPECT_EQ(aa.find_all("aaaaa").size(), 4);
+}
+
+TEST(SearcherTest, EmptyPatternAndText) {
+    Searcher empty("");
+    EXPECT_EQ(empty.count("abc"), 0);
+    EXPECT_EQ(empty.find_all("abc"), string_utils::find_all("abc", ""));
+    EXPECT_EQ(Searcher("abc").find(""), std::string::npos);
+    EXPECT_EQ(Searcher("abc").count(""), 0);
+}
+
+// Short patterns take the vector filter, long ones Horspool, both must agree with find
+TEST(SearcherTest, MatchesNaiveSearch) {
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> pick(0, 2);
+
+    std::string text(5000, ' ');
+    for (auto& c : text) c = "abc"[pick(rng)];
+
+    for (size_t length : {1, 2, 3, 7, 16, 31, 32, 33, 48, 100}) {
+        std::uniform_int_distribution<size_t> offset(0, text.size() - length);
+        // One pattern copied out of the text so it matches, one random so it mostly does not
+        std::string present = text.substr(offset(rng), length);
+        std::string random(length, ' ');
+        for (auto& c : random) c = "abc"[pick(rng)];
+
+        for (const auto& pattern : {present, random}) {
+            Searcher searcher(pattern);
+            EXPECT_EQ(searcher.find_all(text), naive_find_all(text, pattern)) << pattern;
+            EXPECT_EQ(searcher.count(text, Searcher::Overlap::Allowed), naive_count(text, pattern, 1));
+            EXPECT_EQ(searcher.count(text), naive_count(text, pattern, length));
+            EXPECT_EQ(searcher.contains(text), text.find(pattern) != std::string::npos);
+            EXPECT_EQ(string_utils::find_all(text, pattern), naive_find_all(text, pattern));
+            EXPECT_EQ(string_utils::count_occurrences(text, pattern), naive_count(text, pattern, length));
+        }
+    }
+}
+
+TEST(SearcherTest, LongPatternAtEdges) {
+    std::string pattern(40, 'x');
+    pattern.back() = 'y';
+    std::string text = pattern + std::string(100, 'x') + pattern;
+
+    Searcher searcher(pattern);
+    EXPECT_EQ(searcher.find_all(text), (std::vector<size_t>{0, 140}));
+    EXPECT_EQ(searcher.find(text, 141), std::string::npos);
+    EXPECT_EQ(searcher.find(text.substr(0, 39)), std::string::npos);
+}
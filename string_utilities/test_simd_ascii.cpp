@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include "simd_ascii.h"
+#include "string_utilities.h"
+
+using namespace string_utils::detail;
+
+// The <cctype> based implementations the kernels replaced
+namespace reference {
+
+std::string to_upper(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return str;
+}
+
+std::string to_lower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+
+bool is_numeric(const std::string& str) {
+    if (str.empty()) return false;
+
+    size_t start = 0;
+    if (str[0] == '+' || str[0] == '-') start = 1;
+    if (start >= str.length()) return false;
+
+    bool has_decimal = false;
+    for (size_t i = start; i < str.length(); ++i) {
+        if (str[i] == '.') {
+            if (has_decimal) return false;
+            has_decimal = true;
+        } else if (!std::isdigit(static_cast<unsigned char>(str[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_alpha(const std::string& str) {
+    return !str.empty() && std::all_of(str.begin(), str.end(),
+                                       [](unsigned char c) { return std::isalpha(c); });
+}
+
+bool is_alphanumeric(const std::string& str) {
+    return !str.empty() && std::all_of(str.begin(), str.end(),
+                                       [](unsigned char c) { return std::isalnum(c); });
+}
+
+} // namespace reference
+
+class SimdAsciiFuzzTest : public ::testing::Test {
+protected:
+    // Mostly one class of characters with an occasional outlier, so both
+    // outcomes of the classification functions are exercised
+    std::string random_string(const std::string& alphabet, size_t length) {
+        std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+        std::uniform_int_distribution<int> any_byte(0, 255);
+        std::uniform_int_distribution<int> outlier(0, 99);
+        std::string str(length, ' ');
+        for (auto& c : str) {
+            c = outlier(rng) == 0 ? static_cast<char>(any_byte(rng)) : alphabet[pick(rng)];
+        }
+        return str;
+    }
+
+    std::mt19937 rng{1234};
+    const std::string letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const std::string digits = "0123456789";
+};
+
+TEST_F(SimdAsciiFuzzTest, CaseConversionMatchesReference) {
+    std::uniform_int_distribution<int> any_byte(0, 255);
+    for (size_t length = 0; length < 300; ++length) {
+        std::string str(length, ' ');
+        for (auto& c : str) c = static_cast<char>(any_byte(rng));
+
+        std::string upper = reference::to_upper(str);
+        std::string lower = reference::to_lower(str);
+        EXPECT_EQ(string_utils::to_upper(str), upper);
+        EXPECT_EQ(string_utils::to_lower(str), lower);
+
+        std::string inplace = str;
+        string_utils::to_upper_inplace(inplace);
+        EXPECT_EQ(inplace, upper);
+        string_utils::to_lower_inplace(inplace);
+        EXPECT_EQ(inplace, reference::to_lower(upper));
+
+        std::string out(length, ' ');
+        convert_case_scalar(str.data(), out.data(), length, true);
+        EXPECT_EQ(out, upper);
+#if STRING_UTILS_HAS_SSE2
+        convert_case_sse2(str.data(), out.data(), length, false);
+        EXPECT_EQ(out, lower);
+#endif
+#if STRING_UTILS_HAS_AVX2
+        if (cpu_has_avx2()) {
+            convert_case_avx2(str.data(), out.data(), length, true);
+            EXPECT_EQ(out, upper);
+        }
+#endif
+    }
+}
+
+TEST_F(SimdAsciiFuzzTest, ClassificationMatchesReference) {
+    for (int round = 0; round < 2000; ++round) {
+        size_t length = round % 100;
+        std::string alpha = random_string(letters, length);
+        std::string alnum = random_string(letters + digits, length);
+        std::string numeric = random_string(digits + ".", length);
+        if (round % 3 == 0 && length > 0) numeric[0] = "+-"[round % 2];
+
+        EXPECT_EQ(string_utils::is_alpha(alpha), reference::is_alpha(alpha)) << alpha;
+        EXPECT_EQ(string_utils::is_alphanumeric(alnum), reference::is_alphanumeric(alnum)) << alnum;
+        EXPECT_EQ(string_utils::is_numeric(numeric), reference::is_numeric(numeric)) << numeric;
+
+        bool expected = all_of_class_scalar(alnum, CharClass::Alnum);
+#if STRING_UTILS_HAS_SSE2
+        EXPECT_EQ(all_of_class_sse2(alnum, CharClass::Alnum), expected);
+#endif
+#if STRING_UTILS_HAS_AVX2
+        if (cpu_has_avx2()) { EXPECT_EQ(all_of_class_avx2(alnum, CharClass::Alnum), expected); }
+#endif
+    }
+}
+
+TEST_F(SimdAsciiFuzzTest, NumericEdgeCases) {
+    for (const char* str : {".", "+.", "-", "1.", ".5", "1..2", "+-1", "1e5", " 1"}) {
+        EXPECT_EQ(string_utils::is_numeric(str), reference::is_numeric(str)) << str;
+    }
+}
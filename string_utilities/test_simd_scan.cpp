@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "simd_scan.h"
+
+using namespace string_utils::detail;
+
+// Random text over a small alphabet so the delimiter shows up often
+static std::string random_text(std::mt19937& rng, size_t length) {
+    std::uniform_int_distribution<int> pick(0, 3);
+    const char alphabet[] = {'a', 'b', ',', ';'};
+    std::string text(length, ' ');
+    for (auto& c : text) c = alphabet[pick(rng)];
+    return text;
+}
+
+// Test every kernel agrees with the scalar reference on all lengths around the vector widths
+TEST(SimdScanTest, KernelsMatchScalar) {
+    std::mt19937 rng(42);
+
+    for (size_t length = 0; length < 200; ++length) {
+        std::string text = random_text(rng, length);
+
+        std::vector<size_t> expected;
+        find_char_positions_scalar(text, ',', expected);
+
+        std::vector<size_t> positions;
+        find_char_positions(text, ',', positions);
+        EXPECT_EQ(positions, expected) << "length " << length;
+
+#if STRING_UTILS_HAS_SSE2
+        positions.clear();
+        find_char_positions_sse2(text, ',', positions);
+        EXPECT_EQ(positions, expected) << "length " << length;
+#endif
+#if STRING_UTILS_HAS_AVX2
+        if (cpu_has_avx2()) {
+            positions.clear();
+            find_char_positions_avx2(text, ',', positions);
+            EXPECT_EQ(positions, expected) << "length " << length;
+        }
+#endif
+
+        for (size_t from = 0; from <= length; from += 7) {
+            size_t first = find_char_scalar(text, ';', from);
+            EXPECT_EQ(find_char(text, ';', from), first);
+#if STRING_UTILS_HAS_SSE2
+            EXPECT_EQ(find_char_sse2(text, ';', from), first);
+#endif
+#if STRING_UTILS_HAS_AVX2
+            if (cpu_has_avx2()) { EXPECT_EQ(find_char_avx2(text, ';', from), first); }
+#endif
+        }
+    }
+}
+
+TEST(SimdScanTest, NoMatchAndHighBytes) {
+    std::string text(100, 'x');
+    text[77] = '\xff';
+
+    EXPECT_EQ(find_char(text, ','), std::string::npos);
+    EXPECT_EQ(find_char(text, '\xff'), 77);
+    EXPECT_EQ(find_char(text, 'x', 200), std::string::npos);
+
+    std::vector<size_t> positions;
+    find_char_positions(text, '\xff', positions);
+    EXPECT_EQ(positions, std::vector<size_t>{77});
+}
+
+TEST(SimdScanTest, SubstringKernelsMatchScalar) {
+    std::mt19937 rng(7);
+
+    for (size_t length = 0; length < 150; ++length) {
+        std::string text = random_text(rng, length);
+        for (size_t pattern_length = 1; pattern_length <= 6; ++pattern_length) {
+            std::string pattern = random_text(rng, pattern_length);
+            for (size_t from = 0; from <= length + 1; from += 5) {
+                size_t expected = find_substring_scalar(text, pattern, from);
+                EXPECT_EQ(find_substring(text, pattern, from), expected);
+#if STRING_UTILS_HAS_SSE2
+                EXPECT_EQ(find_substring_sse2(text, pattern, from), expected);
+#endif
+#if STRING_UTILS_HAS_AVX2
+                if (cpu_has_avx2()) { EXPECT_EQ(find_substring_avx2(text, pattern, from), expected); }
+#endif
+            }
+        }
+    }
+}
+
+// Runs of set members of every length on both sides of one non-member, for a listed
+// set, one with high bytes and one too large for the SSE2 kernels
+TEST(SimdScanTest, TrimKernelsMatchScalar) {
+    std::string many;
+    for (int c = 0; c < 40; ++c) many += static_cast<char>(c);
+    const string_utils::CharSet sets[] = {string_utils::whitespace_chars, string_utils::CharSet("\x80\xFF \xA0"),
+                                          string_utils::CharSet(many)};
+    const char fills[][3] = {{' ', '\t', '\n'}, {'\x80', '\xFF', ' '}, {'\0', '\x1F', '\x27'}};
+    const char outsiders[] = {'x', '\x7F', '\xFE', '\x81', '('};
+
+    for (size_t s = 0; s < 3; ++s) {
+        for (size_t left = 0; left < 80; ++left) {
+            for (size_t right : {size_t{0}, size_t{1}, size_t{31}, size_t{33}, left}) {
+                for (char outsider : outsiders) {
+                    std::string text;
+                    for (size_t i = 0; i < left; ++i) text += fills[s][i % 3];
+                    text += outsider;
+                    for (size_t i = 0; i < right; ++i) text += fills[s][(i + 1) % 3];
+
+                    EXPECT_EQ(leading_in_set_scalar(text, sets[s]), left);
+                    EXPECT_EQ(trailing_in_set_scalar(text, sets[s]), right);
+                    EXPECT_EQ(leading_in_set(text, sets[s]), left) << s << " " << left;
+                    EXPECT_EQ(trailing_in_set(text, sets[s]), right) << s << " " << right;
+#if STRING_UTILS_HAS_SSE2
+                    if (sets[s].size() <= string_utils::CharSet::max_listed) {
+                        EXPECT_EQ(leading_in_set_sse2(text, sets[s]), left);
+                        EXPECT_EQ(trailing_in_set_sse2(text, sets[s]), right);
+                    }
+#endif
+#if STRING_UTILS_HAS_AVX2
+                    if (cpu_has_avx2()) {
+                        EXPECT_EQ(leading_in_set_avx2(text, sets[s]), left) << s << " " << left;
+                        EXPECT_EQ(trailing_in_set_avx2(text, sets[s]), right) << s << " " << right;
+                    }
+#endif
+                }
+            }
+        }
+
+        // Nothing but members
+        std::string all(100, fills[s][0]);
+        EXPECT_EQ(leading_in_set(all, sets[s]), 100);
+        EXPECT_EQ(trailing_in_set(all, sets[s]), 100);
+    }
+}
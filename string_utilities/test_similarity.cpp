@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "similarity.h"
+
+using string_utils::levenshtein;
+using string_utils::levenshtein_bounded;
+using string_utils::MinHasher;
+
+// Textbook dynamic programming, one row at a time
+static size_t reference_levenshtein(std::string_view a, std::string_view b) {
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = j;
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+static std::string random_string(std::mt19937& rng, size_t length, char last_letter) {
+    std::uniform_int_distribution<int> letter('a', last_letter);
+    std::string str(length, ' ');
+    for (auto& ch : str) ch = static_cast<char>(letter(rng));
+    return str;
+}
+
+// Copy of str with about edits random substitutions, insertions and deletions
+static std::string mutate(std::mt19937& rng, std::string str, size_t edits) {
+    std::uniform_int_distribution<int> kind(0, 2);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    for (size_t e = 0; e < edits; ++e) {
+        size_t pos = std::uniform_int_distribution<size_t>(0, str.size())(rng);
+        int k = kind(rng);
+        if (k == 0 && pos < str.size()) {
+            str[pos] = static_cast<char>(letter(rng));
+        } else if (k == 1 || str.empty()) {
+            str.insert(str.begin() + static_cast<std::ptrdiff_t>(pos), static_cast<char>(letter(rng)));
+        } else if (pos < str.size()) {
+            str.erase(pos, 1);
+        }
+    }
+    return str;
+}
+
+TEST(SimilarityTest, LevenshteinKnownDistances) {
+    EXPECT_EQ(levenshtein("", ""), 0);
+    EXPECT_EQ(levenshtein("", "abc"), 3);
+    EXPECT_EQ(levenshtein("abc", ""), 3);
+    EXPECT_EQ(levenshtein("kitten", "sitting"), 3);
+    EXPECT_EQ(levenshtein("sitting", "kitten"), 3);
+    EXPECT_EQ(levenshtein("flaw", "lawn"), 2);
+    EXPECT_EQ(levenshtein("same", "same"), 0);
+    EXPECT_EQ(levenshtein(std::string(200, 'a'), std::string(100, 'a')), 100);
+    EXPECT_EQ(levenshtein(std::string(100, 'a'), std::string(100, 'b')), 100);
+
+    // Bytes above 0x7F index the match masks like any other
+    EXPECT_EQ(levenshtein("gr\xC3\xBC\xC3\x9F", "gruss"), 4);
+}
+
+TEST(SimilarityTest, LevenshteinMatchesReferenceAcrossWordBoundaries) {
+    std::mt19937 rng(19);
+    const std::vector<size_t> lengths = {0, 1, 2, 7, 63, 64, 65, 127, 128, 129, 200, 300};
+    for (size_t m : lengths) {
+        for (size_t n : lengths) {
+            for (char last : {'b', 'z'}) {
+                std::string a = random_string(rng, m, last);
+                std::string b = random_string(rng, n, last);
+                EXPECT_EQ(levenshtein(a, b), reference_levenshtein(a, b)) << a << " / " << b;
+            }
+        }
+    }
+}
+
+TEST(SimilarityTest, KernelsMatchReferenceWithoutStripping) {
+    // The common prefix and suffix are stripped before the kernels run, so feed them
+    // directly to exercise them on strings that share both
+    std::mt19937 rng(64);
+    for (int round = 0; round < 300; ++round) {
+        size_t m = static_cast<size_t>(round) % 64 + 1;
+        std::string a = random_string(rng, m, 'd');
+        std::string b = mutate(rng, a, static_cast<size_t>(round) % 8);
+        EXPECT_EQ(string_utils::detail::levenshtein_single_word(a, b, SIZE_MAX - 1), reference_levenshtein(a, b));
+
+        std::string long_a = random_string(rng, m * 5, 'd');
+        std::string long_b = mutate(rng, long_a, static_cast<size_t>(round) % 40);
+        EXPECT_EQ(string_utils::detail::levenshtein_blocks(long_a, long_b, SIZE_MAX - 1),
+                  reference_levenshtein(long_a, long_b));
+        EXPECT_EQ(string_utils::detail::levenshtein_blocks(a, b, SIZE_MAX - 1), reference_levenshtein(a, b));
+    }
+}
+
+TEST(SimilarityTest, BoundedIsCappedAtMaxPlusOne) {
+    std::mt19937 rng(7);
+    for (int round = 0; round < 400; ++round) {
+        size_t length = std::uniform_int_distribution<size_t>(0, 260)(rng);
+        std::string a = random_string(rng, length, 'z');
+        std::string b = round % 2 ? mutate(rng, a, static_cast<size_t>(round) % 30) : random_string(rng, length, 'z');
+        size_t exact = reference_levenshtein(a, b);
+        for (size_t max : {size_t{0}, size_t{1}, size_t{5}, size_t{20}, size_t{100}, SIZE_MAX - 1}) {
+            EXPECT_EQ(levenshtein_bounded(a, b, max), std::min(exact, max + 1)) << max;
+        }
+    }
+    EXPECT_EQ(levenshtein_bounded("abc", "abcdefgh", 2), 3); // rejected on the length difference alone
+    EXPECT_EQ(levenshtein_bounded("abc", "abc", 0), 0);
+}
+
+TEST(SimilarityTest, MinHashSignatures) {
+    MinHasher hasher(128, 3, 42);
+    EXPECT_EQ(hasher.hashes(), 128);
+    EXPECT_EQ(hasher.ngram(), 3);
+
+    auto signature = hasher.signature("connection reset by peer");
+    ASSERT_EQ(signature.size(), 128);
+    EXPECT_EQ(MinHasher::similarity(signature, hasher.signature("connection reset by peer")), 1.0);
+
+    // Only the set of n-grams counts, not how often they occur
+    EXPECT_EQ(hasher.signature("abcabc"), hasher.signature("abcabcabc"));
+
+    // An empty string has no n-grams, a short one is a single n-gram
+    EXPECT_EQ(hasher.signature(""), std::vector<uint64_t>(128, UINT64_MAX));
+    EXPECT_NE(hasher.signature("ab"), hasher.signature("ba"));
+    EXPECT_EQ(MinHasher::similarity(hasher.signature("ab"), hasher.signature("ab")), 1.0);
+
+    // The same seed gives the same family, another seed a different one
+    EXPECT_EQ(MinHasher(128, 3, 42).signature("seeded"), hasher.signature("seeded"));
+    EXPECT_NE(MinHasher(128, 3, 43).signature("seeded"), hasher.signature("seeded"));
+
+    // Reusing the output vector replaces its contents
+    std::vector<uint64_t> reused(5, 1);
+    hasher.signature("connection reset by peer", reused);
+    EXPECT_EQ(reused, signature);
+
+    EXPECT_EQ(MinHasher::similarity({}, {}), 0.0);
+    EXPECT_EQ(MinHasher::similarity(signature, std::vector<uint64_t>(64)), 0.0);
+
+    EXPECT_THROW(MinHasher(0, 3), std::invalid_argument);
+    EXPECT_THROW(MinHasher(64, 0), std::invalid_argument);
+}
+
+TEST(SimilarityTest, MinHashEstimatesJaccard) {
+    auto grams = [](std::string_view str, size_t n) {
+        std::set<std::string_view> set;
+        for (size_t i = 0; i + n <= str.size(); ++i) set.insert(str.substr(i, n));
+        return set;
+    };
+
+    std::mt19937 rng(2024);
+    MinHasher hasher(256, 4, 1);
+    double total_error = 0;
+    const int rounds = 60;
+    for (int round = 0; round < rounds; ++round) {
+        std::string a = random_string(rng, 150, 'z');
+        std::string b = mutate(rng, a, static_cast<size_t>(round));
+
+        auto set_a = grams(a, 4);
+        auto set_b = grams(b, 4);
+        std::vector<std::string_view> common;
+        std::set_intersection(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(), std::back_inserter(common));
+        double jaccard = static_cast<double>(common.size()) /
+                         static_cast<double>(set_a.size() + set_b.size() - common.size());
+
+        double estimate = MinHasher::similarity(hasher.signature(a), hasher.signature(b));
+        // About 1 / sqrt(256) = 0.0625 standard error, well inside four of them
+        EXPECT_NEAR(estimate, jaccard, 0.25) << round;
+        total_error += std::abs(estimate - jaccard);
+    }
+    EXPECT_LT(total_error / rounds, 0.06);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "split_result.h"
+#include "string_utilities.h"
+
+using string_utils::SplitResult;
+
+static std::vector<std::string> to_strings(const SplitResult& result) {
+    return std::vector<std::string>(result.begin(), result.end());
+}
+
+TEST(SplitResultTest, MatchesSplit) {
+    SplitResult result;
+    for (std::string text : {"", ",", "a", "a,b", "a,,b,", ",leading", "no delimiters here"}) {
+        string_utils::split_into(result, text, ',');
+        EXPECT_EQ(to_strings(result), string_utils::split(text, ',')) << text;
+        EXPECT_EQ(result.size(), string_utils::split(text, ',').size());
+    }
+
+    for (std::string text : {"", "::", "a::b", "a::::b::", "a:b"}) {
+        string_utils::split_into(result, text, "::");
+        EXPECT_EQ(to_strings(result), string_utils::split(text, std::string("::"))) << text;
+    }
+}
+
+TEST(SplitResultTest, IndexAndIteration) {
+    SplitResult result;
+    EXPECT_TRUE(result.empty());
+    EXPECT_EQ(result.begin(), result.end());
+
+    string_utils::split_into(result, "alpha,,a_token_longer_than_any_small_string_buffer", ',');
+    ASSERT_EQ(result.size(), 3);
+    EXPECT_EQ(result[0], "alpha");
+    EXPECT_EQ(result[1], "");
+    EXPECT_EQ(result[2], "a_token_longer_than_any_small_string_buffer");
+
+    // All tokens live in one buffer, one after the other
+    EXPECT_EQ(result[0].data() + result[0].size(), result[2].data());
+
+    // Works with the range based helpers
+    EXPECT_EQ(string_utils::join(result, "|"), "alpha||a_token_longer_than_any_small_string_buffer");
+}
+
+TEST(SplitResultTest, ResetAndPushBack) {
+    SplitResult result;
+    string_utils::split_into(result, "a,b,c", ',');
+    result.reset();
+    EXPECT_TRUE(result.empty());
+
+    result.push_back("x");
+    result.push_back("");
+    result.push_back("yz");
+    EXPECT_EQ(to_strings(result), (std::vector<std::string>{"x", "", "yz"}));
+
+    // split_into() replaces whatever was there
+    string_utils::split_into(result, "q", ',');
+    EXPECT_EQ(to_strings(result), (std::vector<std::string>{"q"}));
+}
@@ -1,193 +1,415 @@
-#include <gtest/gtest.h>
-#include <string>
-#include <vector>
-#include "string_utilities.h"
-
-// Test fixture for string utilities
-class StringUtilitiesTest : public ::testing::Test {
-protected:
-    void SetUp() override {
-        // Common test data
-        empty_str = "";
-        whitespace_str = "  \t\n\r  ";
-        mixed_case_str = "HeLLo WoRLd";
-        numeric_str = "12345";
-        alpha_str = "abcdef";
-        alphanum_str = "abc123";
-        csv_data = "apple,banana,cherry";
-    }
-
-    std::string empty_str;
-    std::string whitespace_str;
-    std::string mixed_case_str;
-    std::string numeric_str;
-    std::string alpha_str;
-    std::string alphanum_str;
-    std::string csv_data;
-};
-
-// Test case conversion functions
-TEST_F(StringUtilitiesTest, CaseConversion) {
-    EXPECT_EQ(string_utils::to_upper("hello"), "HELLO");
-    EXPECT_EQ(string_utils::to_upper("Hello World!"), "HELLO WORLD!");
-    EXPECT_EQ(string_utils::to_upper("123abc"), "123ABC");
-    EXPECT_EQ(string_utils::to_upper(""), "");
-
-    EXPECT_EQ(string_utils::to_lower("HELLO"), "hello");
-    EXPECT_EQ(string_utils::to_lower("Hello World!"), "hello world!");
-    EXPECT_EQ(string_utils::to_lower("123ABC"), "123abc");
-    EXPECT_EQ(string_utils::to_lower(""), "");
-}
-
-// Test trimming functions
-TEST_F(StringUtilitiesTest, TrimmingOperations) {
-    EXPECT_EQ(string_utils::trim_left("  hello  "), "hello  ");
-    EXPECT_EQ(string_utils::trim_right("  hello  "), "  hello");
-    EXPECT_EQ(string_utils::trim("  hello  "), "hello");
-
-    EXPECT_EQ(string_utils::trim("\t\n hello \r\n"), "hello");
-    EXPECT_EQ(string_utils::trim(""), "");
-    EXPECT_EQ(string_utils::trim("   "), "");
-    EXPECT_EQ(string_utils::trim("nospaces"), "nospaces");
-}
-
-// Test string splitting
-TEST_F(StringUtilitiesTest, StringSplitting) {
-    auto result = string_utils::split("a,b,c", ',');
-    EXPECT_EQ(result.size(), 3);
-    EXPECT_EQ(result[0], "a");
-    EXPECT_EQ(result[1], "b");
-    EXPECT_EQ(result[2], "c");
-
-    auto result2 = string_utils::split("hello::world::test", "::");
-    EXPECT_EQ(result2.size(), 3);
-    EXPECT_EQ(result2[0], "hello");
-    EXPECT_EQ(result2[1], "world");
-    EXPECT_EQ(result2[2], "test");
-
-    auto empty_result = string_utils::split("", ',');
-    EXPECT_EQ(empty_result.size(), 1);
-    EXPECT_EQ(empty_result[0], "");
-}
-
-// Test string validation functions
-TEST_F(StringUtilitiesTest, StringValidation) {
-    // Numeric validation
-    EXPECT_TRUE(string_utils::is_numeric("123"));
-    EXPECT_TRUE(string_utils::is_numeric("-123"));
-    EXPECT_TRUE(string_utils::is_numeric("+123"));
-    EXPECT_TRUE(string_utils::is_numeric("123.45"));
-    EXPECT_TRUE(string_utils::is_numeric("-123.45"));
-    EXPECT_FALSE(string_utils::is_numeric(""));
-    EXPECT_FALSE(string_utils::is_numeric("abc"));
-    EXPECT_FALSE(string_utils::is_numeric("12.34.56"));
-    EXPECT_FALSE(string_utils::is_numeric("12a34"));
-
-    // Alpha validation
-    EXPECT_TRUE(string_utils::is_alpha("abc"));
-    EXPECT_TRUE(string_utils::is_alpha("ABC"));
-    EXPECT_TRUE(string_utils::is_alpha("aBc"));
-    EXPECT_FALSE(string_utils::is_alpha(""));
-    EXPECT_FALSE(string_utils::is_alpha("abc123"));
-    EXPECT_FALSE(string_utils::is_alpha("123"));
-
-    // Alphanumeric validation
-    EXPECT_TRUE(string_utils::is_alphanumeric("abc123"));
-    EXPECT_TRUE(string_utils::is_alphanumeric("123"));
-    EXPECT_TRUE(string_utils::is_alphanumeric("abc"));
-    EXPECT_FALSE(string_utils::is_alphanumeric(""));
-    EXPECT_FALSE(string_utils::is_alphanumeric("abc 123"));
-    EXPECT_FALSE(string_utils::is_alphanumeric("abc-123"));
-}
-
-// Test prefix/suffix checking
-TEST_F(StringUtilitiesTest, PrefixSuffixChecking) {
-    std::string text = "hello world";
-
-    EXPECT_TRUE(string_utils::starts_with(text, "hello"));
-    EXPECT_TRUE(string_utils::starts_with(text, ""));
-    EXPECT_FALSE(string_utils::starts_with(text, "world"));
-    EXPECT_FALSE(string_utils::starts_with(text, "hello world extra"));
-
-    EXPECT_TRUE(string_utils::ends_with(text, "world"));
-    EXPECT_TRUE(string_utils::ends_with(text, ""));
-    EXPECT_FALSE(string_utils::ends_with(text, "hello"));
-    EXPECT_FALSE(string_utils::ends_with(text, "extra hello world"));
-}
-
-// Test string replacement
-TEST_F(StringUtilitiesTest, StringReplacement) {
-    std::string text = "hello world hello universe";
-
-    EXPECT_EQ(string_utils::replace_first(text, "hello", "hi"),
-              "hi world hello universe");
-    EXPECT_EQ(string_utils::replace_all(text, "hello", "hi"),
-              "hi world hi universe");
-
-    EXPECT_EQ(string_utils::replace_all(text, "xyz", "abc"), text);
-    EXPECT_EQ(string_utils::replace_all(text, "", "abc"), text);
-}
-
-// Test string joining
-TEST_F(StringUtilitiesTest, StringJoining) {
-    std::vector<std::string> words = {"hello", "world", "test"};
-
-    EXPECT_EQ(string_utils::join(words, " "), "hello world test");
-    EXPECT_EQ(string_utils::join(words, ", "), "hello, world, test");
-    EXPECT_EQ(string_utils::join(words, ""), "helloworldtest");
-
-    std::vector<std::string> empty_vec;
-    EXPECT_EQ(string_utils::join(empty_vec, " "), "");
-
-    std::vector<std::string> single = {"alone"};
-    EXPECT_EQ(string_utils::join(single, " "), "alone");
-}
-
-// Test search functions
-TEST_F(StringUtilitiesTest, SearchOperations) {
-    std::string text = "the quick brown fox jumps over the lazy fox";
-
-    auto positions = string_utils::find_all(text, "fox");
-    EXPECT_EQ(positions.size(), 2);
-    EXPECT_EQ(positions[0], 16);
-    EXPECT_EQ(positions[1], 40);
-
-    EXPECT_EQ(string_utils::count_occurrences(text, "the"), 2);
-    EXPECT_EQ(string_utils::count_occurrences(text, "fox"), 2);
-    EXPECT_EQ(string_utils::count_occurrences(text, "cat"), 0);
-    EXPECT_EQ(string_utils::count_occurrences(text, ""), 0);
-}
-
-// Test edge cases and boundary conditions
-TEST_F(StringUtilitiesTest, EdgeCases) {
-    // Empty strings
-    EXPECT_EQ(string_utils::to_upper(""), "");
-    EXPECT_EQ(string_utils::trim(""), "");
-    EXPECT_FALSE(string_utils::is_numeric(""));
-    EXPECT_EQ(string_utils::replace_all("", "a", "b"), "");
-
-    // Single character strings
-    EXPECT_EQ(string_utils::to_upper("a"), "A");
-    EXPECT_EQ(string_utils::trim(" "), "");
-    EXPECT_TRUE(string_utils::is_alpha("a"));
-
-    // Very long strings (basic test for performance)
-    std::string long_str(10000, 'a');
-    EXPECT_EQ(string_utils::to_upper(long_str), std::string(10000, 'A'));
-}
-
-// Performance-oriented tests
-TEST_F(StringUtilitiesTest, BasicPerformanceChecks) {
-    // Test that operations don't cause excessive copying
-    std::string large_text(1000, 'x');
-    large_text += "find_me";
-    large_text += std::string(1000, 'y');
-
-    // These operations should complete in reasonable time
-    auto result = string_utils::find_all(large_text, "find_me");
-    EXPECT_EQ(result.size(), 1);
-    EXPECT_EQ(result[0], 1000);
-
-    size_t count = string_utils::count_occurrences(large_text, "x");
-    EXPECT_EQ(count, 1000);
-}
\ No newline at end of file
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "string_utilities.h"
+#include "split_result.h"
+#include "alloc_counter.h"
+
+// Test fixture for string utilities
+class StringUtilitiesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Common test data
+        empty_str = "";
+        whitespace_str = "  \t\n\r  ";
+        mixed_case_str = "HeLLo WoRLd";
+        numeric_str = "12345";
+        alpha_str = "abcdef";
+        alphanum_str = "abc123";
+        csv_data = "apple,banana,cherry";
+    }
+
+    std::string empty_str;
+    std::string whitespace_str;
+    std::string mixed_case_str;
+    std::string numeric_str;
+    std::string alpha_str;
+    std::string alphanum_str;
+    std::string csv_data;
+};
+
+// Test case conversion functions
+TEST_F(StringUtilitiesTest, CaseConversion) {
+    EXPECT_EQ(string_utils::to_upper("hello"), "HELLO");
+    EXPECT_EQ(string_utils::to_upper("Hello World!"), "HELLO WORLD!");
+    EXPECT_EQ(string_utils::to_upper("123abc"), "123ABC");
+    EXPECT_EQ(string_utils::to_upper(""), "");
+
+    EXPECT_EQ(string_utils::to_lower("HELLO"), "hello");
+    EXPECT_EQ(string_utils::to_lower("Hello World!"), "hello world!");
+    EXPECT_EQ(string_utils::to_lower("123ABC"), "123abc");
+    EXPECT_EQ(string_utils::to_lower(""), "");
+}
+
+// Test trimming functions
+TEST_F(StringUtilitiesTest, TrimmingOperations) {
+    EXPECT_EQ(string_utils::trim_left("  hello  "), "hello  ");
+    EXPECT_EQ(string_utils::trim_right("  hello  "), "  hello");
+    EXPECT_EQ(string_utils::trim("  hello  "), "hello");
+
+    EXPECT_EQ(string_utils::trim("\t\n hello \r\n"), "hello");
+    EXPECT_EQ(string_utils::trim(""), "");
+    EXPECT_EQ(string_utils::trim("   "), "");
+    EXPECT_EQ(string_utils::trim("nospaces"), "nospaces");
+}
+
+// Test string splitting
+TEST_F(StringUtilitiesTest, StringSplitting) {
+    auto result = string_utils::split("a,b,c", ',');
+    EXPECT_EQ(result.size(), 3);
+    EXPECT_EQ(result[0], "a");
+    EXPECT_EQ(result[1], "b");
+    EXPECT_EQ(result[2], "c");
+
+    auto result2 = string_utils::split("hello::world::test", "::");
+    EXPECT_EQ(result2.size(), 3);
+    EXPECT_EQ(result2[0], "hello");
+    EXPECT_EQ(result2[1], "world");
+    EXPECT_EQ(result2[2], "test");
+
+    auto empty_result = string_utils::split("", ',');
+    EXPECT_EQ(empty_result.size(), 1);
+    EXPECT_EQ(empty_result[0], "");
+}
+
+// Test string validation functions
+TEST_F(StringUtilitiesTest, StringValidation) {
+    // Numeric validation
+    EXPECT_TRUE(string_utils::is_numeric("123"));
+    EXPECT_TRUE(string_utils::is_numeric("-123"));
+    EXPECT_TRUE(string_utils::is_numeric("+123"));
+    EXPECT_TRUE(string_utils::is_numeric("123.45"));
+    EXPECT_TRUE(string_utils::is_numeric("-123.45"));
+    EXPECT_FALSE(string_utils::is_numeric(""));
+    EXPECT_FALSE(string_utils::is_numeric("abc"));
+    EXPECT_FALSE(string_utils::is_numeric("12.34.56"));
+    EXPECT_FALSE(string_utils::is_numeric("12a34"));
+
+    // Alpha validation
+    EXPECT_TRUE(string_utils::is_alpha("abc"));
+    EXPECT_TRUE(string_utils::is_alpha("ABC"));
+    EXPECT_TRUE(string_utils::is_alpha("aBc"));
+    EXPECT_FALSE(string_utils::is_alpha(""));
+    EXPECT_FALSE(string_utils::is_alpha("abc123"));
+    EXPECT_FALSE(string_utils::is_alpha("123"));
+
+    // Alphanumeric validation
+    EXPECT_TRUE(string_utils::is_alphanumeric("abc123"));
+    EXPECT_TRUE(string_utils::is_alphanumeric("123"));
+    EXPECT_TRUE(string_utils::is_alphanumeric("abc"));
+    EXPECT_FALSE(string_utils::is_alphanumeric(""));
+    EXPECT_FALSE(string_utils::is_alphanumeric("abc 123"));
+    EXPECT_FALSE(string_utils::is_alphanumeric("abc-123"));
+}
+
+// Test prefix/suffix checking
+TEST_F(StringUtilitiesTest, PrefixSuffixChecking) {
+    std::string text = "hello world";
+
+    EXPECT_TRUE(string_utils::starts_with(text, "hello"));
+    EXPECT_TRUE(string_utils::starts_with(text, ""));
+    EXPECT_FALSE(string_utils::starts_with(text, "world"));
+    EXPECT_FALSE(string_utils::starts_with(text, "hello world extra"));
+
+    EXPECT_TRUE(string_utils::ends_with(text, "world"));
+    EXPECT_TRUE(string_utils::ends_with(text, ""));
+    EXPECT_FALSE(string_utils::ends_with(text, "hello"));
+    EXPECT_FALSE(string_utils::ends_with(text, "extra hello world"));
+}
+
+// Test string replacement
+TEST_F(StringUtilitiesTest, StringReplacement) {
+    std::string text = "hello world hello universe";
+
+    EXPECT_EQ(string_utils::replace_first(text, "hello", "hi"),
+              "hi world hello universe");
+    EXPECT_EQ(string_utils::replace_all(text, "hello", "hi"),
+              "hi world hi universe");
+
+    EXPECT_EQ(string_utils::replace_all(text, "xyz", "abc"), text);
+    EXPECT_EQ(string_utils::replace_all(text, "", "abc"), text);
+}
+
+// Test replacements that change the length on larger inputs
+TEST_F(StringUtilitiesTest, ReplaceAllResizes) {
+    std::string text;
+    std::string expected_longer;
+    std::string expected_shorter;
+    for (int i = 0; i < 1000; ++i) {
+        text += "{x}-";
+        expected_longer += "value-";
+        expected_shorter += "-";
+    }
+
+    EXPECT_EQ(string_utils::replace_all(text, "{x}", "value"), expected_longer);
+    EXPECT_EQ(string_utils::replace_all(text, "{x}", ""), expected_shorter);
+    EXPECT_EQ(string_utils::replace_all("aaaa", "aa", "b"), "bb");   // non-overlapping
+    EXPECT_EQ(string_utils::replace_all("aaa", "a", "aa"), "aaaaaa"); // output is not rescanned
+}
+
+// Test single pass multi-pattern replacement
+TEST_F(StringUtilitiesTest, ReplaceAllMultiPattern) {
+    EXPECT_EQ(string_utils::replace_all("Hello {name}, you owe {amount}.",
+                                        {{"{name}", "Ada"}, {"{amount}", "42"}}),
+              "Hello Ada, you owe 42.");
+
+    // Substitutions happen simultaneously, so swapping works
+    EXPECT_EQ(string_utils::replace_all("cat and dog", {{"cat", "dog"}, {"dog", "cat"}}),
+              "dog and cat");
+
+    // Leftmost match wins, then the longest one
+    EXPECT_EQ(string_utils::replace_all("abcd", {{"bc", "X"}, {"abcd", "Y"}}), "Y");
+    EXPECT_EQ(string_utils::replace_all("abcd", {{"b", "1"}, {"c", "2"}, {"abcx", "3"}}), "a12d");
+    EXPECT_EQ(string_utils::replace_all("she sells", {{"he", "1"}, {"she", "2"}, {"s", "3"}}),
+              "2 3ell3");
+
+    // Empty patterns and lists leave the input alone
+    EXPECT_EQ(string_utils::replace_all("text", {{"", "x"}}), "text");
+    EXPECT_EQ(string_utils::replace_all("text", {}), "text");
+    EXPECT_EQ(string_utils::replace_all("", {{"a", "b"}}), "");
+
+    // Agrees with the single pattern version
+    std::string text = "hello world hello universe";
+    EXPECT_EQ(string_utils::replace_all(text, {{"hello", "hi"}}),
+              string_utils::replace_all(text, "hello", "hi"));
+}
+
+// Test string joining
+TEST_F(StringUtilitiesTest, StringJoining) {
+    std::vector<std::string> words = {"hello", "world", "test"};
+
+    EXPECT_EQ(string_utils::join(words, " "), "hello world test");
+    EXPECT_EQ(string_utils::join(words, ", "), "hello, world, test");
+    EXPECT_EQ(string_utils::join(words, ""), "helloworldtest");
+
+    std::vector<std::string> empty_vec;
+    EXPECT_EQ(string_utils::join(empty_vec, " "), "");
+
+    std::vector<std::string> single = {"alone"};
+    EXPECT_EQ(string_utils::join(single, " "), "alone");
+}
+
+// Test joining other string-like ranges
+TEST_F(StringUtilitiesTest, GenericJoining) {
+    std::vector<std::string_view> views = {"hello", "world"};
+    EXPECT_EQ(string_utils::join(views, " "), "hello world");
+
+    const char* literals[] = {"a", "b", "c"};
+    EXPECT_EQ(string_utils::join(literals, "-"), "a-b-c");
+
+    EXPECT_EQ(string_utils::join(string_utils::split_view(csv_data, ','), " | "),
+              "apple | banana | cherry");
+    EXPECT_EQ(string_utils::join(string_utils::split_view("", ','), ","), "");
+
+    std::vector<std::string_view> none;
+    EXPECT_EQ(string_utils::join(none, ","), "");
+}
+
+// Test join_into appends and reuses the caller's buffer
+TEST_F(StringUtilitiesTest, JoinIntoReusesBuffer) {
+    std::vector<std::string> fields = {"field_one_is_long_enough", "field_two_is_long_enough", "3"};
+
+    std::string line = "row: ";
+    string_utils::join_into(line, fields, ", ");
+    EXPECT_EQ(line, "row: field_one_is_long_enough, field_two_is_long_enough, 3");
+
+    // Exact sizing allocates once, a buffer with enough capacity not at all
+    alloc_counter::Scope once;
+    std::string joined = string_utils::join(fields, ",");
+    EXPECT_EQ(once.count(), 1);
+
+    line.clear();
+    alloc_counter::Scope reused;
+    for (int i = 0; i < 10; ++i) {
+        line.clear();
+        string_utils::join_into(line, fields, ",");
+    }
+    EXPECT_EQ(reused.count(), 0);
+    EXPECT_EQ(line, joined);
+}
+
+// Test search functions
+TEST_F(StringUtilitiesTest, SearchOperations) {
+    std::string text = "the quick brown fox jumps over the lazy fox";
+
+    auto positions = string_utils::find_all(text, "fox");
+    EXPECT_EQ(positions.size(), 2);
+    EXPECT_EQ(positions[0], 16);
+    EXPECT_EQ(positions[1], 40);
+
+    EXPECT_EQ(string_utils::count_occurrences(text, "the"), 2);
+    EXPECT_EQ(string_utils::count_occurrences(text, "fox"), 2);
+    EXPECT_EQ(string_utils::count_occurrences(text, "cat"), 0);
+    EXPECT_EQ(string_utils::count_occurrences(text, ""), 0);
+}
+
+// Test edge cases and boundary conditions
+TEST_F(StringUtilitiesTest, EdgeCases) {
+    // Empty strings
+    EXPECT_EQ(string_utils::to_upper(""), "");
+    EXPECT_EQ(string_utils::trim(""), "");
+    EXPECT_FALSE(string_utils::is_numeric(""));
+    EXPECT_EQ(string_utils::replace_all("", "a", "b"), "");
+
+    // Single character strings
+    EXPECT_EQ(string_utils::to_upper("a"), "A");
+    EXPECT_EQ(string_utils::trim(" "), "");
+    EXPECT_TRUE(string_utils::is_alpha("a"));
+
+    // Very long strings (basic test for performance)
+    std::string long_str(10000, 'a');
+    EXPECT_EQ(string_utils::to_upper(long_str), std::string(10000, 'A'));
+}
+
+// Performance-oriented tests
+TEST_F(StringUtilitiesTest, BasicPerformanceChecks) {
+    // Test that operations don't cause excessive copying
+    std::string large_text(1000, 'x');
+    large_text += "find_me";
+    large_text += std::string(1000, 'y');
+
+    // These operations should complete in reasonable time
+    auto result = string_utils::find_all(large_text, "find_me");
+    EXPECT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0], 1000);
+
+    size_t count = string_utils::count_occurrences(large_text, "x");
+    EXPECT_EQ(count, 1000);
+}
+
+// Test non-owning trimming
+TEST_F(StringUtilitiesTest, TrimViews) {
+    std::string text = "\t\n hello \r\n";
+
+    auto trimmed = string_utils::trim_view(text);
+    EXPECT_EQ(trimmed, "hello");
+    EXPECT_EQ(trimmed.data(), text.data() + 3); // points into the input
+    EXPECT_EQ(string_utils::trim_left_view("  hello  "), "hello  ");
+    EXPECT_EQ(string_utils::trim_right_view("  hello  "), "  hello");
+    EXPECT_EQ(string_utils::trim_view(whitespace_str), "");
+    EXPECT_EQ(string_utils::trim_view(empty_str), "");
+}
+
+// Test trimming of other character sets and in place
+TEST_F(StringUtilitiesTest, TrimCharSetsAndInplace) {
+    constexpr string_utils::CharSet quotes("\"' ");
+    static_assert(string_utils::trim_view(" \"quoted\" ", quotes) == "quoted");
+    EXPECT_EQ(string_utils::trim_view(" \"quoted\" ", quotes), "quoted");
+    EXPECT_EQ(string_utils::trim_left_view("--x--", string_utils::CharSet("-")), "x--");
+    EXPECT_EQ(string_utils::trim_right_view("--x--", string_utils::CharSet("-")), "--x");
+    EXPECT_EQ(string_utils::trim_view("\t x \n", string_utils::CharSet()), "\t x \n");
+
+    // A set built at runtime
+    std::string separators = ";,";
+    EXPECT_EQ(string_utils::trim_view(",;a;b;,", string_utils::CharSet(separators)), "a;b");
+
+    std::string str = "  \t" + std::string(100, 'x') + "\r\n";
+    const char* data = str.data();
+    const size_t capacity = str.capacity();
+    string_utils::trim_inplace(str);
+    EXPECT_EQ(str, std::string(100, 'x'));
+    EXPECT_EQ(str.data(), data);
+    EXPECT_EQ(str.capacity(), capacity);
+
+    str = " \t\n ";
+    string_utils::trim_inplace(str);
+    EXPECT_EQ(str, "");
+    str = "**a**";
+    string_utils::trim_inplace(str, string_utils::CharSet("*"));
+    EXPECT_EQ(str, "a");
+}
+
+// Test lazy splitting matches split() token for token
+TEST_F(StringUtilitiesTest, SplitViewMatchesSplit) {
+    const std::vector<std::string> inputs = {
+        "", ",", ",,", "a", "a,b,c", ",a", "a,", "a,,b", "a,b,,", csv_data
+    };
+
+    for (const auto& input : inputs) {
+        std::vector<std::string> lazy;
+        for (auto token : string_utils::split_view(input, ',')) {
+            lazy.emplace_back(token);
+        }
+        EXPECT_EQ(lazy, string_utils::split(input, ',')) << "input: '" << input << "'";
+    }
+
+    std::vector<std::string> multi;
+    for (auto token : string_utils::split_view("hello::world::", "::")) {
+        multi.emplace_back(token);
+    }
+    EXPECT_EQ(multi, (std::vector<std::string>{"hello", "world", ""}));
+    EXPECT_EQ(multi, string_utils::split("hello::world::", "::"));
+}
+
+// Test splitting long lines that span several vector blocks
+TEST_F(StringUtilitiesTest, SplitLongLine) {
+    std::string line;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 200; ++i) {
+        expected.push_back(std::string(i % 37, 'a' + i % 26));
+        line += expected.back() + ",";
+    }
+
+    EXPECT_EQ(string_utils::split(line, ','), expected);
+    EXPECT_EQ(string_utils::split(line, ",").size(), expected.size() + 1); // keeps the trailing token
+    EXPECT_EQ(string_utils::find_all(line, ",").size(), expected.size());
+    EXPECT_EQ(string_utils::find_all(line, ",").back(), line.size() - 1);
+}
+
+TEST_F(StringUtilitiesTest, SplitEmptyDelimiter) {
+    auto result = string_utils::split("abc", "");
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0], "abc");
+}
+
+// Test the string_view API does not touch the heap
+TEST_F(StringUtilitiesTest, ViewApiDoesNotAllocate) {
+    std::string line;
+    for (int i = 0; i < 100; ++i) {
+        line += "a_field_longer_than_the_small_string_buffer_" + std::to_string(i) + ",";
+    }
+
+    size_t tokens = 0;
+    size_t total_length = 0;
+    alloc_counter::Scope scope;
+    for (auto token : string_utils::split_view(line, ',')) {
+        total_length += string_utils::trim_view(token).size();
+        tokens += string_utils::starts_with(token, "a_field") ? 1 : 0;
+    }
+    size_t count = string_utils::count_occurrences(line, "field");
+    bool suffix = string_utils::ends_with(line, "99,");
+    EXPECT_EQ(scope.count(), 0);
+
+    EXPECT_EQ(tokens, 100);
+    EXPECT_GT(total_length, 100 * 44);
+    EXPECT_EQ(count, 100);
+    EXPECT_TRUE(suffix);
+
+    // The owning API allocates at least once per long token
+    alloc_counter::Scope owning;
+    auto owned = string_utils::split(line, ',');
+    EXPECT_GE(owning.count(), owned.size());
+}
+
+// Test a reused SplitResult reaches zero allocations per record
+TEST_F(StringUtilitiesTest, SplitResultSteadyState) {
+    std::vector<std::string> records;
+    for (int i = 0; i < 10; ++i) {
+        records.push_back("host_" + std::to_string(i) + ".example.com,GET,/a/path/longer_than_sso," +
+                          std::to_string(200 + i));
+    }
+
+    string_utils::SplitResult fields;
+    string_utils::split_into(fields, records[0], ',');
+    ASSERT_EQ(fields.size(), 4);
+
+    alloc_counter::Scope steady;
+    size_t bytes = 0;
+    for (const auto& record : records) {
+        string_utils::split_into(fields, record, ',');
+        bytes += fields[0].size();
+    }
+    EXPECT_EQ(steady.count(), 0);
+    EXPECT_EQ(fields[0], "host_9.example.com");
+    EXPECT_GT(bytes, 0);
+}
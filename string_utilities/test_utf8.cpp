@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "string_utilities.h"
+#include "utf8.h"
+
+using namespace string_utils::detail;
+
+// Straightforward bit-pattern decoder, written independently of the lead byte table
+static bool reference_valid(std::string_view str) {
+    size_t i = 0;
+    while (i < str.size()) {
+        uint8_t c = static_cast<uint8_t>(str[i]);
+        size_t length = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > str.size()) return false;
+
+        uint32_t cp = length == 1 ? c : c & (0xFF >> (length + 1));
+        for (size_t k = 1; k < length; ++k) {
+            uint8_t next = static_cast<uint8_t>(str[i + k]);
+            if ((next & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        const uint32_t min[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < min[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+        i += length;
+    }
+    return true;
+}
+
+static void expect_all_validators(std::string_view str, bool expected) {
+    EXPECT_EQ(string_utils::is_valid_utf8(str), expected) << testing::PrintToString(std::string(str));
+    EXPECT_EQ(is_valid_utf8_scalar(str), expected);
+#if STRING_UTILS_HAS_SSE2
+    EXPECT_EQ(is_valid_utf8_sse2(str), expected);
+#endif
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) { EXPECT_EQ(is_valid_utf8_avx2(str), expected); }
+#endif
+}
+
+TEST(Utf8Test, ValidationCases) {
+    expect_all_validators("", true);
+    expect_all_validators("plain ascii", true);
+    expect_all_validators("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80", true); // é € 😀
+    expect_all_validators("\xF4\x8F\xBF\xBF", true);                          // U+10FFFF
+
+    expect_all_validators("\x80", false);             // lone continuation
+    expect_all_validators("\xC3", false);             // truncated
+    expect_all_validators("\xC3x", false);            // lead followed by ASCII
+    expect_all_validators("\xC0\x80", false);         // overlong NUL
+    expect_all_validators("\xE0\x80\x80", false);     // overlong 3 byte
+    expect_all_validators("\xF0\x80\x80\x80", false); // overlong 4 byte
+    expect_all_validators("\xED\xA0\x80", false);     // surrogate
+    expect_all_validators("\xF4\x90\x80\x80", false); // above U+10FFFF
+    expect_all_validators("\xF5\x80\x80\x80", false);
+    expect_all_validators("\xFF", false);
+    expect_all_validators("\xE2\x82\xAC\x80", false); // one continuation too many
+}
+
+TEST(Utf8Test, AllShortSequences) {
+    // Every one and two byte string, and every three byte string with a lead byte
+    // from the multi-byte range
+    std::string str(2, ' ');
+    for (int a = 0; a < 256; ++a) {
+        std::string one(1, static_cast<char>(a));
+        ASSERT_EQ(is_valid_utf8_scalar(one), reference_valid(one)) << a;
+        for (int b = 0; b < 256; ++b) {
+            str[0] = static_cast<char>(a);
+            str[1] = static_cast<char>(b);
+            ASSERT_EQ(string_utils::is_valid_utf8(str), reference_valid(str)) << a << " " << b;
+            ASSERT_EQ(is_valid_utf8_scalar(str), reference_valid(str)) << a << " " << b;
+        }
+    }
+
+    std::string three(3, ' ');
+    for (int a = 0xC0; a < 256; ++a) {
+        for (int b = 0x70; b < 0xD0; ++b) {
+            for (int c = 0x70; c < 0xD0; ++c) {
+                three[0] = static_cast<char>(a);
+                three[1] = static_cast<char>(b);
+                three[2] = static_cast<char>(c);
+                ASSERT_EQ(string_utils::is_valid_utf8(three), reference_valid(three)) << a << " " << b << " " << c;
+            }
+        }
+    }
+}
+
+TEST(Utf8Test, SequencesAcrossBlockBoundaries) {
+    const std::vector<std::string> pieces = {"\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xED\xA0\x80",
+                                             "\xF0\x9F\x98", "\x80", "\xE0\x80\x80"};
+    for (const auto& piece : pieces) {
+        for (size_t pos = 0; pos < 70; ++pos) {
+            std::string str(pos, 'a');
+            str += piece;
+            str += std::string(70 - pos, 'b');
+            expect_all_validators(str, reference_valid(str));
+
+            // The same piece cut off by the end of the input
+            std::string tail(pos, 'a');
+            tail += piece;
+            expect_all_validators(tail, reference_valid(tail));
+        }
+    }
+}
+
+TEST(Utf8Test, RandomMutations) {
+    std::mt19937 rng(3);
+    const std::string valid = "Gr\xC3\xBC\xC3\x9F" "e, \xCE\xBA\xCF\x8C\xCF\x83\xCE\xBC\xCE\xB5, "
+                              "\xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x8C\x8D plain text between them. ";
+    std::string text;
+    for (int i = 0; i < 20; ++i) text += valid;
+    ASSERT_TRUE(reference_valid(text));
+
+    std::uniform_int_distribution<size_t> position(0, text.size() - 1);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (int round = 0; round < 2000; ++round) {
+        std::string mutated = text;
+        mutated[position(rng)] = static_cast<char>(byte(rng));
+        expect_all_validators(mutated, reference_valid(mutated));
+    }
+}
+
+TEST(Utf8Test, AsciiPrefixKernels) {
+    for (size_t pos = 0; pos < 80; ++pos) {
+        std::string str(100, 'x');
+        str[pos] = '\xC3';
+        EXPECT_EQ(ascii_prefix(str), pos);
+        EXPECT_EQ(ascii_prefix_scalar(str), pos);
+#if STRING_UTILS_HAS_SSE2
+        EXPECT_EQ(ascii_prefix_sse2(str), pos);
+#endif
+#if STRING_UTILS_HAS_AVX2
+        if (cpu_has_avx2()) { EXPECT_EQ(ascii_prefix_avx2(str), pos); }
+#endif
+    }
+    EXPECT_EQ(ascii_prefix(std::string(100, 'x')), 100);
+}
+
+TEST(Utf8Test, CaseConversion) {
+    // Latin-1, Greek, Cyrillic and Armenian letters next to ASCII
+    EXPECT_EQ(string_utils::utf8_to_lower("\xC3\x80\xC3\x89 ABC \xCE\x91\xCE\xA3 \xD0\x96 \xD4\xB1"),
+              "\xC3\xA0\xC3\xA9 abc \xCE\xB1\xCF\x83 \xD0\xB6 \xD5\xA1");
+    EXPECT_EQ(string_utils::utf8_to_upper("\xC3\xA0\xC3\xA9 abc \xCE\xB1\xCF\x83 \xD0\xB6 \xD5\xA1"),
+              "\xC3\x80\xC3\x89 ABC \xCE\x91\xCE\xA3 \xD0\x96 \xD4\xB1");
+
+    // U+023A lowercases to the three byte U+2C65
+    EXPECT_EQ(string_utils::utf8_to_lower("\xC8\xBA"), "\xE2\xB1\xA5");
+    // U+00DF only has a multi-character uppercase and is kept
+    EXPECT_EQ(string_utils::utf8_to_upper("stra\xC3\x9F" "e"), "STRA\xC3\x9F" "E");
+    // Bytes that are not UTF-8 pass through
+    EXPECT_EQ(string_utils::utf8_to_lower("A\xFF" "B\xC3"), "a\xFF" "b\xC3");
+    EXPECT_EQ(string_utils::utf8_to_lower(""), "");
+
+    // The ASCII result matches the byte-wise functions on long inputs
+    std::string ascii;
+    for (int i = 0; i < 10000; ++i) ascii += static_cast<char>(32 + i % 95);
+    EXPECT_EQ(string_utils::utf8_to_lower(ascii), string_utils::to_lower(ascii));
+    EXPECT_EQ(string_utils::utf8_to_upper(ascii), string_utils::to_upper(ascii));
+}
+
+TEST(Utf8Test, CaseFolding) {
+    // Final sigma, sigma and capital sigma, KELVIN SIGN and k, LONG S and s
+    EXPECT_EQ(string_utils::utf8_fold_case("\xCF\x82"), "\xCF\x83");
+    EXPECT_EQ(string_utils::utf8_fold_case("\xCE\xA3"), "\xCF\x83");
+    EXPECT_EQ(string_utils::utf8_fold_case("\xE2\x84\xAA"), "k");
+    EXPECT_EQ(string_utils::utf8_fold_case("\xC5\xBF"), "s");
+    EXPECT_EQ(string_utils::utf8_fold_case("HeLLo \xC3\x84"), string_utils::utf8_fold_case("hello \xC3\xA4"));
+}
+
+// Long inputs take the vector blocks, which patch sequences in place. Converting
+// every piece on its own, all shorter than a block, gives the expected result.
+TEST(Utf8Test, CaseConversionInBlocks) {
+    // Same length, longer (U+023A, U+0250) and shorter (KELVIN SIGN) mappings, the
+    // Latin-1 signs and letters the registers convert or leave to the sequences
+    // (MICRO SIGN, y with diaeresis), four byte characters and bytes that are not
+    // UTF-8
+    const std::vector<std::string> pieces = {"a", "Z", " ", "\xC3\x89", "\xC3\xA9", "\xE2\x82\xAC", "\xC8\xBA",
+                                             "\xC9\x90", "\xE2\x84\xAA", "\xF0\x90\x90\x80", "\xCE\xA3", "\xFF",
+                                             "\xC2\xB5", "\xC3\xBF", "\xC3\x97", "\xC3\xB7", "\xC3\x9F",
+                                             "\xE2\x80\x9C", "\xC3"};
+    std::mt19937 rng(14);
+    std::uniform_int_distribution<size_t> pick(0, pieces.size() - 1);
+    std::uniform_int_distribution<int> ascii_run(0, 40);
+    for (int round = 0; round < 300; ++round) {
+        std::string str, lower, upper, folded;
+        while (str.size() < 200 + static_cast<size_t>(round)) {
+            // Mostly ASCII, like the text the blocks are meant for
+            for (int k = ascii_run(rng); k > 0; --k) {
+                const std::string letter(1, static_cast<char>((k % 2 ? 'a' : 'A') + k % 26));
+                str += letter;
+                lower += string_utils::utf8_to_lower(letter);
+                upper += string_utils::utf8_to_upper(letter);
+                folded += string_utils::utf8_fold_case(letter);
+            }
+            const std::string& piece = pieces[pick(rng)];
+            str += piece;
+            lower += string_utils::utf8_to_lower(piece);
+            upper += string_utils::utf8_to_upper(piece);
+            folded += string_utils::utf8_fold_case(piece);
+        }
+        EXPECT_EQ(string_utils::utf8_to_lower(str), lower) << round;
+        EXPECT_EQ(string_utils::utf8_to_upper(str), upper) << round;
+        EXPECT_EQ(string_utils::utf8_fold_case(str), folded) << round;
+    }
+
+    // Every two byte character, and U+2000-U+20FF, at each offset of a block
+    for (char32_t cp = 0x80; cp < 0x2100; cp = cp == 0x7FF ? 0x2000 : cp + 1) {
+        std::string piece;
+        if (cp < 0x800) {
+            piece = {static_cast<char>(0xC0 | (cp >> 6)), static_cast<char>(0x80 | (cp & 0x3F))};
+        } else {
+            piece = {'\xE2', static_cast<char>(0x80 | ((cp >> 6) & 0x3F)), static_cast<char>(0x80 | (cp & 0x3F))};
+        }
+        const std::string lower = string_utils::utf8_to_lower(piece);
+        const std::string upper = string_utils::utf8_to_upper(piece);
+        const std::string folded = string_utils::utf8_fold_case(piece);
+        for (size_t pos = 0; pos < 34; ++pos) {
+            const std::string str = std::string(pos, 'A') + piece + std::string(70 - pos, 'b');
+            EXPECT_EQ(string_utils::utf8_to_lower(str), std::string(pos, 'a') + lower + std::string(70 - pos, 'b'))
+                << std::hex << cp << " " << pos;
+            EXPECT_EQ(string_utils::utf8_to_upper(str), std::string(pos, 'A') + upper + std::string(70 - pos, 'B'))
+                << std::hex << cp << " " << pos;
+            EXPECT_EQ(string_utils::utf8_fold_case(str), std::string(pos, 'a') + folded + std::string(70 - pos, 'b'))
+                << std::hex << cp << " " << pos;
+        }
+    }
+}
+
+TEST(Utf8Test, Classification) {
+    EXPECT_TRUE(string_utils::utf8_is_alpha("h\xC3\xA9llo"));
+    EXPECT_TRUE(string_utils::utf8_is_alpha("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E"));
+    EXPECT_TRUE(string_utils::utf8_is_alpha("abc"));
+    EXPECT_FALSE(string_utils::utf8_is_alpha("abc1"));
+    EXPECT_FALSE(string_utils::utf8_is_alpha("\xE2\x82\xAC"));
+    EXPECT_FALSE(string_utils::utf8_is_alpha(""));
+    EXPECT_FALSE(string_utils::utf8_is_alpha("ab\xFF"));
+
+    // Arabic-Indic digits count as digits
+    EXPECT_TRUE(string_utils::utf8_is_alphanumeric("abc\xD9\xA1\xD9\xA2\xD9\xA3"));
+    EXPECT_FALSE(string_utils::utf8_is_alpha("abc\xD9\xA1"));
+    EXPECT_FALSE(string_utils::utf8_is_alphanumeric("a b"));
+}
@@ -0,0 +1,77 @@
+#include "thread_pool.h"
+#include <exception>
+
+namespace string_utils {
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1; // hardware_concurrency() may not know
+
+    m_workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        m_workers.emplace_back([this] { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_ready.notify_all();
+    for (auto& worker : m_workers) worker.join();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    // Completion state lives on this stack frame, run() does not return before
+    // every task has signalled it
+    std::mutex done_mutex;
+    std::condition_variable done;
+    size_t remaining = count;
+    std::exception_ptr error;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < count; ++i) {
+            m_tasks.emplace_back([&, i] {
+                std::exception_ptr thrown;
+                try {
+                    task(i);
+                } catch (...) {
+                    thrown = std::current_exception();
+                }
+                std::lock_guard<std::mutex> done_lock(done_mutex);
+                if (thrown && !error) error = thrown;
+                if (--remaining == 0) done.notify_one();
+            });
+        }
+    }
+    m_ready.notify_all();
+
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done.wait(lock, [&] { return remaining == 0; });
+    if (error) std::rethrow_exception(error);
+}
+
+void ThreadPool::work() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) return; // stopping and drained
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+ThreadPool& default_thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace string_utils
@@ -0,0 +1,44 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace string_utils {
+
+// Fixed set of worker threads that run batches of indexed tasks. The workers are
+// started once and reused, so splitting work over them costs a wake-up rather
+// than a thread creation per call.
+class ThreadPool {
+public:
+    // Zero threads means one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool&) = delete; // not copyable
+    ThreadPool& operator=(const ThreadPool&) = delete; // not copyable
+
+    size_t size() const { return m_workers.size(); }
+
+    // Runs task(0) ... task(count - 1) on the workers and returns once all of them
+    // are done. The first exception thrown by a task is rethrown here.
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void work();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    bool m_stopping = false;
+};
+
+// Pool with one thread per hardware thread, shared by the parallel algorithms
+// when no pool is passed in
+ThreadPool& default_thread_pool();
+
+} // namespace string_utils
@@ -0,0 +1,726 @@
+#include "utf8.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include "simd_ascii.h"
+#include "unicode_tables.h"
+
+namespace string_utils {
+
+namespace detail {
+
+namespace {
+
+// Sequence length and valid second byte range for every lead byte, following
+// table 3-7 of the Unicode standard. A length of 0 marks a byte that cannot start
+// a sequence. The narrowed second byte ranges exclude overlong forms (E0, F0),
+// surrogates (ED) and code points above U+10FFFF (F4).
+struct Lead {
+    uint8_t length;
+    uint8_t low;
+    uint8_t high;
+};
+
+constexpr std::array<Lead, 256> make_lead_table() {
+    std::array<Lead, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        Lead lead{0, 0, 0};
+        if (c < 0x80) lead = {1, 0, 0};
+        else if (c < 0xC2) lead = {0, 0, 0};
+        else if (c < 0xE0) lead = {2, 0x80, 0xBF};
+        else if (c == 0xE0) lead = {3, 0xA0, 0xBF};
+        else if (c == 0xED) lead = {3, 0x80, 0x9F};
+        else if (c < 0xF0) lead = {3, 0x80, 0xBF};
+        else if (c == 0xF0) lead = {4, 0x90, 0xBF};
+        else if (c < 0xF4) lead = {4, 0x80, 0xBF};
+        else if (c == 0xF4) lead = {4, 0x80, 0x8F};
+        table[c] = lead;
+    }
+    return table;
+}
+
+constexpr std::array<Lead, 256> lead_table = make_lead_table();
+
+constexpr uint64_t high_bits = 0x8080808080808080ull;
+
+} // namespace
+
+size_t decode_utf8(std::string_view str, char32_t& cp) {
+    if (str.empty()) return 0;
+
+    const uint8_t c0 = static_cast<uint8_t>(str[0]);
+    const Lead lead = lead_table[c0];
+    if (lead.length == 0) return 0;
+    if (lead.length == 1) {
+        cp = c0;
+        return 1;
+    }
+    if (str.size() < lead.length) return 0;
+
+    const uint8_t c1 = static_cast<uint8_t>(str[1]);
+    if (c1 < lead.low || c1 > lead.high) return 0;
+    char32_t value = ((c0 & (0x7F >> lead.length)) << 6) | (c1 & 0x3F);
+    for (size_t k = 2; k < lead.length; ++k) {
+        uint8_t c = static_cast<uint8_t>(str[k]);
+        if ((c & 0xC0) != 0x80) return 0;
+        value = (value << 6) | (c & 0x3F);
+    }
+    cp = value;
+    return lead.length;
+}
+
+size_t ascii_prefix_scalar(std::string_view str) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        if (word & high_bits) break;
+    }
+    while (i < n && static_cast<uint8_t>(data[i]) < 0x80) ++i;
+    return i;
+}
+
+bool is_valid_utf8_scalar(std::string_view str) {
+    size_t i = 0;
+    while (i < str.size()) {
+        i += ascii_prefix_scalar(str.substr(i));
+        // Decode multi-byte sequences until the next ASCII byte
+        while (i < str.size() && static_cast<uint8_t>(str[i]) >= 0x80) {
+            char32_t cp;
+            size_t length = decode_utf8(str.substr(i), cp);
+            if (length == 0) return false;
+            i += length;
+        }
+    }
+    return true;
+}
+
+#if STRING_UTILS_HAS_SSE2
+size_t ascii_prefix_sse2(std::string_view str) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+        if (mask) return i + count_trailing_zeros(mask);
+    }
+    return i + ascii_prefix_scalar(str.substr(i));
+}
+
+bool is_valid_utf8_sse2(std::string_view str) {
+    size_t i = 0;
+    while (i < str.size()) {
+        i += ascii_prefix_sse2(str.substr(i));
+        while (i < str.size() && static_cast<uint8_t>(str[i]) >= 0x80) {
+            char32_t cp;
+            size_t length = decode_utf8(str.substr(i), cp);
+            if (length == 0) return false;
+            i += length;
+        }
+    }
+    return true;
+}
+#endif
+
+#if STRING_UTILS_HAS_AVX2
+namespace {
+
+// The lookup table validation of Keiser and Lemire, "Validating UTF-8 In Less Than
+// One Instruction Per Byte". Three 16 entry tables, indexed by the high and low
+// nibble of the previous byte and the high nibble of the current one, each give the
+// set of errors the pair could be part of. Their intersection is the actual error.
+constexpr uint8_t too_short = 1 << 0;  // lead byte followed by a lead or ASCII byte
+constexpr uint8_t too_long = 1 << 1;   // ASCII followed by a continuation
+constexpr uint8_t overlong_3 = 1 << 2; // E0 followed by 80-9F
+constexpr uint8_t too_large = 1 << 3;  // F4 followed by 90-BF, or F5 and up
+constexpr uint8_t surrogate = 1 << 4;  // ED followed by A0-BF
+constexpr uint8_t overlong_2 = 1 << 5; // C0 or C1
+constexpr uint8_t too_large_1000 = 1 << 6;
+constexpr uint8_t overlong_4 = 1 << 6; // F0 followed by 80-8F
+constexpr uint8_t two_conts = 1 << 7;  // continuation after continuation, unless expected
+constexpr uint8_t carry = too_short | too_long | two_conts;
+
+STRING_UTILS_TARGET_AVX2
+inline __m256i table16(uint8_t t0, uint8_t t1, uint8_t t2, uint8_t t3, uint8_t t4, uint8_t t5, uint8_t t6,
+                       uint8_t t7, uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11, uint8_t t12, uint8_t t13,
+                       uint8_t t14, uint8_t t15) {
+    __m128i table = _mm_setr_epi8(
+        static_cast<char>(t0), static_cast<char>(t1), static_cast<char>(t2), static_cast<char>(t3),
+        static_cast<char>(t4), static_cast<char>(t5), static_cast<char>(t6), static_cast<char>(t7),
+        static_cast<char>(t8), static_cast<char>(t9), static_cast<char>(t10), static_cast<char>(t11),
+        static_cast<char>(t12), static_cast<char>(t13), static_cast<char>(t14), static_cast<char>(t15));
+    return _mm256_broadcastsi128_si256(table);
+}
+
+STRING_UTILS_TARGET_AVX2
+inline __m256i high_nibbles(__m256i v) {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+// The block shifted right by n bytes, with the last n bytes of previous shifted in
+template <int N>
+STRING_UTILS_TARGET_AVX2 inline __m256i shifted_in(__m256i input, __m256i previous) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+STRING_UTILS_TARGET_AVX2
+inline __m256i check_block(__m256i input, __m256i previous) {
+    const __m256i byte_1_high_table = table16(
+        too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+        two_conts, two_conts, two_conts, two_conts,
+        too_short | overlong_2,
+        too_short,
+        too_short | overlong_3 | surrogate,
+        too_short | too_large | too_large_1000 | overlong_4);
+    const __m256i byte_1_low_table = table16(
+        carry | overlong_3 | overlong_2 | overlong_4,
+        carry | overlong_2,
+        carry, carry,
+        carry | too_large,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000 | surrogate,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000);
+    const __m256i byte_2_high_table = table16(
+        too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_short, too_short, too_short, too_short);
+
+    __m256i prev1 = shifted_in<1>(input, previous);
+    __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, high_nibbles(prev1));
+    __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+    __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, high_nibbles(input));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    // Two continuations in a row are only right as the third or fourth byte of a
+    // sequence, that is two bytes after an E0-EF or three after an F0-FF lead
+    __m256i third = _mm256_subs_epu8(shifted_in<2>(input, previous), _mm256_set1_epi8(0xE0 - 0x80));
+    __m256i fourth = _mm256_subs_epu8(shifted_in<3>(input, previous), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m256i expected = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(expected, special);
+}
+
+// Non-zero where a sequence that starts in the last three bytes runs past the block
+STRING_UTILS_TARGET_AVX2
+inline __m256i incomplete_tail(__m256i input) {
+    const __m256i max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+    return _mm256_subs_epu8(input, max);
+}
+
+STRING_UTILS_TARGET_AVX2
+inline void check_next(__m256i v, __m256i& previous, __m256i& incomplete, __m256i& error) {
+    if (_mm256_movemask_epi8(v) == 0) {
+        // An ASCII block is only wrong if the block before left a sequence open
+        error = _mm256_or_si256(error, incomplete);
+        incomplete = _mm256_setzero_si256();
+    } else {
+        error = _mm256_or_si256(error, check_block(v, previous));
+        incomplete = incomplete_tail(v);
+    }
+    previous = v;
+}
+
+} // namespace
+
+STRING_UTILS_TARGET_AVX2
+size_t ascii_prefix_avx2(std::string_view str) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+        if (mask) return i + count_trailing_zeros(mask);
+    }
+    return i + ascii_prefix_sse2(str.substr(i));
+}
+
+STRING_UTILS_TARGET_AVX2
+bool is_valid_utf8_avx2(std::string_view str) {
+    const char* data = str.data();
+    const size_t n = str.size();
+
+    __m256i error = _mm256_setzero_si256();
+    __m256i previous = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        check_next(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), previous, incomplete, error);
+    }
+    if (i < n) {
+        // Zero padding reads as ASCII, so a sequence cut off by the end is caught
+        alignas(32) char tail[32] = {};
+        std::memcpy(tail, data + i, n - i);
+        check_next(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)), previous, incomplete, error);
+    }
+    error = _mm256_or_si256(error, incomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+#endif
+
+size_t ascii_prefix(std::string_view str) {
+#if STRING_UTILS_HAS_AVX2
+    if (cpu_has_avx2()) return ascii_prefix_avx2(str);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return ascii_prefix_sse2(str);
+#else
+    return ascii_prefix_scalar(str);
+#endif
+}
+
+} // namespace detail
+
+namespace {
+
+// ASCII runs are classified in blocks small enough to still be in L1 when the
+// class kernel reads them after the scan for the run's end
+constexpr size_t ascii_block = 4096;
+
+// Code points below this, everything written with one or two bytes, are looked up
+// directly, higher ones with a binary search over the ranges
+constexpr char32_t direct_limit = 0x800;
+
+// Higher code points are first checked against a bit per page of 256 code points,
+// which skips the search for pages without any mapping, like the symbols and CJK
+constexpr size_t page_bits = 8;
+constexpr size_t page_count = 0x110000 >> page_bits;
+
+// A case mapping over the generated ranges. upper says which ASCII and Latin-1
+// letters the vector blocks convert, those 0x20 below the other case or above it.
+class CaseMap {
+public:
+    template <size_t N>
+    CaseMap(const detail::CaseRange (&ranges)[N], bool upper) : m_ranges(ranges), m_count(N), m_upper(upper) {
+        for (char32_t cp = 0; cp < direct_limit; ++cp) m_direct[cp] = search(cp);
+        for (size_t r = 0; r < N; ++r) {
+            for (size_t page = ranges[r].first >> page_bits; page <= (ranges[r].last >> page_bits); ++page) {
+                m_pages.set(page);
+            }
+        }
+
+        // The rest of U+0080-U+00FF maps to itself in the blocks, except the code
+        // points found here, like MICRO SIGN, which the sequence path converts
+        const char32_t first = upper ? 0xE0 : 0xC0;
+        for (char32_t cp = 0x80; cp < 0x100; ++cp) {
+            const bool letter = cp - first < 31 && cp != first + 0x17;
+            if (m_direct[cp] == (letter ? cp ^ 0x20 : cp)) continue;
+            if (m_latin1_exceptions == m_latin1_exception.size()) {
+                m_latin1_blocks = false; // too many to compare in registers
+                break;
+            }
+            m_latin1_exception[m_latin1_exceptions++] = cp;
+        }
+    }
+
+    char32_t operator()(char32_t cp) const {
+        if (cp < direct_limit) return m_direct[cp];
+        return m_pages[cp >> page_bits] ? search(cp) : cp;
+    }
+
+    bool upper() const { return m_upper; }
+    bool latin1_blocks() const { return m_latin1_blocks; }
+    // 0 for unused entries
+    char32_t latin1_exception(size_t k) const { return m_latin1_exception[k]; }
+
+private:
+    char32_t search(char32_t cp) const {
+        const detail::CaseRange* end = m_ranges + m_count;
+        const detail::CaseRange* it = std::lower_bound(m_ranges, end, cp, [](const detail::CaseRange& range, char32_t value) {
+            return range.last < value;
+        });
+        if (it == end || cp < it->first || (cp - it->first) % it->stride != 0) return cp;
+        return static_cast<char32_t>(static_cast<int32_t>(cp) + it->delta);
+    }
+
+    const detail::CaseRange* m_ranges;
+    size_t m_count;
+    char32_t m_direct[direct_limit];
+    std::bitset<page_count> m_pages;
+    bool m_upper;
+    bool m_latin1_blocks = true;
+    std::array<char32_t, 2> m_latin1_exception{};
+    size_t m_latin1_exceptions = 0;
+};
+
+const CaseMap& lower_map() {
+    static const CaseMap map(detail::lower_ranges, false);
+    return map;
+}
+
+const CaseMap& upper_map() {
+    static const CaseMap map(detail::upper_ranges, true);
+    return map;
+}
+
+const CaseMap& fold_map() {
+    static const CaseMap map(detail::fold_ranges, false);
+    return map;
+}
+
+template <size_t N>
+bool in_ranges(const detail::CodeRange (&ranges)[N], char32_t cp) {
+    auto it = std::lower_bound(std::begin(ranges), std::end(ranges), cp,
+                               [](const detail::CodeRange& range, char32_t value) { return range.last < value; });
+    return it != std::end(ranges) && cp >= it->first;
+}
+
+// Letters, optionally with the decimal digits
+class LetterSet {
+public:
+    explicit LetterSet(bool digits) : m_digits(digits) {
+        for (char32_t cp = 0; cp < direct_limit; ++cp) m_direct[cp] = search(cp);
+    }
+
+    bool operator()(char32_t cp) const { return cp < direct_limit ? m_direct[cp] : search(cp); }
+
+private:
+    bool search(char32_t cp) const {
+        return in_ranges(detail::alpha_ranges, cp) || (m_digits && in_ranges(detail::digit_ranges, cp));
+    }
+
+    bool m_digits;
+    bool m_direct[direct_limit];
+};
+
+size_t encode_utf8(char32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// The output starts at the input size plus room for one sequence, and only grows
+// when mappings make it longer than that
+void reserve_output(std::string& out, size_t needed) {
+    if (out.size() < needed) out.resize(needed + out.size() / 8 + 16);
+}
+
+#if STRING_UTILS_HAS_SSE2
+// The multi-byte sequences starting in a block of width bytes at str[i], whose
+// bytes have already been stored at out[o] with ASCII letters converted. mask has a
+// bit for each byte >= 0x80. Nearly every mapping keeps the sequence length, so the
+// sequence is rewritten in place. A mapping that changes it ends the block there.
+// Advances i and o past the converted bytes, which can go past the block when its
+// last sequence does.
+void convert_sequences(std::string_view str, size_t& i, std::string& out, size_t& o, uint32_t mask, size_t width,
+                       const CaseMap& map) {
+    size_t done = width;
+    while (mask != 0) {
+        const size_t k = static_cast<size_t>(detail::count_trailing_zeros(mask));
+        char32_t cp;
+        size_t length = detail::decode_utf8(str.substr(i + k), cp);
+        if (length == 0) {
+            length = 1; // not UTF-8, already copied as is
+        } else {
+            const char32_t target = map(cp);
+            if (target != cp) {
+                char mapped[4];
+                const size_t encoded = encode_utf8(target, mapped);
+                if (encoded != length) {
+                    reserve_output(out, o + k + encoded + (str.size() - i - k - length) + 4);
+                    std::memcpy(&out[o + k], mapped, encoded);
+                    i += k + length;
+                    o += k + encoded;
+                    return;
+                }
+                std::memcpy(&out[o + k], mapped, encoded);
+            } else if (k + length > width) {
+                // The bytes past the end of the block have not been stored yet
+                std::memcpy(&out[o + k], &str[i + k], length);
+            }
+        }
+        done = std::max(width, k + length);
+        mask = k + length >= width ? 0 : mask & (~uint32_t(0) << (k + length));
+    }
+    i += done;
+    o += done;
+}
+
+// The bytes the vector blocks compare with, taken from the map
+struct BlockBytes {
+    explicit BlockBytes(const CaseMap& map)
+        : ascii_first(map.upper() ? 'a' : 'A'),
+          latin1_first(static_cast<char>(map.upper() ? 0xA0 : 0x80)),
+          latin1_sign(static_cast<char>(map.upper() ? 0xB7 : 0x97)),
+          latin1(map.latin1_blocks()) {
+        for (size_t k = 0; k < 2; ++k) {
+            // Unused entries are never compared with a lead byte
+            const char32_t cp = map.latin1_exception(k);
+            exception_lead[k] = cp == 0 ? 0 : static_cast<char>(0xC0 | (cp >> 6));
+            exception_next[k] = cp == 0 ? 0 : static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    char ascii_first;    // first ASCII letter converted, 'A' or 'a'
+    char latin1_first;   // byte after C3 of the first Latin-1 letter converted
+    char latin1_sign;    // MULTIPLICATION or DIVISION SIGN, in the middle of those
+    bool latin1;         // whether Latin-1 sequences are converted in registers at all
+    char exception_lead[2];
+    char exception_next[2];
+};
+
+// Bytes first to first + count - 1, wrapping around 0xFF, as in the ASCII kernels
+inline __m128i in_range_sse2(__m128i v, char first, char count) {
+    __m128i biased = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+    return _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(0x80 + count)), biased);
+}
+
+// Letters of the case being converted from, as in the ASCII kernels. Bytes >= 0x80
+// are never in range, so they are copied unchanged.
+inline __m128i convert_ascii_sse2(__m128i v, const BlockBytes& bytes) {
+    return _mm_xor_si128(v, _mm_and_si128(in_range_sse2(v, bytes.ascii_first, 26), _mm_set1_epi8(0x20)));
+}
+
+// Converts the Latin-1 letters of a block in registers, the byte after C3 moving by
+// 0x20 like an ASCII letter, and returns whether every other sequence in the block
+// maps to itself: the rest of C2 and C3 except the map's exceptions, and E2 80-83,
+// the punctuation and currency signs of U+2000-U+20FF. A lead byte in the last
+// position is left to the sequence path, so every byte changed here is in the block.
+inline bool convert_latin1_sse2(__m128i v, __m128i& converted, const BlockBytes& bytes) {
+    const __m128i previous = _mm_slli_si128(v, 1);
+    const __m128i next = _mm_srli_si128(v, 1);
+    const __m128i letters = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(bytes.latin1_sign)),
+                                             _mm_and_si128(_mm_cmpeq_epi8(previous, _mm_set1_epi8('\xC3')),
+                                                           in_range_sse2(v, bytes.latin1_first, 31)));
+    converted = _mm_xor_si128(converted, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+
+    __m128i exceptions = _mm_setzero_si128();
+    for (size_t k = 0; k < 2; ++k) {
+        exceptions = _mm_or_si128(exceptions, _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(bytes.exception_lead[k])),
+                                                            _mm_cmpeq_epi8(next, _mm_set1_epi8(bytes.exception_next[k]))));
+    }
+    const __m128i two_byte = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\xC2')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\xC3')));
+    const __m128i symbols = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\xE2')), in_range_sse2(next, '\x80', 4));
+    const __m128i kept = _mm_or_si128(_mm_andnot_si128(exceptions, two_byte), symbols);
+    const __m128i leads = in_range_sse2(v, '\xC0', 64);
+    const uint32_t lead_mask = static_cast<uint32_t>(_mm_movemask_epi8(leads));
+    return (static_cast<uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(kept, leads))) | (lead_mask & 0x8000)) == 0;
+}
+
+void convert_blocks_sse2(std::string_view str, size_t& i, std::string& out, size_t& o, BlockBytes bytes,
+                         const CaseMap& map) {
+    // Positions and bytes in locals, which the stores through char pointers cannot
+    // change, so they stay in registers. dst is reloaded when the sequence path
+    // grows the output.
+    size_t in = i;
+    size_t put = o;
+    char* dst = &out[0];
+    while (in + 16 <= str.size()) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + in));
+        const __m128i ascii = convert_ascii_sse2(v, bytes);
+        __m128i converted = ascii;
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+        if (mask == 0 || (bytes.latin1 && convert_latin1_sse2(v, converted, bytes))) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + put), converted);
+            in += 16;
+            put += 16;
+        } else {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + put), ascii);
+            convert_sequences(str, in, out, put, mask, 16, map);
+            dst = &out[0];
+        }
+    }
+    i = in;
+    o = put;
+}
+#endif
+
+#if STRING_UTILS_HAS_AVX2
+STRING_UTILS_TARGET_AVX2
+inline __m256i in_range_avx2(__m256i v, char first, char count) {
+    __m256i biased = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + count)), biased);
+}
+
+STRING_UTILS_TARGET_AVX2
+inline __m256i convert_ascii_avx2(__m256i v, const BlockBytes& bytes) {
+    return _mm256_xor_si256(v, _mm256_and_si256(in_range_avx2(v, bytes.ascii_first, 26), _mm256_set1_epi8(0x20)));
+}
+
+// As convert_latin1_sse2(), with the byte shifts crossing the 128-bit lanes
+STRING_UTILS_TARGET_AVX2
+inline bool convert_latin1_avx2(__m256i v, __m256i& converted, const BlockBytes& bytes) {
+    const __m256i previous = detail::shifted_in<1>(v, _mm256_setzero_si256());
+    const __m256i next = _mm256_alignr_epi8(_mm256_permute2x128_si256(v, v, 0x81), v, 1);
+    const __m256i letters = _mm256_andnot_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(bytes.latin1_sign)),
+        _mm256_and_si256(_mm256_cmpeq_epi8(previous, _mm256_set1_epi8('\xC3')), in_range_avx2(v, bytes.latin1_first, 31)));
+    converted = _mm256_xor_si256(converted, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+
+    __m256i exceptions = _mm256_setzero_si256();
+    for (size_t k = 0; k < 2; ++k) {
+        exceptions = _mm256_or_si256(exceptions,
+                                     _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(bytes.exception_lead[k])),
+                                                      _mm256_cmpeq_epi8(next, _mm256_set1_epi8(bytes.exception_next[k]))));
+    }
+    const __m256i two_byte =
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\xC2')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\xC3')));
+    const __m256i symbols = _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\xE2')), in_range_avx2(next, '\x80', 4));
+    const __m256i kept = _mm256_or_si256(_mm256_andnot_si256(exceptions, two_byte), symbols);
+    const __m256i leads = in_range_avx2(v, '\xC0', 64);
+    const uint32_t lead_mask = static_cast<uint32_t>(_mm256_movemask_epi8(leads));
+    return (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(kept, leads))) | (lead_mask & 0x80000000u)) == 0;
+}
+
+STRING_UTILS_TARGET_AVX2
+void convert_blocks_avx2(std::string_view str, size_t& i, std::string& out, size_t& o, BlockBytes bytes,
+                         const CaseMap& map) {
+    // Positions and bytes in locals, which the stores through char pointers cannot
+    // change, so they stay in registers. dst is reloaded when the sequence path
+    // grows the output.
+    size_t in = i;
+    size_t put = o;
+    char* dst = &out[0];
+    while (in + 32 <= str.size()) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str.data() + in));
+        const __m256i ascii = convert_ascii_avx2(v, bytes);
+        __m256i converted = ascii;
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+        if (mask == 0 || (bytes.latin1 && convert_latin1_avx2(v, converted, bytes))) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + put), converted);
+            in += 32;
+            put += 32;
+        } else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + put), ascii);
+            convert_sequences(str, in, out, put, mask, 32, map);
+            dst = &out[0];
+        }
+    }
+    i = in;
+    o = put;
+}
+#endif
+
+// Multi-byte sequences stay on the vector path. Each block is converted as ASCII,
+// which leaves bytes >= 0x80 alone, then the Latin-1 letters and the sequences that
+// map to themselves, covering most Western European text, are handled in registers
+// too. Only the other blocks decode and patch their sequences, instead of leaving
+// the vector loop for every one.
+std::string convert(std::string_view str, const CaseMap& map) {
+    const size_t n = str.size();
+    const bool upper = map.upper();
+    // Blocks are stored whole, which the input size plus 4 always has room for
+    std::string out(n + 4, '\0');
+    size_t i = 0;
+    size_t o = 0;
+#if STRING_UTILS_HAS_SSE2
+    const BlockBytes bytes(map);
+#endif
+#if STRING_UTILS_HAS_AVX2
+    if (detail::cpu_has_avx2()) convert_blocks_avx2(str, i, out, o, bytes, map);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    convert_blocks_sse2(str, i, out, o, bytes, map);
+#endif
+
+    // The rest, shorter than a block, or everything without SIMD
+    while (i < n) {
+        if (static_cast<uint8_t>(str[i]) < 0x80) {
+            char c = str[i++];
+            if (static_cast<uint8_t>(c - (upper ? 'a' : 'A')) < 26) c = static_cast<char>(c ^ 0x20);
+            out[o++] = c;
+            continue;
+        }
+        reserve_output(out, o + (n - i) + 4);
+        char32_t cp;
+        size_t length = detail::decode_utf8(str.substr(i), cp);
+        if (length == 0) {
+            out[o++] = str[i++]; // not UTF-8, kept as is
+            continue;
+        }
+        o += encode_utf8(map(cp), &out[o]);
+        i += length;
+    }
+    out.resize(o);
+    return out;
+}
+
+bool all_letters(std::string_view str, const LetterSet& letters, detail::CharClass ascii_class) {
+    if (str.empty()) return false;
+
+    size_t i = 0;
+    while (i < str.size()) {
+        size_t run = detail::ascii_prefix(str.substr(i, ascii_block));
+        if (!detail::all_of_class(str.substr(i, run), ascii_class)) return false;
+        i += run;
+        while (i < str.size() && static_cast<uint8_t>(str[i]) >= 0x80) {
+            char32_t cp;
+            size_t length = detail::decode_utf8(str.substr(i), cp);
+            if (length == 0 || !letters(cp)) return false;
+            i += length;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool is_valid_utf8(std::string_view str) {
+#if STRING_UTILS_HAS_AVX2
+    if (detail::cpu_has_avx2()) return detail::is_valid_utf8_avx2(str);
+#endif
+#if STRING_UTILS_HAS_SSE2
+    return detail::is_valid_utf8_sse2(str);
+#else
+    return detail::is_valid_utf8_scalar(str);
+#endif
+}
+
+std::string utf8_to_lower(std::string_view str) {
+    return convert(str, lower_map());
+}
+
+std::string utf8_to_upper(std::string_view str) {
+    return convert(str, upper_map());
+}
+
+std::string utf8_fold_case(std::string_view str) {
+    return convert(str, fold_map());
+}
+
+bool utf8_is_alpha(std::string_view str) {
+    static const LetterSet letters(false);
+    return all_letters(str, letters, detail::CharClass::Alpha);
+}
+
+bool utf8_is_alphanumeric(std::string_view str) {
+    static const LetterSet letters(true);
+    return all_letters(str, letters, detail::CharClass::Alnum);
+}
+
+} // namespace string_utils
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "simd.h"
+
+// UTF-8 aware counterparts of the byte-wise case and classification functions.
+// Case conversion works on vector blocks that also convert Latin-1 letters and
+// keep the common punctuation in registers, classification hands runs of ASCII to
+// the ASCII kernels. Only the other multi-byte sequences are decoded and looked up
+// in the Unicode tables, so mostly-ASCII text costs little more than with
+// to_lower() and friends.
+namespace string_utils {
+
+// True if str is well-formed UTF-8: no overlong forms, surrogates, truncated
+// sequences or code points above U+10FFFF
+bool is_valid_utf8(std::string_view str);
+
+// One to one Unicode case mappings. Code points whose mapping expands to several
+// characters (U+00DF to "SS") are kept, and bytes that are not valid UTF-8 are
+// copied unchanged.
+std::string utf8_to_lower(std::string_view str);
+std::string utf8_to_upper(std::string_view str);
+
+// Simple case folding, strings that only differ in case fold to the same string
+std::string utf8_fold_case(std::string_view str);
+
+// Like is_alpha() and is_alphanumeric() but every letter (general category L) and
+// decimal digit (Nd) counts. False for empty or invalid input.
+bool utf8_is_alpha(std::string_view str);
+bool utf8_is_alphanumeric(std::string_view str);
+
+namespace detail {
+
+// Length of the leading run of ASCII bytes
+size_t ascii_prefix(std::string_view str);
+
+// Decodes the sequence at the start of str into cp and returns its length,
+// or 0 if it is not a valid sequence
+size_t decode_utf8(std::string_view str, char32_t& cp);
+
+size_t ascii_prefix_scalar(std::string_view str);
+bool is_valid_utf8_scalar(std::string_view str);
+#if STRING_UTILS_HAS_SSE2
+size_t ascii_prefix_sse2(std::string_view str);
+bool is_valid_utf8_sse2(std::string_view str);
+#endif
+#if STRING_UTILS_HAS_AVX2
+size_t ascii_prefix_avx2(std::string_view str);
+bool is_valid_utf8_avx2(std::string_view str);
+#endif
+
+} // namespace detail
+
+} // namespace string_utils